@@ -3,6 +3,7 @@
 //
 
 #include "CSRES.h"
+#include "Error.h"
 
 #include <cstring>
 #include <iostream>
@@ -34,6 +35,22 @@ namespace opt {
         }
     }
 
+    SRES *SRES_newSRESBatch(BatchCostFunction cost, int populationSize, int numGenerations,
+                            double *startingValues, const double *lb, double *ub, int numEstimatedParameters,
+                            int childrate) {
+        try {
+            std::vector<double> startVals(startingValues, startingValues + numEstimatedParameters);
+            std::vector<double> lb_(lb, lb + numEstimatedParameters);
+            std::vector<double> ub_(ub, ub + numEstimatedParameters);
+
+            SRES *sres = new SRES(cost, populationSize, numGenerations, startVals, lb_, ub_, childrate);
+            return sres;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return reinterpret_cast<SRES *>(1);
+        }
+    }
+
     int SRES_deleteSRES(SRES *sres) {
         delete sres;
         sres = nullptr;
@@ -61,6 +78,182 @@ namespace opt {
     int SRES_setSeed(SRES *sres, unsigned long long seed) {
         try {
             sres->setSeed(seed);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setNumThreads(SRES *sres, int numThreads) {
+        try {
+            sres->setNumThreads(numThreads);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setPrefetchRandomNumbers(SRES *sres, int prefetchRandomNumbers) {
+        try {
+            sres->setPrefetchRandomNumbers(prefetchRandomNumbers != 0);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setFitnessCache(SRES *sres, int capacity, double quantum) {
+        try {
+            if (capacity < 0) {
+                INVALID_ARGUMENT_ERROR << "The capacity of the fitness cache cannot be negative" << std::endl;
+            }
+            sres->setFitnessCache(capacity, quantum);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_getFitnessCacheStats(SRES *sres, unsigned long long *hits, unsigned long long *misses) {
+        try {
+            CHECK_NULLPTR(hits, "hits");
+            CHECK_NULLPTR(misses, "misses");
+            const FitnessCache *cache = sres->getFitnessCache();
+            *hits = cache ? cache->getHits() : 0;
+            *misses = cache ? cache->getMisses() : 0;
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setEvaluationStore(SRES *sres, const char *path) {
+        try {
+            sres->setEvaluationStore(path ? path : "");
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_getEvaluationStoreStats(SRES *sres, unsigned long long *hits, unsigned long long *misses,
+                                     unsigned long long *numRecords) {
+        try {
+            CHECK_NULLPTR(hits, "hits");
+            CHECK_NULLPTR(misses, "misses");
+            CHECK_NULLPTR(numRecords, "numRecords");
+            const EvaluationStore *store = sres->getEvaluationStore();
+            *hits = store ? store->getHits() : 0;
+            *misses = store ? store->getMisses() : 0;
+            *numRecords = store ? store->size() : 0;
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_saveCheckpoint(SRES *sres, const char *path) {
+        try {
+            CHECK_NULLPTR(path, "path");
+            sres->saveCheckpoint(path);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_loadCheckpoint(SRES *sres, const char *path) {
+        try {
+            CHECK_NULLPTR(path, "path");
+            sres->loadCheckpoint(path);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_resume(SRES *sres) {
+        try {
+            sres->resume();
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setCheckpointSchedule(SRES *sres, const char *path, int everyGenerations, double everySeconds) {
+        try {
+            sres->setCheckpointSchedule(path ? path : "", everyGenerations, everySeconds);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_cancel(SRES *sres) {
+        try {
+            sres->cancel();
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_resetCancellation(SRES *sres) {
+        try {
+            sres->resetCancellation();
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    bool SRES_isCancelled(SRES *sres) {
+        return sres->isCancelled();
+    }
+
+    int SRES_setCancelOnSignal(SRES *sres, int cancelOnSignal) {
+        try {
+            sres->setCancelOnSignal(cancelOnSignal != 0);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    int SRES_setGenerationCallback(SRES *sres, GenerationCallback callback, int everyGenerations, double minSeconds) {
+        try {
+            sres->setGenerationCallback(callback, everyGenerations, minSeconds);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
+
+    unsigned long long SRES_getNumEvaluations(SRES *sres) {
+        return sres->getNumEvaluations();
+    }
+
+    int SRES_getProfile(SRES *sres, Profile *profile) {
+        try {
+            CHECK_NULLPTR(profile, "profile");
+            *profile = sres->getProfile();
+            return 0;
         } catch (std::exception &e) {
             LAST_ERROR = e.what();
             return -1;
@@ -141,35 +334,168 @@ namespace opt {
         }
     }
 
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+    double *SRES_ask(SRES *sres, int *numCandidates) {
+        try {
+            CandidateBatch candidates = sres->ask();
+            *numCandidates = candidates.numCandidates;
+            return candidates.parameters;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            *numCandidates = 0;
+            return nullptr;
+        }
+    }
 
+    int SRES_tell(SRES *sres, double *fitness, int numCandidates) {
+        try {
+            return sres->tell(std::vector<double>(fitness, fitness + numCandidates)) ? 1 : 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_setNumConstraints(SRES *sres, int numConstraints) {
+        try {
+            sres->setNumConstraints(numConstraints);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_setConstraintFunction(SRES *sres, ConstraintFunction constraints, int numConstraints) {
+        try {
+            sres->setConstraintFunction(constraints, numConstraints);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_getNumSkippedEvaluations(SRES *sres) {
+        return (int) sres->getNumSkippedEvaluations();
+    }
 
+    int SRES_tellWithConstraints(SRES *sres, double *fitness, double *constraintValues, int numCandidates) {
+        try {
+            size_t numValues = (size_t) numCandidates * sres->getNumConstraints();
+            return sres->tell(std::vector<double>(fitness, fitness + numCandidates),
+                              std::vector<double>(constraintValues, constraintValues + numValues)) ? 1 : 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    Portfolio *SRES_newPortfolio(CostFunction cost, int numRuns, int populationSize, int numGenerations,
+                                 double *startingValues, const double *lb, double *ub,
+                                 int numEstimatedParameters, int childrate) {
+        try {
+            std::vector<double> startVals(startingValues, startingValues + numEstimatedParameters);
+            std::vector<double> lb_(lb, lb + numEstimatedParameters);
+            std::vector<double> ub_(ub, ub + numEstimatedParameters);
 
+            return new Portfolio(cost, numRuns, populationSize, numGenerations, startVals, lb_, ub_, childrate);
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return reinterpret_cast<Portfolio *>(1);
+        }
+    }
 
+    int SRES_setPortfolioSeed(Portfolio *portfolio, unsigned long long seed) {
+        try {
+            portfolio->setSeed(seed);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_setPortfolioNumThreads(Portfolio *portfolio, int numThreads) {
+        try {
+            portfolio->setNumThreads(numThreads);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_setPortfolioCancellation(Portfolio *portfolio, int rungInterval, double reductionFactor, int minRuns,
+                                      double significance) {
+        try {
+            portfolio->setRungInterval(rungInterval);
+            portfolio->setReductionFactor(reductionFactor);
+            portfolio->setMinRuns(minRuns);
+            portfolio->setSignificance(significance);
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_fitPortfolio(Portfolio *portfolio) {
+        try {
+            portfolio->fit();
+            return 0;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    int SRES_getPortfolioResults(Portfolio *portfolio, unsigned long long *seeds, double *bestFitness,
+                                 double *solutions, int *numGenerations, int *cancelled) {
+        try {
+            const std::vector<PortfolioResult> &results = portfolio->getResults();
+            for (size_t i = 0; i < results.size(); i++) {
+                const PortfolioResult &result = results[i];
+                if (seeds)
+                    seeds[i] = result.seed;
+                if (bestFitness)
+                    bestFitness[i] = result.bestFitness;
+                if (solutions)
+                    std::copy(result.solutionValues.begin(), result.solutionValues.end(),
+                              solutions + i * result.solutionValues.size());
+                if (numGenerations)
+                    numGenerations[i] = result.numGenerations;
+                if (cancelled)
+                    cancelled[i] = result.cancelled ? 1 : 0;
+            }
+            return (int) results.size();
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            return -1;
+        }
+    }
 
+    double *SRES_getPortfolioHallOfFame(Portfolio *portfolio, int run, int *size) {
+        try {
+            const std::vector<PortfolioResult> &results = portfolio->getResults();
+            if (run < 0 || run >= (int) results.size()) {
+                INVALID_ARGUMENT_ERROR << "Run " << run << " has no results. There are "
+                                       << results.size() << " results" << std::endl;
+            }
+            const auto &v = results[run].hallOfFame;
+            auto hof = (double *) malloc(sizeof(double) * v.size());
+            std::copy(v.begin(), v.end(), hof);
+            *size = (int) v.size();
+            return hof;
+        } catch (std::exception &e) {
+            LAST_ERROR = e.what();
+            *size = 0;
+            return nullptr;
+        }
+    }
 
+    int SRES_deletePortfolio(Portfolio *portfolio) {
+        delete portfolio;
+        return 0;
+    }
 
+}
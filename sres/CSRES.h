@@ -6,6 +6,7 @@
 #define SRES_CSRES_H
 
 #include "SRES.h"
+#include "Portfolio.h"
 
 namespace opt {
 
@@ -21,8 +22,126 @@ namespace opt {
                        double *startingValues, const double *lb, double *ub,
                        int numEstimatedParameters, int childrate = 7);
 
+    /**
+     * Same as SRES_newSRES but the cost function is called once per
+     * generation with a contiguous numIndividuals x numEstimatedParameters
+     * row major matrix, and writes one fitness value per row.
+     */
+    SRES *SRES_newSRESBatch(BatchCostFunction cost, int populationSize, int numGenerations,
+                            double *startingValues, const double *lb, double *ub,
+                            int numEstimatedParameters, int childrate = 7);
+
     int SRES_setSeed(SRES *sres, unsigned long long seed);
 
+    /**
+     * Evaluate the children of each generation on numThreads
+     * threads. The cost function must be thread safe when
+     * numThreads is greater than 1.
+     */
+    int SRES_setNumThreads(SRES *sres, int numThreads);
+
+    /**
+     * Draw the random numbers of the next generation on a background
+     * thread while the current one is evaluated. Does not change the
+     * results. Takes effect from the next run.
+     */
+    int SRES_setPrefetchRandomNumbers(SRES *sres, int prefetchRandomNumbers);
+
+    /**
+     * Reuse the fitness of up to capacity previously evaluated parameter
+     * vectors. When quantum is greater than 0 parameters are rounded to
+     * the nearest multiple of quantum before being compared. A capacity
+     * of 0 removes the cache. Returns 0 on success, -1 on error.
+     */
+    int SRES_setFitnessCache(SRES *sres, int capacity, double quantum);
+
+    /**
+     * Number of cost function calls the fitness cache saved (hits) and
+     * did not save (misses). Both are 0 when there is no cache.
+     */
+    int SRES_getFitnessCacheStats(SRES *sres, unsigned long long *hits, unsigned long long *misses);
+
+    /**
+     * Keep every evaluation in the on disk evaluation store at path and
+     * reuse the fitness of parameter vectors already in it, for example
+     * from earlier runs of the same problem. The store is created if it
+     * does not exist. An empty path or nullptr closes the store, writing
+     * any queued records. Returns 0 on success, -1 on error.
+     */
+    int SRES_setEvaluationStore(SRES *sres, const char *path);
+
+    /**
+     * Lookups the evaluation store answered (hits) and did not (misses)
+     * and the number of records in it. All 0 when there is no store.
+     */
+    int SRES_getEvaluationStoreStats(SRES *sres, unsigned long long *hits, unsigned long long *misses,
+                                     unsigned long long *numRecords);
+
+    /**
+     * Write the state of the run to path, between generations.
+     * Returns 0 on success, -1 on error.
+     */
+    int SRES_saveCheckpoint(SRES *sres, const char *path);
+
+    /**
+     * Restore a run saved by SRES_saveCheckpoint into an optimizer
+     * set up for the same problem. Continue it with SRES_resume.
+     * Returns 0 on success, -1 on error.
+     */
+    int SRES_loadCheckpoint(SRES *sres, const char *path);
+
+    /**
+     * Run the current run to completion without restarting it
+     */
+    int SRES_resume(SRES *sres);
+
+    /**
+     * Save a checkpoint to path every everyGenerations generations and
+     * every everySeconds seconds, 0 to disable either, and when the run
+     * finishes. An empty path or nullptr turns checkpointing off.
+     * Returns 0 on success, -1 on error.
+     */
+    int SRES_setCheckpointSchedule(SRES *sres, const char *path, int everyGenerations, double everySeconds);
+
+    /**
+     * Ask a running SRES_fit or SRES_resume to stop after the evaluations
+     * already running. Safe to call from another thread. The run keeps
+     * the state of its last complete generation and saves a checkpoint
+     * if they are scheduled.
+     */
+    int SRES_cancel(SRES *sres);
+
+    /**
+     * Clear a cancellation so that the optimizer can run again
+     */
+    int SRES_resetCancellation(SRES *sres);
+
+    bool SRES_isCancelled(SRES *sres);
+
+    /**
+     * With cancelOnSignal non zero, SIGINT and SIGTERM cancel this
+     * optimizer. A second signal terminates the process as usual.
+     * With 0 the previous signal handlers are put back.
+     */
+    int SRES_setCancelOnSignal(SRES *sres, int cancelOnSignal);
+
+    /**
+     * Call callback after every everyGenerations generations, at most
+     * once every minSeconds seconds, and after the last one. The run
+     * stops when it returns non zero. nullptr removes the callback.
+     * Returns 0 on success, -1 on error.
+     */
+    int SRES_setGenerationCallback(SRES *sres, GenerationCallback callback, int everyGenerations, double minSeconds);
+
+    unsigned long long SRES_getNumEvaluations(SRES *sres);
+
+    /**
+     * Fill profile with the time spent in each phase of the run and the
+     * latency of the cost function. profile->enabled is 0 when the library
+     * was built without SRES_ENABLE_PROFILING.
+     */
+    int SRES_getProfile(SRES *sres, Profile *profile);
+
 
     double *SRES_getSolution(SRES *sres);
 
@@ -42,6 +161,91 @@ namespace opt {
 
     int SRES_getNumberOfEstimatedParameters(SRES *sres);
 
+    /**
+     * Ask for the next batch of candidates to evaluate. Returns a pointer to
+     * a row major numCandidates x numEstimatedParameters matrix which is owned
+     * by sres and stays valid until the next call to SRES_tell. It must not be
+     * freed. numCandidates is set to the number of rows. Returns nullptr and
+     * sets numCandidates to 0 when the optimization has finished.
+     */
+    double *SRES_ask(SRES *sres, int *numCandidates);
+
+    /**
+     * Report the fitness of the numCandidates candidates returned by the
+     * last call to SRES_ask. Returns 1 if there is another generation to
+     * ask for, 0 when the optimization has finished and -1 on error.
+     */
+    int SRES_tell(SRES *sres, double *fitness, int numCandidates);
+
+    /**
+     * Set the number of inequality constraint values passed to
+     * SRES_tellWithConstraints for every candidate. A constraint is
+     * satisfied when its value is <= 0. Returns 0 on success, -1 on error.
+     */
+    int SRES_setNumConstraints(SRES *sres, int numConstraints);
+
+    /**
+     * Set a cheap constraint function which SRES_fit evaluates before the
+     * cost function. With a pf of 0 the cost function is then skipped for
+     * children which violate a constraint, since stochastic ranking never
+     * needs their fitness. Pass nullptr to remove the constraints.
+     * Returns 0 on success, -1 on error.
+     */
+    int SRES_setConstraintFunction(SRES *sres, ConstraintFunction constraints, int numConstraints);
+
+    /**
+     * Number of calls to the cost function saved by the constraint function
+     */
+    int SRES_getNumSkippedEvaluations(SRES *sres);
+
+    /**
+     * SRES_tell for a problem with constraints. constraintValues is a row
+     * major numCandidates x numConstraints matrix holding the constraint
+     * values of the candidates returned by the last call to SRES_ask.
+     */
+    int SRES_tellWithConstraints(SRES *sres, double *fitness, double *constraintValues, int numCandidates);
+
+    /**
+     * Create a portfolio of numRuns independently seeded SRES fits
+     * of the same problem, run concurrently by SRES_fitPortfolio.
+     * Like SRES_newSRES returns (Portfolio *) 1 on error.
+     */
+    Portfolio *SRES_newPortfolio(CostFunction cost, int numRuns, int populationSize, int numGenerations,
+                                 double *startingValues, const double *lb, double *ub,
+                                 int numEstimatedParameters, int childrate = 7);
+
+    int SRES_setPortfolioSeed(Portfolio *portfolio, unsigned long long seed);
+
+    int SRES_setPortfolioNumThreads(Portfolio *portfolio, int numThreads);
+
+    /**
+     * Every rungInterval generations cancel the runs still going that are
+     * dominated by the best one at the given significance, keeping at least
+     * 1 / reductionFactor of them and never fewer than minRuns. A
+     * rungInterval of 0 runs every fit to completion.
+     */
+    int SRES_setPortfolioCancellation(Portfolio *portfolio, int rungInterval, double reductionFactor, int minRuns,
+                                      double significance = 0.05);
+
+    int SRES_fitPortfolio(Portfolio *portfolio);
+
+    /**
+     * Copy the results of every run into caller allocated arrays. seeds,
+     * bestFitness, numGenerations and cancelled hold one value per run and
+     * solutions a row major numRuns x numEstimatedParameters matrix. Any of
+     * them may be nullptr. Returns the number of runs, or -1 on error.
+     */
+    int SRES_getPortfolioResults(Portfolio *portfolio, unsigned long long *seeds, double *bestFitness,
+                                 double *solutions, int *numGenerations, int *cancelled);
+
+    /**
+     * The hall of fame of run. The returned pointer is malloc'd and must be
+     * freed with SRES_freeHallOfFame by the caller. size is set to its length.
+     */
+    double *SRES_getPortfolioHallOfFame(Portfolio *portfolio, int run, int *size);
+
+    int SRES_deletePortfolio(Portfolio *portfolio);
+
     int freeStuff(void *stuff);
 
     int SRES_freeSolution(double *solution);
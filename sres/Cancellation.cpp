@@ -0,0 +1,100 @@
+#include <csignal>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "Cancellation.h"
+
+namespace opt {
+
+    namespace {
+        typedef void (*SignalHandler)(int);
+
+        static_assert(std::atomic<CancellationToken *>::is_always_lock_free,
+                      "the signal handler must be able to load the token");
+
+        /**
+         * @brief the token the signal handler cancels. Only ever loaded by
+         * the handler, the shared pointer below keeps it alive.
+         */
+        std::atomic<CancellationToken *> signalToken{nullptr};
+
+        std::shared_ptr<CancellationToken> signalTokenOwner;
+
+        /**
+         * @brief tokens which were replaced or removed. Never released, since
+         * there is no telling when a handler which loaded one is done with it.
+         */
+        std::vector<std::shared_ptr<CancellationToken>> retiredTokens;
+
+        std::mutex signalMutex;
+
+        bool installed = false;
+
+        SignalHandler previousInterruptHandler = SIG_DFL;
+
+        SignalHandler previousTerminateHandler = SIG_DFL;
+
+        void onSignal(int signal) {
+            CancellationToken *token = signalToken.load();
+            if (!token || token->isCancelled()) {
+                // asked twice, stop waiting for the optimizer
+                std::signal(signal, SIG_DFL);
+                std::raise(signal);
+                return;
+            }
+            token->cancel();
+        }
+
+        /**
+         * @brief restoreSignalHandlers() with signalMutex held
+         */
+        void restoreSignalHandlersLocked() {
+            if (installed) {
+                std::signal(SIGINT, previousInterruptHandler == SIG_ERR ? SIG_DFL : previousInterruptHandler);
+                std::signal(SIGTERM, previousTerminateHandler == SIG_ERR ? SIG_DFL : previousTerminateHandler);
+                installed = false;
+            }
+            signalToken.store(nullptr);
+            if (signalTokenOwner)
+                retiredTokens.push_back(std::move(signalTokenOwner));
+            signalTokenOwner.reset();
+        }
+    }
+
+    void CancellationToken::cancel() noexcept {
+        cancelled_.store(true);
+    }
+
+    bool CancellationToken::isCancelled() const noexcept {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    void CancellationToken::reset() noexcept {
+        cancelled_.store(false);
+    }
+
+    void cancelOnSignal(std::shared_ptr<CancellationToken> token) {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        signalToken.store(token.get());
+        if (signalTokenOwner && signalTokenOwner != token)
+            retiredTokens.push_back(signalTokenOwner);
+        signalTokenOwner = std::move(token);
+        if (!installed) {
+            previousInterruptHandler = std::signal(SIGINT, onSignal);
+            previousTerminateHandler = std::signal(SIGTERM, onSignal);
+            installed = true;
+        }
+    }
+
+    void restoreSignalHandlers() {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        restoreSignalHandlersLocked();
+    }
+
+    void restoreSignalHandlers(const CancellationToken *token) {
+        std::lock_guard<std::mutex> lock(signalMutex);
+        if (token && signalTokenOwner.get() == token)
+            restoreSignalHandlersLocked();
+    }
+
+}
@@ -0,0 +1,67 @@
+#ifndef SRES_CANCELLATION_H
+#define SRES_CANCELLATION_H
+
+#include <atomic>
+#include <memory>
+
+namespace opt {
+
+    /**
+     * @brief a flag asking an optimizer to stop, which may be set from
+     * any thread and from a signal handler.
+     * @details the optimizer checks it between generations and before
+     * each evaluation. A cancelled optimizer finishes the evaluations
+     * already running, drops the rest of the generation and stops
+     * with the state of the last complete generation.
+     */
+    class CancellationToken {
+
+    public:
+
+        /**
+         * @brief ask for cancellation. Lock free, so
+         * it is safe to call from a signal handler.
+         */
+        void cancel() noexcept;
+
+        [[nodiscard]] bool isCancelled() const noexcept;
+
+        /**
+         * @brief clear the flag so that the optimizer can run again
+         */
+        void reset() noexcept;
+
+    private:
+        static_assert(std::atomic<bool>::is_always_lock_free,
+                      "cancel() must be async signal safe");
+
+        std::atomic<bool> cancelled_{false};
+    };
+
+    /**
+     * @brief cancel @param token on SIGINT and SIGTERM, so that a run
+     * stopped by the user or preempted by a scheduler ends cleanly.
+     * @details a second signal after the token was cancelled gets the
+     * default behaviour, which is to terminate the process straight away.
+     * Only one token receives signals at a time, installing another
+     * replaces it. A handler running on another thread may still be using
+     * a token after it is replaced or removed, so every token installed is
+     * kept alive until the process exits.
+     */
+    void cancelOnSignal(std::shared_ptr<CancellationToken> token);
+
+    /**
+     * @brief put back the signal handlers which were
+     * there before cancelOnSignal()
+     */
+    void restoreSignalHandlers();
+
+    /**
+     * @brief restoreSignalHandlers() if @param token is the one receiving
+     * signals, otherwise leave the handlers of the other token in place
+     */
+    void restoreSignalHandlers(const CancellationToken *token);
+
+}
+
+#endif //SRES_CANCELLATION_H
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include "Checkpoint.h"
+#include "Error.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace opt {
+
+    namespace {
+        constexpr char Magic[8] = {'S', 'R', 'E', 'S', 'C', 'K', 'P', '1'};
+        constexpr std::uint32_t FormatVersion = 2;
+
+        /**
+         * @brief magic, version, payload size. Followed by the
+         * payload and a 64 bit FNV-1a checksum of the payload.
+         */
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t reserved;
+            std::uint64_t payloadSize;
+        };
+
+        std::uint64_t checksum(const char *data, size_t n) {
+            std::uint64_t hash = 0xCBF29CE484222325ULL;
+            for (size_t i = 0; i < n; i++) {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 0x100000001B3ULL;
+            }
+            return hash;
+        }
+    }
+
+    const std::string &BinaryWriter::str() const {
+        return data_;
+    }
+
+    std::string BinaryWriter::release() {
+        return std::move(data_);
+    }
+
+    BinaryReader::BinaryReader(const std::string &data)
+            : data_(data) {}
+
+    const char *BinaryReader::take(size_t numBytes) {
+        if (numBytes > data_.size() - position_) {
+            INVALID_ARGUMENT_ERROR << "Unexpected end of checkpoint data" << std::endl;
+        }
+        const char *p = data_.data() + position_;
+        position_ += numBytes;
+        return p;
+    }
+
+    size_t BinaryReader::readSize(size_t elementSize) {
+        auto size = read<std::uint64_t>();
+        if (size > (data_.size() - position_) / elementSize) {
+            INVALID_ARGUMENT_ERROR << "Unexpected end of checkpoint data" << std::endl;
+        }
+        return size;
+    }
+
+    void BinaryReader::checkSize(size_t size, size_t expected) {
+        if (size != expected) {
+            INVALID_ARGUMENT_ERROR << "Expected " << expected << " values in the checkpoint but found "
+                                   << size << std::endl;
+        }
+    }
+
+    bool BinaryReader::atEnd() const {
+        return position_ == data_.size();
+    }
+
+    void writeCheckpointFile(const std::string &path, const std::string &payload) {
+        FileHeader header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = FormatVersion;
+        header.payloadSize = payload.size();
+        std::uint64_t sum = checksum(payload.data(), payload.size());
+
+        std::string tmpPath = path + ".tmp";
+        FILE *file = std::fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            RUNTIME_ERROR << "Could not open \"" << tmpPath << "\" to write a checkpoint" << std::endl;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(payload.data(), 1, payload.size(), file) == payload.size() &&
+                  std::fwrite(&sum, sizeof(sum), 1, file) == 1 &&
+                  std::fflush(file) == 0;
+#ifndef _WIN32
+        ok = ok && ::fsync(::fileno(file)) == 0;
+#endif
+        ok = std::fclose(file) == 0 && ok;
+        if (!ok) {
+            std::remove(tmpPath.c_str());
+            RUNTIME_ERROR << "Could not write the checkpoint \"" << tmpPath << "\"" << std::endl;
+        }
+
+#ifdef _WIN32
+        // rename does not replace an existing file on Windows
+        std::remove(path.c_str());
+#endif
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            RUNTIME_ERROR << "Could not move the checkpoint \"" << tmpPath << "\" to \"" << path << "\"" << std::endl;
+        }
+    }
+
+    std::string readCheckpointFile(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            FILE_NOT_FOUND_ERROR << "Could not open the checkpoint \"" << path << "\"" << std::endl;
+        }
+        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        FileHeader header{};
+        if (contents.size() < sizeof(header) + sizeof(std::uint64_t)) {
+            INVALID_ARGUMENT_ERROR << "\"" << path << "\" is not a checkpoint" << std::endl;
+        }
+        std::memcpy(&header, contents.data(), sizeof(header));
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+            INVALID_ARGUMENT_ERROR << "\"" << path << "\" is not a checkpoint" << std::endl;
+        }
+        if (header.version != FormatVersion) {
+            INVALID_ARGUMENT_ERROR << "The checkpoint \"" << path << "\" has format version " << header.version
+                                   << " but only version " << FormatVersion << " can be read" << std::endl;
+        }
+        if (header.payloadSize != contents.size() - sizeof(header) - sizeof(std::uint64_t)) {
+            INVALID_ARGUMENT_ERROR << "The checkpoint \"" << path << "\" is truncated" << std::endl;
+        }
+
+        std::string payload = contents.substr(sizeof(header), header.payloadSize);
+        std::uint64_t sum;
+        std::memcpy(&sum, contents.data() + sizeof(header) + header.payloadSize, sizeof(sum));
+        if (sum != checksum(payload.data(), payload.size())) {
+            INVALID_ARGUMENT_ERROR << "The checkpoint \"" << path << "\" is corrupt" << std::endl;
+        }
+        return payload;
+    }
+
+    CheckpointWriter::CheckpointWriter()
+            : thread_(&CheckpointWriter::run, this) {}
+
+    CheckpointWriter::~CheckpointWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    void CheckpointWriter::rethrow() {
+        if (!error_.empty()) {
+            std::string error;
+            std::swap(error, error_);
+            RUNTIME_ERROR << error << std::endl;
+        }
+    }
+
+    void CheckpointWriter::submit(const std::string &path, std::string payload) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rethrow();
+        path_ = path;
+        payload_ = std::move(payload);
+        pending_ = true;
+        changed_.notify_all();
+    }
+
+    void CheckpointWriter::flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return !pending_ && !writing_; });
+        rethrow();
+    }
+
+    void CheckpointWriter::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            changed_.wait(lock, [this] { return stopping_ || pending_; });
+            if (!pending_)
+                return;
+
+            std::string path = std::move(path_);
+            std::string payload = std::move(payload_);
+            pending_ = false;
+            writing_ = true;
+            lock.unlock();
+
+            std::string error;
+            try {
+                writeCheckpointFile(path, payload);
+            } catch (std::exception &e) {
+                error = e.what();
+            }
+
+            lock.lock();
+            writing_ = false;
+            if (!error.empty())
+                error_ = error;
+            changed_.notify_all();
+        }
+    }
+
+}
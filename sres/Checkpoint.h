@@ -0,0 +1,180 @@
+#ifndef SRES_CHECKPOINT_H
+#define SRES_CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace opt {
+
+    /**
+     * @brief appends values to a binary buffer in the native byte order
+     */
+    class BinaryWriter {
+
+    public:
+
+        template<class T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+            data_.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+
+        /**
+         * @brief the size of @param values followed by the values
+         */
+        template<class T>
+        void writeVector(const std::vector<T> &values) {
+            writeArray(values.data(), values.size());
+        }
+
+        template<class T>
+        void writeArray(const T *values, size_t n) {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values can be written");
+            write<std::uint64_t>(n);
+            data_.append(reinterpret_cast<const char *>(values), n * sizeof(T));
+        }
+
+        [[nodiscard]] const std::string &str() const;
+
+        std::string release();
+
+    private:
+        std::string data_;
+    };
+
+    /**
+     * @brief reads back what a BinaryWriter wrote, throwing
+     * std::invalid_argument instead of reading past the end
+     */
+    class BinaryReader {
+
+    public:
+
+        explicit BinaryReader(const std::string &data);
+
+        template<class T>
+        T read() {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values can be read");
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        template<class T>
+        std::vector<T> readVector() {
+            std::vector<T> values(readSize(sizeof(T)));
+            if (!values.empty())
+                std::memcpy(values.data(), take(values.size() * sizeof(T)), values.size() * sizeof(T));
+            return values;
+        }
+
+        /**
+         * @brief read an array written by writeArray into @param values,
+         * which must hold exactly @param n values
+         */
+        template<class T>
+        void readArray(T *values, size_t n) {
+            size_t size = readSize(sizeof(T));
+            checkSize(size, n);
+            if (n)
+                std::memcpy(values, take(n * sizeof(T)), n * sizeof(T));
+        }
+
+        [[nodiscard]] bool atEnd() const;
+
+    private:
+
+        const char *take(size_t numBytes);
+
+        size_t readSize(size_t elementSize);
+
+        static void checkSize(size_t size, size_t expected);
+
+        const std::string &data_;
+
+        size_t position_ = 0;
+    };
+
+    /**
+     * @brief write @param payload to @param path with a header and a
+     * checksum, through a temporary file which is synced to disk and
+     * renamed over path. A crash at any point leaves either the old
+     * checkpoint or the new one, never a partial file.
+     */
+    void writeCheckpointFile(const std::string &path, const std::string &payload);
+
+    /**
+     * @brief the payload of the checkpoint at @param path, after
+     * checking its header and checksum
+     */
+    std::string readCheckpointFile(const std::string &path);
+
+    /**
+     * @brief writes checkpoints on a background thread.
+     * @details submit() hands over a snapshot and returns straight away.
+     * If the previous snapshot has not been written yet it is replaced,
+     * since only the newest one matters.
+     */
+    class CheckpointWriter {
+
+    public:
+
+        CheckpointWriter();
+
+        /**
+         * @brief write whatever was submitted last and stop
+         */
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter &) = delete;
+
+        CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+        /**
+         * @brief write @param payload to @param path in the background.
+         * Rethrows the error of an earlier write which failed.
+         */
+        void submit(const std::string &path, std::string payload);
+
+        /**
+         * @brief wait until every submitted checkpoint is written
+         */
+        void flush();
+
+    private:
+
+        void run();
+
+        /**
+         * @brief throw the error of the last failed write, if any
+         */
+        void rethrow();
+
+        std::mutex mutex_;
+
+        std::condition_variable changed_;
+
+        std::string path_;
+
+        std::string payload_;
+
+        bool pending_ = false;
+
+        bool writing_ = false;
+
+        bool stopping_ = false;
+
+        std::string error_;
+
+        std::thread thread_;
+    };
+
+}
+
+#endif //SRES_CHECKPOINT_H
@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include "EvaluationStore.h"
+#include "FitnessCache.h"
+#include "Error.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace opt {
+
+    namespace {
+        constexpr char LogMagic[8] = {'S', 'R', 'E', 'S', 'L', 'O', 'G', '1'};
+        constexpr char IndexMagic[8] = {'S', 'R', 'E', 'S', 'I', 'D', 'X', '1'};
+
+        struct LogHeader {
+            char magic[8];
+            std::uint64_t numParameters;
+            std::uint64_t numRecords;
+            char reserved[40];
+        };
+
+        /**
+         * @brief followed by numSlots slots, each 0 when empty
+         * or else one more than the record number
+         */
+        struct IndexHeader {
+            char magic[8];
+            std::uint64_t numSlots;
+            std::uint64_t numEntries;
+            char reserved[40];
+        };
+
+        static_assert(sizeof(LogHeader) == 64 && sizeof(IndexHeader) == 64, "headers are 64 bytes");
+
+        constexpr size_t InitialRecords = 1024;
+        constexpr size_t InitialSlots = 4096;
+    }
+
+#ifndef _WIN32
+
+    void EvaluationStore::openFile(MappedFile &file, const std::string &path) {
+        file.fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (file.fd < 0) {
+            RUNTIME_ERROR << "Could not open \"" << path << "\": " << std::strerror(errno) << std::endl;
+        }
+        struct stat info{};
+        ::fstat(file.fd, &info);
+        file.size = 0;
+        if (info.st_size > 0)
+            resizeFile(file, info.st_size);
+    }
+
+    void EvaluationStore::resizeFile(MappedFile &file, size_t size) {
+        MappedFile grown = growFile(file, size);
+        unmapFile(file);
+        file = grown;
+    }
+
+    EvaluationStore::MappedFile EvaluationStore::growFile(const MappedFile &file, size_t size) {
+        if (::ftruncate(file.fd, (off_t) size) != 0) {
+            RUNTIME_ERROR << "Could not grow an evaluation store: " << std::strerror(errno) << std::endl;
+        }
+        void *data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+        if (data == MAP_FAILED) {
+            RUNTIME_ERROR << "Could not map an evaluation store: " << std::strerror(errno) << std::endl;
+        }
+        MappedFile grown = file;
+        grown.data = static_cast<char *>(data);
+        grown.size = size;
+        return grown;
+    }
+
+    void EvaluationStore::unmapFile(MappedFile &file) {
+        if (file.data)
+            ::munmap(file.data, file.size);
+        file.data = nullptr;
+        file.size = 0;
+    }
+
+    void EvaluationStore::syncFile(MappedFile &file) {
+        if (file.data)
+            ::msync(file.data, file.size, MS_SYNC);
+    }
+
+    void EvaluationStore::closeFile(MappedFile &file) {
+        unmapFile(file);
+        if (file.fd >= 0)
+            ::close(file.fd);
+        file = MappedFile();
+    }
+
+#else
+
+    void EvaluationStore::openFile(MappedFile &, const std::string &) {
+        NOT_IMPLEMENTED_ERROR << "Evaluation stores are not available on Windows" << std::endl;
+    }
+
+    void EvaluationStore::resizeFile(MappedFile &, size_t) {}
+
+    EvaluationStore::MappedFile EvaluationStore::growFile(const MappedFile &file, size_t) {
+        return file;
+    }
+
+    void EvaluationStore::unmapFile(MappedFile &file) {
+        file.data = nullptr;
+        file.size = 0;
+    }
+
+    void EvaluationStore::syncFile(MappedFile &) {}
+
+    void EvaluationStore::closeFile(MappedFile &file) {
+        file = MappedFile();
+    }
+
+#endif
+
+    EvaluationStore::EvaluationStore(std::string path, size_t numParameters)
+            : path_(std::move(path)), numParameters_(numParameters), recordSize_(numParameters + 3),
+              key_(numParameters) {
+        try {
+            openFile(log_, path_);
+            if (log_.size == 0) {
+                resizeFile(log_, sizeof(LogHeader) + InitialRecords * recordSize_ * sizeof(double));
+                auto *header = reinterpret_cast<LogHeader *>(log_.data);
+                std::memcpy(header->magic, LogMagic, sizeof(LogMagic));
+                header->numParameters = numParameters_;
+                header->numRecords = 0;
+            }
+
+            auto *header = reinterpret_cast<LogHeader *>(log_.data);
+            if (log_.size < sizeof(LogHeader) || std::memcmp(header->magic, LogMagic, sizeof(LogMagic)) != 0) {
+                INVALID_ARGUMENT_ERROR << "\"" << path_ << "\" is not an evaluation store" << std::endl;
+            }
+            if (header->numParameters != numParameters_) {
+                INVALID_ARGUMENT_ERROR << "The evaluation store \"" << path_ << "\" holds " << header->numParameters
+                                       << " parameters per record, not " << numParameters_ << std::endl;
+            }
+
+            // the index is written after the log, so after a crash it may
+            // be behind. It is only a cache of the log and can be rebuilt.
+            openFile(index_, path_ + ".index");
+            auto *indexHeader = reinterpret_cast<const IndexHeader *>(index_.data);
+            bool valid = index_.size >= sizeof(IndexHeader) &&
+                         std::memcmp(indexHeader->magic, IndexMagic, sizeof(IndexMagic)) == 0 &&
+                         indexHeader->numSlots > 0 && (indexHeader->numSlots & (indexHeader->numSlots - 1)) == 0 &&
+                         index_.size == sizeof(IndexHeader) + indexHeader->numSlots * sizeof(std::uint64_t) &&
+                         indexHeader->numEntries == header->numRecords;
+            if (!valid) {
+                size_t numSlots = InitialSlots;
+                while (numSlots < 4 * header->numRecords)
+                    numSlots *= 2;
+                rebuildIndex(numSlots);
+            }
+        } catch (...) {
+            closeFile(log_);
+            closeFile(index_);
+            throw;
+        }
+
+        writer_ = std::thread(&EvaluationStore::writerLoop, this);
+    }
+
+    EvaluationStore::~EvaluationStore() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopping_ = true;
+        }
+        queueChanged_.notify_all();
+        if (writer_.joinable())
+            writer_.join();
+        syncFile(log_);
+        syncFile(index_);
+        closeFile(log_);
+        closeFile(index_);
+    }
+
+    const double *EvaluationStore::record(size_t i) const {
+        return reinterpret_cast<const double *>(log_.data + sizeof(LogHeader)) + i * recordSize_;
+    }
+
+    size_t EvaluationStore::logCapacity() const {
+        return (log_.size - sizeof(LogHeader)) / (recordSize_ * sizeof(double));
+    }
+
+    size_t EvaluationStore::indexCapacity() const {
+        return reinterpret_cast<const IndexHeader *>(index_.data)->numSlots;
+    }
+
+    bool EvaluationStore::findSlot(const double *key, std::uint64_t hash, size_t &slot, size_t &recordNum) const {
+        const auto *slots = reinterpret_cast<const std::uint64_t *>(index_.data + sizeof(IndexHeader));
+        size_t mask = indexCapacity() - 1;
+        slot = hash & mask;
+        while (slots[slot] != 0) {
+            recordNum = slots[slot] - 1;
+            if (std::memcmp(record(recordNum), key, numParameters_ * sizeof(double)) == 0)
+                return true;
+            slot = (slot + 1) & mask;
+        }
+        return false;
+    }
+
+    void EvaluationStore::rebuildIndex(size_t numSlots) {
+        // build the new index next to the old one and swap it in
+        std::string path = path_ + ".index";
+        std::string tmpPath = path + ".tmp";
+        std::remove(tmpPath.c_str());
+        MappedFile index;
+        openFile(index, tmpPath);
+        resizeFile(index, sizeof(IndexHeader) + numSlots * sizeof(std::uint64_t));
+
+        auto *header = reinterpret_cast<IndexHeader *>(index.data);
+        std::memcpy(header->magic, IndexMagic, sizeof(IndexMagic));
+        header->numSlots = numSlots;
+        auto *slots = reinterpret_cast<std::uint64_t *>(index.data + sizeof(IndexHeader));
+
+        size_t numRecords = reinterpret_cast<const LogHeader *>(log_.data)->numRecords;
+        for (size_t i = 0; i < numRecords; i++) {
+            size_t slot = FitnessCache::hashKey(record(i), numParameters_) & (numSlots - 1);
+            while (slots[slot] != 0)
+                slot = (slot + 1) & (numSlots - 1);
+            slots[slot] = i + 1;
+        }
+        header->numEntries = numRecords;
+
+        syncFile(index);
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            closeFile(index);
+            RUNTIME_ERROR << "Could not replace the index of \"" << path_ << "\"" << std::endl;
+        }
+        {
+            std::lock_guard<std::mutex> lock(storeMutex_);
+            std::swap(index_, index);
+        }
+        closeFile(index);
+    }
+
+    void EvaluationStore::reserveRecords(size_t numRecords) {
+        size_t needed = reinterpret_cast<const LogHeader *>(log_.data)->numRecords + numRecords;
+        if (needed > logCapacity()) {
+            size_t capacity = logCapacity();
+            while (capacity < needed)
+                capacity *= 2;
+            MappedFile log = growFile(log_, sizeof(LogHeader) + capacity * recordSize_ * sizeof(double));
+            {
+                std::lock_guard<std::mutex> lock(storeMutex_);
+                std::swap(log_, log);
+            }
+            unmapFile(log);
+        }
+
+        // at most half full
+        if (2 * needed > indexCapacity()) {
+            size_t numSlots = indexCapacity();
+            while (numSlots < 2 * needed)
+                numSlots *= 2;
+            rebuildIndex(numSlots);
+        }
+    }
+
+    bool EvaluationStore::lookup(const double *parameters, double &fitness) {
+        for (size_t j = 0; j < numParameters_; j++)
+            key_[j] = parameters[j] + 0.0;
+        std::uint64_t hash = FitnessCache::hashKey(key_.data(), numParameters_);
+
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        size_t slot, recordNum;
+        if (!findSlot(key_.data(), hash, slot, recordNum)) {
+            misses_++;
+            return false;
+        }
+        hits_++;
+        fitness = record(recordNum)[numParameters_];
+        return true;
+    }
+
+    void EvaluationStore::append(const double *parameters, double fitness, double phi, double seconds) {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!writerError_.empty()) {
+            RUNTIME_ERROR << writerError_ << std::endl;
+        }
+        for (size_t j = 0; j < numParameters_; j++)
+            queue_.push_back(parameters[j] + 0.0);
+        queue_.push_back(fitness);
+        queue_.push_back(phi);
+        queue_.push_back(seconds);
+        numQueued_++;
+        queueChanged_.notify_all();
+    }
+
+    void EvaluationStore::flush() {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            queueChanged_.wait(lock, [this] { return numWritten_ == numQueued_; });
+            if (!writerError_.empty()) {
+                RUNTIME_ERROR << writerError_ << std::endl;
+            }
+        }
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        syncFile(log_);
+        syncFile(index_);
+    }
+
+    void EvaluationStore::writerLoop() {
+        std::vector<double> batch;
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        while (true) {
+            queueChanged_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty())
+                return;
+
+            // take the whole queue, leaving the emptied batch buffer in its place
+            batch.swap(queue_);
+            size_t numRecords = batch.size() / recordSize_;
+            lock.unlock();
+
+            std::string error;
+            try {
+                writeRecords(batch, numRecords);
+            } catch (std::exception &e) {
+                error = e.what();
+            }
+            batch.clear();
+
+            lock.lock();
+            numWritten_ += numRecords;
+            if (!error.empty() && writerError_.empty())
+                writerError_ = error;
+            queueChanged_.notify_all();
+        }
+    }
+
+    void EvaluationStore::writeRecords(const std::vector<double> &records, size_t numRecords) {
+        reserveRecords(numRecords);
+
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        for (size_t r = 0; r < numRecords; r++) {
+            const double *newRecord = records.data() + r * recordSize_;
+            std::uint64_t hash = FitnessCache::hashKey(newRecord, numParameters_);
+            size_t slot, recordNum;
+            // the same parameters may have been queued twice
+            if (findSlot(newRecord, hash, slot, recordNum))
+                continue;
+
+            // the record, then the index, then the count. A crash in
+            // between leaves the index behind, and it is rebuilt on open.
+            size_t count = reinterpret_cast<const LogHeader *>(log_.data)->numRecords;
+            auto *destination = reinterpret_cast<double *>(log_.data + sizeof(LogHeader)) + count * recordSize_;
+            std::copy(newRecord, newRecord + recordSize_, destination);
+            auto *slots = reinterpret_cast<std::uint64_t *>(index_.data + sizeof(IndexHeader));
+            slots[slot] = count + 1;
+            reinterpret_cast<IndexHeader *>(index_.data)->numEntries = count + 1;
+            reinterpret_cast<LogHeader *>(log_.data)->numRecords = count + 1;
+        }
+    }
+
+    size_t EvaluationStore::size() const {
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        return reinterpret_cast<const LogHeader *>(log_.data)->numRecords;
+    }
+
+    EvaluationRecord EvaluationStore::getRecord(size_t i) const {
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        size_t numRecords = reinterpret_cast<const LogHeader *>(log_.data)->numRecords;
+        if (i >= numRecords) {
+            INVALID_ARGUMENT_ERROR << "Record " << i << " requested from an evaluation store of "
+                                   << numRecords << " records" << std::endl;
+        }
+        const double *r = record(i);
+        return {std::vector<double>(r, r + numParameters_), r[numParameters_], r[numParameters_ + 1],
+                r[numParameters_ + 2]};
+    }
+
+    const std::string &EvaluationStore::getPath() const {
+        return path_;
+    }
+
+    size_t EvaluationStore::getNumParameters() const {
+        return numParameters_;
+    }
+
+    std::uint64_t EvaluationStore::getHits() const {
+        return hits_;
+    }
+
+    std::uint64_t EvaluationStore::getMisses() const {
+        return misses_;
+    }
+
+}
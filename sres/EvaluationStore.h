@@ -0,0 +1,214 @@
+#ifndef SRES_EVALUATIONSTORE_H
+#define SRES_EVALUATIONSTORE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opt {
+
+    /**
+     * @brief one evaluation read back from an EvaluationStore
+     */
+    struct EvaluationRecord {
+        std::vector<double> parameters;
+        double fitness;
+        double phi;
+
+        /**
+         * @brief wall time of the cost function call in seconds. For a
+         * BatchCostFunction the call's time divided between its rows.
+         */
+        double seconds;
+    };
+
+    /**
+     * @brief append only log of evaluations kept on disk, so that later
+     * runs of the same problem can reuse the fitness of parameter vectors
+     * evaluated before.
+     * @details The log, at path, is a 64 byte header followed by fixed size
+     * records of numParameters parameters, fitness, phi and seconds, all
+     * doubles. It is memory mapped and grows by doubling. A linear probing
+     * hash index of record numbers is kept next to it, at path + ".index",
+     * and is rebuilt from the log when it is missing or out of date, for
+     * example after a crash. Parameters are matched exactly.
+     *
+     * Appends are queued and written by a background thread so that the
+     * generation loop does not wait for the disk. Lookups only see records
+     * which have been written, and only wait for the writer while it copies
+     * records in or swaps a grown file in, never while it syncs. Lookups
+     * and appends may be made from one thread at a time. Not available on
+     * Windows.
+     */
+    class EvaluationStore {
+
+    public:
+
+        /**
+         * @brief open the store at @param path, creating it if it does
+         * not exist. An existing store must hold @param numParameters
+         * parameters per record.
+         */
+        EvaluationStore(std::string path, size_t numParameters);
+
+        /**
+         * @brief write the queued records and close the files
+         */
+        ~EvaluationStore();
+
+        EvaluationStore(const EvaluationStore &) = delete;
+
+        EvaluationStore &operator=(const EvaluationStore &) = delete;
+
+        /**
+         * @brief look @param parameters up, setting @param fitness on a hit
+         */
+        bool lookup(const double *parameters, double &fitness);
+
+        /**
+         * @brief queue an evaluation, which took @param seconds,
+         * to be written by the background thread
+         */
+        void append(const double *parameters, double fitness, double phi, double seconds);
+
+        /**
+         * @brief wait until every queued record is written and synced to disk
+         */
+        void flush();
+
+        /**
+         * @brief number of records written
+         */
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] EvaluationRecord getRecord(size_t i) const;
+
+        [[nodiscard]] const std::string &getPath() const;
+
+        [[nodiscard]] size_t getNumParameters() const;
+
+        [[nodiscard]] std::uint64_t getHits() const;
+
+        [[nodiscard]] std::uint64_t getMisses() const;
+
+    private:
+
+        /**
+         * @brief a memory mapped file
+         */
+        struct MappedFile {
+            int fd = -1;
+            char *data = nullptr;
+            size_t size = 0;
+        };
+
+        static void openFile(MappedFile &file, const std::string &path);
+
+        /**
+         * @brief grow @param file to @param size bytes and map it again
+         */
+        static void resizeFile(MappedFile &file, size_t size);
+
+        /**
+         * @brief a second mapping of @param file grown to @param size bytes.
+         * @details @param file stays mapped, so lookups can go on reading it
+         * until the new mapping is swapped in.
+         */
+        static MappedFile growFile(const MappedFile &file, size_t size);
+
+        static void unmapFile(MappedFile &file);
+
+        static void syncFile(MappedFile &file);
+
+        static void closeFile(MappedFile &file);
+
+        [[nodiscard]] const double *record(size_t i) const;
+
+        [[nodiscard]] size_t logCapacity() const;
+
+        [[nodiscard]] size_t indexCapacity() const;
+
+        /**
+         * @brief true if @param key is in the index, with @param slot and
+         * @param recordNum set to where. Otherwise @param slot is set to
+         * the empty slot where the key would go.
+         */
+        [[nodiscard]] bool findSlot(const double *key, std::uint64_t hash, size_t &slot, size_t &recordNum) const;
+
+        /**
+         * @brief create an index of @param numSlots slots from the log and
+         * swap it in. Only the writer may call it once the writer is running.
+         */
+        void rebuildIndex(size_t numSlots);
+
+        /**
+         * @brief make room for @param numRecords more records in the log and
+         * the index, doing the slow part without holding storeMutex_
+         */
+        void reserveRecords(size_t numRecords);
+
+        /**
+         * @brief write @param numRecords queued records of the log to disk
+         */
+        void writeRecords(const std::vector<double> &records, size_t numRecords);
+
+        void writerLoop();
+
+        std::string path_;
+
+        size_t numParameters_;
+
+        /**
+         * @brief doubles per record
+         */
+        size_t recordSize_;
+
+        MappedFile log_;
+
+        MappedFile index_;
+
+        /**
+         * @brief guards the mapped files, taken by lookups and the writer.
+         * Only the writer changes the files, so it reads them without it.
+         */
+        mutable std::mutex storeMutex_;
+
+        /**
+         * @brief guards the queue
+         */
+        std::mutex queueMutex_;
+
+        std::condition_variable queueChanged_;
+
+        /**
+         * @brief records waiting for the writer, back to back
+         */
+        std::vector<double> queue_;
+
+        size_t numQueued_ = 0;
+
+        size_t numWritten_ = 0;
+
+        bool stopping_ = false;
+
+        /**
+         * @brief what went wrong in the writer, rethrown by append and flush
+         */
+        std::string writerError_;
+
+        std::vector<double> key_;
+
+        std::uint64_t hits_ = 0;
+
+        std::uint64_t misses_ = 0;
+
+        std::thread writer_;
+    };
+
+}
+
+#endif //SRES_EVALUATIONSTORE_H
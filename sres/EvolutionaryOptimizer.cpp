@@ -2,6 +2,8 @@
 // Created by Ciaran on 06/02/2021.
 //
 
+#include <algorithm>
+#include <chrono>
 #include "EvolutionaryOptimizer.h"
 
 
@@ -19,6 +21,23 @@ namespace opt {
               stopAfterStalledGenerations_(stopAfterStalledGenerations) {}
 
 
+    EvolutionaryOptimizer::EvolutionaryOptimizer(
+            BatchCostFunction batchCost, int populationSize, int numGenerations,
+            const DoubleVector &startingValues, const DoubleVector &lb,
+            const DoubleVector &ub, int childRate, int stopAfterStalledGenerations)
+            : Optimizer(batchCost, startingValues, lb, ub),
+              populationSize_(populationSize),
+              numGenerations_(numGenerations),
+              childRate_(childRate),
+              stopAfterStalledGenerations_(stopAfterStalledGenerations) {}
+
+    EvolutionaryOptimizer::~EvolutionaryOptimizer() {
+        // null once moved from
+        if (cancellationToken_)
+            restoreSignalHandlers(cancellationToken_.get());
+    }
+
+
     int EvolutionaryOptimizer::getPopulationSize() const {
         return populationSize_;
     }
@@ -43,7 +62,7 @@ namespace opt {
         EvolutionaryOptimizer::numGenerations_ = numGenerations;
     }
 
-    bool EvolutionaryOptimizer::evaluate(std::vector<double> individual) {
+    bool EvolutionaryOptimizer::evaluate(const double *individual) {
         bool Continue = true;
 
         // todo refactor this so that it returns the fitness instead
@@ -51,16 +70,209 @@ namespace opt {
         /**
          * sadly, to make this interoperable with C and therefore
          * Python, I could not used std::function for the callback.
-         * Instead we use a raw double, which means we need
-         * to construct a raw double array from individual
+         * Instead we use a raw double pointer, which the individual
+         * is passed through without copying
          */
-        double *pd = individual.data();
-
-        fitnessValue_ = (*cost_)(pd);
+        fitnessValue_ = (*cost_)(const_cast<double *>(individual));
 
         return Continue;
     }
 
+    bool EvolutionaryOptimizer::evaluatePopulation(size_t first, size_t last, const std::uint8_t *selected,
+                                                   bool cancellable) {
+        if (last <= first)
+            return true;
+        SRES_PROFILE_PHASE(Evaluate);
+
+        if (!fitnessCache_ && !evaluationStore_) {
+            if (!evaluateRows(first, last, selected, cancellable))
+                return false;
+            fitnessValue_ = populationFitness_[last - 1];
+            return true;
+        }
+
+        // look the rows up first and only evaluate the misses. The cache
+        // and store are only touched from this thread, before and after
+        // evaluation.
+        cacheMisses_.resize(population_.rows());
+        for (size_t i = first; i < last; i++) {
+            cacheMisses_[i] = !selected || selected[i];
+            if (!cacheMisses_[i])
+                continue;
+            const double *row = population_[i].data();
+            double &fitness = populationFitness_[i];
+            if (fitnessCache_ && fitnessCache_->lookup(row, fitness)) {
+                cacheMisses_[i] = 0;
+            } else if (evaluationStore_ && evaluationStore_->lookup(row, fitness)) {
+                cacheMisses_[i] = 0;
+                if (fitnessCache_)
+                    fitnessCache_->insert(row, fitness);
+            }
+        }
+
+        // some of the misses were never evaluated, keep them out of the cache and store
+        if (!evaluateRows(first, last, cacheMisses_.data(), cancellable))
+            return false;
+
+        for (size_t i = first; i < last; i++) {
+            if (!cacheMisses_[i])
+                continue;
+            if (fitnessCache_)
+                fitnessCache_->insert(population_[i].data(), populationFitness_[i]);
+            if (evaluationStore_)
+                evaluationStore_->append(population_[i].data(), populationFitness_[i], violation(i),
+                                         evaluationSeconds_[i]);
+        }
+
+        fitnessValue_ = populationFitness_[last - 1];
+        return true;
+    }
+
+    bool EvolutionaryOptimizer::evaluateRows(size_t first, size_t last, const std::uint8_t *selected,
+                                             bool cancellable) {
+        // the clock is only read for the evaluation store
+        bool timed = evaluationStore_ != nullptr;
+        if (timed)
+            evaluationSeconds_.resize(population_.rows());
+
+        if (batchCost_) {
+            auto evaluateBlock = [this, timed](size_t blockFirst, size_t blockLast) {
+                size_t numIndividuals = blockLast - blockFirst;
+                // population_ is row major, so the block is passed in place
+                double *block = population_[blockFirst].data();
+
+                {
+                    SRES_PROFILE_COST_CALL(numIndividuals);
+                    auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                    (*batchCost_)(block, numIndividuals, numberOfParameters_,
+                                  populationFitness_.data() + blockFirst);
+                    if (timed) {
+                        double seconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start).count() / (double) numIndividuals;
+                        std::fill(evaluationSeconds_.begin() + blockFirst, evaluationSeconds_.begin() + blockLast,
+                                  seconds);
+                    }
+                }
+                numEvaluations_ += numIndividuals;
+            };
+
+            if (cancellable && isCancelled())
+                return false;
+
+            if (!selected) {
+                evaluateBlock(first, last);
+                return true;
+            }
+
+            // hand every run of selected rows over in one call
+            size_t i = first;
+            while (i < last) {
+                if (!selected[i]) {
+                    i++;
+                    continue;
+                }
+                size_t end = i;
+                while (end < last && selected[end])
+                    end++;
+                if (cancellable && isCancelled())
+                    return false;
+                evaluateBlock(i, end);
+                i = end;
+            }
+            return true;
+        }
+
+        // evaluations already running are finished, the rest are skipped
+        std::atomic<bool> skipped{false};
+        std::atomic<std::uint64_t> numEvaluations{0};
+        forEachIndividual(first, last, [this, selected, cancellable, timed, &skipped, &numEvaluations](size_t i) {
+            if (selected && !selected[i])
+                return;
+            if (cancellable && isCancelled()) {
+                skipped = true;
+                return;
+            }
+            {
+                SRES_PROFILE_COST_CALL(1);
+                auto start = timed ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                populationFitness_[i] = (*cost_)(population_[i].data());
+                if (timed)
+                    evaluationSeconds_[i] = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start).count();
+            }
+            numEvaluations.fetch_add(1, std::memory_order_relaxed);
+        });
+        numEvaluations_ += numEvaluations;
+        return !skipped;
+    }
+
+    void EvolutionaryOptimizer::setFitnessCache(size_t capacity, double quantum) {
+        if (capacity == 0)
+            fitnessCache_.reset();
+        else
+            fitnessCache_ = std::make_shared<FitnessCache>(capacity, numberOfParameters_, quantum);
+    }
+
+    const FitnessCache *EvolutionaryOptimizer::getFitnessCache() const {
+        return fitnessCache_.get();
+    }
+
+    void EvolutionaryOptimizer::setEvaluationStore(const std::string &path) {
+        // close the old store first, it may be the same file
+        evaluationStore_.reset();
+        if (!path.empty())
+            evaluationStore_ = std::make_shared<EvaluationStore>(path, numberOfParameters_);
+    }
+
+    EvaluationStore *EvolutionaryOptimizer::getEvaluationStore() const {
+        return evaluationStore_.get();
+    }
+
+    void EvolutionaryOptimizer::cancel() {
+        cancellationToken_->cancel();
+    }
+
+    bool EvolutionaryOptimizer::isCancelled() const {
+        return cancellationToken_->isCancelled();
+    }
+
+    void EvolutionaryOptimizer::resetCancellation() {
+        cancellationToken_->reset();
+    }
+
+    const std::shared_ptr<CancellationToken> &EvolutionaryOptimizer::getCancellationToken() const {
+        return cancellationToken_;
+    }
+
+    void EvolutionaryOptimizer::setCancelOnSignal(bool cancelOnSignal) {
+        if (cancelOnSignal)
+            opt::cancelOnSignal(cancellationToken_);
+        else
+            restoreSignalHandlers(cancellationToken_.get());
+    }
+
+    std::uint64_t EvolutionaryOptimizer::getNumEvaluations() const {
+        return numEvaluations_;
+    }
+
+    Profile EvolutionaryOptimizer::getProfile() const {
+#ifdef SRES_PROFILING
+        return profiler_->getProfile();
+#else
+        return Profile{};
+#endif
+    }
+
+    double EvolutionaryOptimizer::violation(size_t) const {
+        return 0.0;
+    }
+
+    ThreadPool &EvolutionaryOptimizer::getThreadPool() {
+        if (!threadPool_ || threadPool_->size() != (unsigned int) numThreads_)
+            threadPool_ = std::make_shared<ThreadPool>(numThreads_);
+        return *threadPool_;
+    }
+
     int EvolutionaryOptimizer::getCurrentGeneration() const {
         return currentGeneration_;
     }
@@ -77,12 +289,16 @@ namespace opt {
         stopAfterStalledGenerations_ = stopAfterStalledGenerations;
     }
 
-    const DoubleMatrix &EvolutionaryOptimizer::getPopulation() const {
-        return population_;
+    DoubleMatrix EvolutionaryOptimizer::getPopulation() const {
+        return population_.toDoubleMatrix();
     }
 
     void EvolutionaryOptimizer::setPopulation(const DoubleMatrix &individuals) {
-        population_ = individuals;
+        population_.fromDoubleMatrix(individuals);
+    }
+
+    const PopulationMatrix &EvolutionaryOptimizer::getPopulationMatrix() const {
+        return population_;
     }
 
     const DoubleVector &EvolutionaryOptimizer::getPopulationFitness() const {
@@ -93,5 +309,18 @@ namespace opt {
         EvolutionaryOptimizer::populationFitness_ = populationFitness;
     }
 
+    int EvolutionaryOptimizer::getNumThreads() const {
+        return numThreads_;
+    }
+
+    void EvolutionaryOptimizer::setNumThreads(int numThreads) {
+        numThreads_ = numThreads < 1 ? 1 : numThreads;
+    }
+
+    void EvolutionaryOptimizer::setThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+        numThreads_ = threadPool ? (int) threadPool->size() : 1;
+        threadPool_ = std::move(threadPool);
+    }
+
 
 }
\ No newline at end of file
@@ -5,10 +5,44 @@
 #ifndef SRES_EVOLUTIONARYOPTIMIZER_H
 #define SRES_EVOLUTIONARYOPTIMIZER_H
 
+#include <memory>
+#include "Cancellation.h"
 #include "Optimizer.h"
+#include "Profile.h"
+#include "ThreadPool.h"
+#include "FitnessCache.h"
+#include "EvaluationStore.h"
 
 namespace opt {
 
+    /**
+     * @brief non owning view of a block of candidate individuals
+     * waiting to be evaluated. The candidates are the rows of a
+     * contiguous, row major numCandidates x numParameters matrix.
+     */
+    struct CandidateBatch {
+        /**
+         * @brief start of the first candidate. nullptr when there is nothing to evaluate.
+         */
+        double *parameters;
+
+        size_t numCandidates;
+
+        size_t numParameters;
+
+        /**
+         * @brief index of the first candidate in the population
+         */
+        size_t firstIndex;
+
+        /**
+         * @brief parameters of candidate @param i
+         */
+        [[nodiscard]] double *operator[](size_t i) const {
+            return parameters + i * numParameters;
+        }
+    };
+
 
     class EvolutionaryOptimizer : public Optimizer {
 
@@ -20,9 +54,23 @@ namespace opt {
         EvolutionaryOptimizer() = default;
 
         /**
-         * @brief default destructor for EvolutionaryOptimizer
+         * @brief puts the signal handlers back if
+         * this optimizer is the one receiving signals
          */
-        ~EvolutionaryOptimizer() override = default;
+        ~EvolutionaryOptimizer() override;
+
+        /**
+         * @brief not copyable. A copy would share the cancellation token,
+         * fitness cache, evaluation store and the rest of the state held
+         * by shared_ptr with the original.
+         */
+        EvolutionaryOptimizer(const EvolutionaryOptimizer &) = delete;
+
+        EvolutionaryOptimizer &operator=(const EvolutionaryOptimizer &) = delete;
+
+        EvolutionaryOptimizer(EvolutionaryOptimizer &&) noexcept = default;
+
+        EvolutionaryOptimizer &operator=(EvolutionaryOptimizer &&) noexcept = default;
 
         /**
          * @brief Construct an EvolutionaryOptimizer from
@@ -47,6 +95,23 @@ namespace opt {
                 int stopAfterStalledGenerations = 25
         );
 
+        /**
+         * @brief Construct an EvolutionaryOptimizer that evaluates
+         * whole generations with a single call to @param batchCost.
+         * @see BatchCostFunction. The remaining arguments are the
+         * same as for the CostFunction overload.
+         */
+        EvolutionaryOptimizer(
+                BatchCostFunction batchCost,
+                int populationSize,
+                int numGenerations,
+                const DoubleVector &startingValues,
+                const DoubleVector &lb,
+                const DoubleVector &ub,
+                int childRate = 7,
+                int stopAfterStalledGenerations = 25
+        );
+
         /**
          * @brief entry method for optimizer. Subclasses implement their
          * evolutionary strategy here. Users call the fit method to optimize
@@ -106,14 +171,21 @@ namespace opt {
 
         /**
          * @brief getter for individuals matrix
+         * @details returns a copy as nested vectors. Use
+         * getPopulationMatrix to access the population without copying.
          */
-        [[nodiscard]] const DoubleMatrix &getPopulation() const;
+        [[nodiscard]] DoubleMatrix getPopulation() const;
 
         /**
          * @brief setter for individuals matrix
          */
         void setPopulation(const DoubleMatrix &individuals);
 
+        /**
+         * @brief getter for the contiguous individuals matrix
+         */
+        [[nodiscard]] const PopulationMatrix &getPopulationMatrix() const;
+
         /**
          * @brief getter for population fitness
          */
@@ -124,6 +196,104 @@ namespace opt {
          */
         void setPopulationFitness(const DoubleVector &populationFitness);
 
+        /**
+         * @brief getter for the number of threads used to
+         * evaluate the fitness of the child population
+         */
+        [[nodiscard]] int getNumThreads() const;
+
+        /**
+         * @brief setter for the number of threads used to
+         * evaluate the fitness of the child population.
+         * @details defaults to 1, i.e. serial evaluation. When
+         * greater than 1, the cost function is called concurrently
+         * and therefore must be thread safe. Results do not depend
+         * on the number of threads.
+         */
+        void setNumThreads(int numThreads);
+
+        /**
+         * @brief evaluate on @param threadPool, which may be shared with
+         * other optimizers, and set the number of threads to its size.
+         * @details the pool runs the jobs of its optimizers one after the
+         * other. nullptr goes back to serial evaluation.
+         */
+        void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+
+        /**
+         * @brief remember the fitness of up to @param capacity parameter
+         * vectors and reuse it instead of calling the cost function again.
+         * @details with @param quantum greater than 0 parameters are rounded
+         * to the nearest multiple of quantum before being compared, so
+         * nearly identical individuals share a fitness. A capacity of 0
+         * removes the cache. Only worthwhile for expensive cost functions
+         * which give the same result for the same parameters.
+         */
+        void setFitnessCache(size_t capacity, double quantum = 0.0);
+
+        /**
+         * @brief the fitness cache, nullptr when there is none
+         */
+        [[nodiscard]] const FitnessCache *getFitnessCache() const;
+
+        /**
+         * @brief keep every evaluation in the EvaluationStore at @param path,
+         * and reuse the fitness of the parameter vectors already in it,
+         * including those evaluated by earlier runs. The store is created
+         * if it does not exist. An empty path closes the store.
+         * @details consulted after the fitness cache. Records are written
+         * by a background thread.
+         */
+        void setEvaluationStore(const std::string &path);
+
+        /**
+         * @brief the evaluation store, nullptr when there is none
+         */
+        [[nodiscard]] EvaluationStore *getEvaluationStore() const;
+
+        /**
+         * @brief ask the optimizer to stop. Safe to call from any thread.
+         * @details checked between generations and before each evaluation.
+         * Evaluations already running are finished, the rest of the
+         * generation is dropped and the run stops with the state of the
+         * last complete generation, so the best individual so far is kept
+         * and a checkpoint of it can be resumed. The request stays in place,
+         * stopping later runs too, until resetCancellation() is called.
+         */
+        void cancel();
+
+        [[nodiscard]] bool isCancelled() const;
+
+        void resetCancellation();
+
+        /**
+         * @brief the token behind cancel(), for code which
+         * needs to cancel the optimizer without holding it
+         */
+        [[nodiscard]] const std::shared_ptr<CancellationToken> &getCancellationToken() const;
+
+        /**
+         * @brief cancel this optimizer on SIGINT and SIGTERM, or with
+         * @param cancelOnSignal false put the previous handlers back, unless
+         * another optimizer has taken the signals over since.
+         * @details the handlers are process wide, see opt::cancelOnSignal
+         */
+        void setCancelOnSignal(bool cancelOnSignal);
+
+        /**
+         * @brief calls to the cost function since the run started,
+         * one per individual for a BatchCostFunction. Saved in
+         * checkpoints, so a resumed run carries on counting.
+         */
+        [[nodiscard]] std::uint64_t getNumEvaluations() const;
+
+        /**
+         * @brief time spent in each phase of the run so far and the
+         * latency of the cost function, see Profile. Only collected when
+         * the library is built with SRES_ENABLE_PROFILING, otherwise all 0.
+         */
+        [[nodiscard]] Profile getProfile() const;
+
     protected:
 
         /**
@@ -135,7 +305,57 @@ namespace opt {
          * but individual algorithms can implement their own
          * evaluate method.
          */
-        virtual bool evaluate(std::vector<double> individual);
+        virtual bool evaluate(const double *individual);
+
+        /**
+         * @brief Evaluate the fitness of rows [@param first, @param last)
+         * of the population_ matrix and store them in the same
+         * slots of populationFitness_.
+         * @details when a BatchCostFunction is set the rows are
+         * handed over in one call. Otherwise, when numThreads_ is
+         * greater than 1 the rows are spread over a pool of worker
+         * threads. Since each evaluation only writes to its own slot,
+         * the results are the same regardless of the number of threads.
+         * When @param selected is given only the rows i with a non zero
+         * selected[i] are evaluated. Rows found in the fitness cache
+         * or the evaluation store are not evaluated either.
+         * @returns false when the optimizer was cancelled before every
+         * row was evaluated, unless @param cancellable is false.
+         */
+        bool evaluatePopulation(size_t first, size_t last, const std::uint8_t *selected = nullptr,
+                                bool cancellable = true);
+
+        /**
+         * @brief evaluatePopulation without the fitness cache
+         */
+        bool evaluateRows(size_t first, size_t last, const std::uint8_t *selected, bool cancellable);
+
+        /**
+         * @brief constraint violation of @param individual, recorded
+         * next to its fitness in the evaluation store
+         */
+        [[nodiscard]] virtual double violation(size_t individual) const;
+
+        /**
+         * @brief call @param fn for every individual index in
+         * [@param first, @param last), spread over numThreads_ threads.
+         * @details @param fn must only write to state owned by its index.
+         */
+        template<class Function>
+        void forEachIndividual(size_t first, size_t last, Function &&fn) {
+            if (numThreads_ > 1) {
+                getThreadPool().parallelFor(first, last, fn);
+            } else {
+                for (size_t i = first; i < last; i++)
+                    fn(i);
+            }
+        }
+
+        /**
+         * @brief the worker pool, (re)created if it does not
+         * match numThreads_
+         */
+        ThreadPool &getThreadPool();
 
         /**
          * @brief Perform the mutation operation
@@ -191,9 +411,9 @@ namespace opt {
          * @brief matrix on individuals where rows are parameter
          * sets while columns are parameter candidates. In
          * other words, each row in this matrix is a candidate
-         * solution.
+         * solution. All rows live in one contiguous buffer.
          */
-        DoubleMatrix population_;
+        PopulationMatrix population_;
 
         /**
          * @brief A vector containing all the fitness
@@ -208,6 +428,47 @@ namespace opt {
          */
         int childRate_ = 7;
 
+        /**
+         * @brief number of threads used by evaluatePopulation.
+         */
+        int numThreads_ = 1;
+
+        /**
+         * @brief worker threads for evaluatePopulation. Created
+         * lazily the first time more than one thread is requested.
+         */
+        std::shared_ptr<ThreadPool> threadPool_;
+
+        std::shared_ptr<FitnessCache> fitnessCache_;
+
+        std::shared_ptr<EvaluationStore> evaluationStore_;
+
+        /**
+         * @brief rows evaluatePopulation did not find in the
+         * fitness cache or the evaluation store
+         */
+        std::vector<std::uint8_t> cacheMisses_;
+
+        /**
+         * @brief wall time of the cost function call of each row,
+         * recorded in the evaluation store. Only kept while there is one.
+         */
+        DoubleVector evaluationSeconds_;
+
+        std::uint64_t numEvaluations_ = 0;
+
+#ifdef SRES_PROFILING
+        /**
+         * @brief reset when a run starts
+         */
+        std::shared_ptr<Profiler> profiler_ = std::make_shared<Profiler>();
+#endif
+
+        /**
+         * @brief shared with whoever asked for it with getCancellationToken()
+         */
+        std::shared_ptr<CancellationToken> cancellationToken_ = std::make_shared<CancellationToken>();
+
     };
 
 }
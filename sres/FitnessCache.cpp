@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "FitnessCache.h"
+#include "Error.h"
+
+namespace opt {
+
+    FitnessCache::FitnessCache(size_t capacity, size_t numParameters, double quantum)
+            : capacity_(capacity), numParameters_(numParameters), quantum_(quantum) {
+        if (capacity == 0) {
+            INVALID_ARGUMENT_ERROR << "The capacity of a fitness cache must be at least 1" << std::endl;
+        }
+        if (!(quantum >= 0.0)) {
+            INVALID_ARGUMENT_ERROR << "The quantum of a fitness cache cannot be negative" << std::endl;
+        }
+        keys_.resize(capacity * numParameters);
+        fitness_.resize(capacity);
+        hashes_.resize(capacity);
+        prev_.resize(capacity);
+        next_.resize(capacity);
+        key_.resize(numParameters);
+
+        size_t tableSize = 8;
+        while (tableSize < 2 * capacity)
+            tableSize *= 2;
+        table_.assign(tableSize, Empty);
+        mask_ = tableSize - 1;
+    }
+
+    std::uint64_t FitnessCache::hashKey(const double *key, size_t n) {
+        std::uint64_t hash = 0x9E3779B97F4A7C15ULL;
+        for (size_t j = 0; j < n; j++) {
+            std::uint64_t bits;
+            std::memcpy(&bits, key + j, sizeof(bits));
+            hash = (hash ^ bits) * 0xBF58476D1CE4E5B9ULL;
+            hash ^= hash >> 31;
+        }
+        return hash;
+    }
+
+    std::uint64_t FitnessCache::makeKey(const double *parameters) {
+        for (size_t j = 0; j < numParameters_; j++) {
+            double value = parameters[j];
+            if (quantum_ > 0.0)
+                value = std::nearbyint(value / quantum_);
+            // so that -0 and 0 are the same key
+            key_[j] = value + 0.0;
+        }
+        return hashKey(key_.data(), numParameters_);
+    }
+
+    size_t FitnessCache::findSlot(std::uint64_t hash) const {
+        size_t slot = hash & mask_;
+        while (table_[slot] != Empty) {
+            size_t entry = table_[slot];
+            if (hashes_[entry] == hash &&
+                std::memcmp(keys_.data() + entry * numParameters_, key_.data(),
+                            numParameters_ * sizeof(double)) == 0)
+                return slot;
+            slot = (slot + 1) & mask_;
+        }
+        return slot;
+    }
+
+    void FitnessCache::eraseSlot(size_t slot) {
+        // backward shift deletion for linear probing
+        size_t hole = slot;
+        size_t next = slot;
+        while (true) {
+            next = (next + 1) & mask_;
+            if (table_[next] == Empty)
+                break;
+            size_t home = hashes_[table_[next]] & mask_;
+            // the entry in next may move into the hole unless its home
+            // slot lies cyclically in (hole, next]
+            bool homeBetween = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (!homeBetween) {
+                table_[hole] = table_[next];
+                hole = next;
+            }
+        }
+        table_[hole] = Empty;
+    }
+
+    void FitnessCache::unlink(size_t entry) {
+        if (prev_[entry] != Empty)
+            next_[prev_[entry]] = next_[entry];
+        else
+            head_ = next_[entry];
+        if (next_[entry] != Empty)
+            prev_[next_[entry]] = prev_[entry];
+        else
+            tail_ = prev_[entry];
+    }
+
+    void FitnessCache::pushFront(size_t entry) {
+        prev_[entry] = Empty;
+        next_[entry] = head_;
+        if (head_ != Empty)
+            prev_[head_] = entry;
+        head_ = entry;
+        if (tail_ == Empty)
+            tail_ = entry;
+    }
+
+    bool FitnessCache::lookup(const double *parameters, double &fitness) {
+        size_t slot = findSlot(makeKey(parameters));
+        size_t entry = table_[slot];
+        if (entry == Empty) {
+            misses_++;
+            return false;
+        }
+        hits_++;
+        fitness = fitness_[entry];
+        unlink(entry);
+        pushFront(entry);
+        return true;
+    }
+
+    void FitnessCache::insert(const double *parameters, double fitness) {
+        std::uint64_t hash = makeKey(parameters);
+        size_t slot = findSlot(hash);
+        size_t entry = table_[slot];
+        if (entry != Empty) {
+            fitness_[entry] = fitness;
+            unlink(entry);
+            pushFront(entry);
+            return;
+        }
+
+        if (size_ < capacity_) {
+            entry = size_++;
+        } else {
+            // reuse the least recently used entry
+            entry = tail_;
+            unlink(entry);
+            size_t oldSlot = hashes_[entry] & mask_;
+            while (table_[oldSlot] != entry)
+                oldSlot = (oldSlot + 1) & mask_;
+            eraseSlot(oldSlot);
+            // erasing may have moved the probe sequence of the new key
+            slot = findSlot(hash);
+        }
+
+        std::copy(key_.begin(), key_.end(), keys_.begin() + entry * numParameters_);
+        fitness_[entry] = fitness;
+        hashes_[entry] = hash;
+        table_[slot] = entry;
+        pushFront(entry);
+    }
+
+    void FitnessCache::clear() {
+        std::fill(table_.begin(), table_.end(), Empty);
+        head_ = tail_ = Empty;
+        size_ = 0;
+        hits_ = misses_ = 0;
+    }
+
+    size_t FitnessCache::size() const {
+        return size_;
+    }
+
+    size_t FitnessCache::getCapacity() const {
+        return capacity_;
+    }
+
+    size_t FitnessCache::getNumParameters() const {
+        return numParameters_;
+    }
+
+    double FitnessCache::getQuantum() const {
+        return quantum_;
+    }
+
+    std::uint64_t FitnessCache::getHits() const {
+        return hits_;
+    }
+
+    std::uint64_t FitnessCache::getMisses() const {
+        return misses_;
+    }
+
+}
@@ -0,0 +1,134 @@
+#ifndef SRES_FITNESSCACHE_H
+#define SRES_FITNESSCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace opt {
+
+    /**
+     * @brief bounded least recently used map from parameter vectors
+     * to their fitness, so that individuals which come out of mutation
+     * unchanged are not evaluated twice.
+     * @details All storage is allocated by the constructor: the keys
+     * live in one contiguous capacity x numParameters block, indexed by
+     * an open addressing hash table, and the recency order is kept in
+     * a doubly linked list of entry indices. When full, inserting evicts
+     * the least recently used entry. Keys are the exact parameter values
+     * or, with a quantum greater than 0, the parameters rounded to the
+     * nearest multiple of the quantum, so that nearly identical
+     * individuals share a fitness. Not thread safe.
+     */
+    class FitnessCache {
+
+    public:
+
+        FitnessCache(size_t capacity, size_t numParameters, double quantum = 0.0);
+
+        /**
+         * @brief look @param parameters up. On a hit @param fitness
+         * is set and the entry becomes the most recently used.
+         */
+        bool lookup(const double *parameters, double &fitness);
+
+        /**
+         * @brief remember the @param fitness of @param parameters
+         */
+        void insert(const double *parameters, double fitness);
+
+        /**
+         * @brief forget every entry and reset the counters
+         */
+        void clear();
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] size_t getCapacity() const;
+
+        [[nodiscard]] size_t getNumParameters() const;
+
+        [[nodiscard]] double getQuantum() const;
+
+        [[nodiscard]] std::uint64_t getHits() const;
+
+        [[nodiscard]] std::uint64_t getMisses() const;
+
+        /**
+         * @brief hash of the @param n doubles of @param key, from their bits
+         */
+        static std::uint64_t hashKey(const double *key, size_t n);
+
+    private:
+
+        static constexpr size_t Empty = static_cast<size_t>(-1);
+
+        /**
+         * @brief store the key of @param parameters in key_ and return its hash
+         */
+        std::uint64_t makeKey(const double *parameters);
+
+        /**
+         * @brief table slot holding the entry equal to key_, or the
+         * empty slot where it would go
+         */
+        [[nodiscard]] size_t findSlot(std::uint64_t hash) const;
+
+        /**
+         * @brief remove the entry in table slot @param slot, moving later
+         * entries of the probe sequence back so that no lookup is broken
+         */
+        void eraseSlot(size_t slot);
+
+        void unlink(size_t entry);
+
+        void pushFront(size_t entry);
+
+        size_t capacity_;
+
+        size_t numParameters_;
+
+        double quantum_;
+
+        /**
+         * @brief capacity_ x numParameters_ keys, row major
+         */
+        std::vector<double> keys_;
+
+        std::vector<double> fitness_;
+
+        std::vector<std::uint64_t> hashes_;
+
+        /**
+         * @brief recency list, most recently used first
+         */
+        std::vector<size_t> prev_;
+
+        std::vector<size_t> next_;
+
+        size_t head_ = Empty;
+
+        size_t tail_ = Empty;
+
+        /**
+         * @brief entry index per slot, a power of two of at least twice capacity_ slots
+         */
+        std::vector<size_t> table_;
+
+        size_t mask_;
+
+        /**
+         * @brief scratch copy of the key being looked up
+         */
+        std::vector<double> key_;
+
+        size_t size_ = 0;
+
+        std::uint64_t hits_ = 0;
+
+        std::uint64_t misses_ = 0;
+    };
+
+}
+
+#endif //SRES_FITNESSCACHE_H
@@ -0,0 +1,188 @@
+#include "IslandModel.h"
+#include "Error.h"
+
+namespace opt {
+
+    IslandModel::IslandModel(CostFunction cost, int numIslands, int populationSize, int numGenerations,
+                             const DoubleVector &startingValues, const DoubleVector &lb,
+                             const DoubleVector &ub, int childrate)
+            : numThreads_(numIslands),
+              seed_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
+        if (numIslands < 1) {
+            INVALID_ARGUMENT_ERROR << "An island model needs at least one island, got " << numIslands << std::endl;
+        }
+        islands_.reserve(numIslands);
+        for (int i = 0; i < numIslands; i++)
+            islands_.push_back(std::make_unique<SRES>(
+                    cost, populationSize, numGenerations, startingValues, lb, ub, childrate));
+        setSeed(seed_);
+    }
+
+    int IslandModel::getNumIslands() const {
+        return (int) islands_.size();
+    }
+
+    SRES &IslandModel::getIsland(int i) {
+        if (i < 0 || i >= getNumIslands()) {
+            INVALID_ARGUMENT_ERROR << "Island " << i << " does not exist. There are "
+                                   << getNumIslands() << " islands" << std::endl;
+        }
+        return *islands_[i];
+    }
+
+    int IslandModel::getMigrationInterval() const {
+        return migrationInterval_;
+    }
+
+    void IslandModel::setMigrationInterval(int migrationInterval) {
+        if (migrationInterval < 1) {
+            INVALID_ARGUMENT_ERROR << "The migration interval must be at least 1 generation, got "
+                                   << migrationInterval << std::endl;
+        }
+        migrationInterval_ = migrationInterval;
+    }
+
+    int IslandModel::getMigrationSize() const {
+        return migrationSize_;
+    }
+
+    void IslandModel::setMigrationSize(int migrationSize) {
+        if (migrationSize < 0 || migrationSize > islands_[0]->getPopulationSize()) {
+            INVALID_ARGUMENT_ERROR << "The migration size must be between 0 and the population size ("
+                                   << islands_[0]->getPopulationSize() << "), got " << migrationSize << std::endl;
+        }
+        migrationSize_ = migrationSize;
+    }
+
+    IslandModel::Topology IslandModel::getTopology() const {
+        return topology_;
+    }
+
+    void IslandModel::setTopology(IslandModel::Topology topology) {
+        topology_ = topology;
+    }
+
+    int IslandModel::getNumThreads() const {
+        return numThreads_;
+    }
+
+    void IslandModel::setNumThreads(int numThreads) {
+        numThreads_ = numThreads < 1 ? 1 : numThreads;
+        threadPool_.reset();
+    }
+
+    unsigned long long IslandModel::getSeed() const {
+        return seed_;
+    }
+
+    void IslandModel::setSeed(unsigned long long seed) {
+        seed_ = seed;
+        for (size_t i = 0; i < islands_.size(); i++)
+            islands_[i]->setSeed(RandomNumberGenerator::deriveSeed(seed, i));
+    }
+
+    void IslandModel::setStopAfterStalledGenerations(unsigned int stopAfterStalledGenerations) {
+        for (auto &island: islands_)
+            island->setStopAfterStalledGenerations(stopAfterStalledGenerations);
+    }
+
+    double IslandModel::getBestFitnessValue() const {
+        return islands_[bestIsland_]->getBestFitnessValue();
+    }
+
+    const DoubleVector &IslandModel::getSolutionValues() const {
+        return islands_[bestIsland_]->getSolutionValues();
+    }
+
+    int IslandModel::getBestIsland() const {
+        return bestIsland_;
+    }
+
+    DoubleVector IslandModel::getHallOfFame(int i) {
+        return getIsland(i).getHallOfFame();
+    }
+
+    DoubleMatrix IslandModel::getHallsOfFame() {
+        DoubleMatrix hallsOfFame;
+        hallsOfFame.reserve(islands_.size());
+        for (auto &island: islands_)
+            hallsOfFame.push_back(island->getHallOfFame());
+        return hallsOfFame;
+    }
+
+    int IslandModel::getNumMigrations() const {
+        return numMigrations_;
+    }
+
+    size_t IslandModel::destination(size_t source, RandomNumberGenerator &rng) const {
+        size_t n = islands_.size();
+        if (topology_ == Ring)
+            return (source + 1) % n;
+        // any island but the source
+        auto offset = (size_t) rng.uniformInt(1, (int) n - 1);
+        return (source + offset) % n;
+    }
+
+    void IslandModel::migrate() {
+        if (islands_.size() < 2 || migrationSize_ == 0)
+            return;
+
+        // collect every island's emigrants before any island changes
+        std::vector<std::vector<Individual>> emigrants(islands_.size());
+        for (size_t i = 0; i < islands_.size(); i++)
+            emigrants[i] = islands_[i]->getBestIndividuals(migrationSize_);
+
+        RandomNumberGenerator rng = RandomNumberGenerator(seed_).substream(
+                numMigrations_, RandomNumberGenerator::SelectStream);
+        std::vector<std::vector<Individual>> immigrants(islands_.size());
+        for (size_t i = 0; i < islands_.size(); i++) {
+            size_t to = destination(i, rng);
+            immigrants[to].insert(immigrants[to].end(), emigrants[i].begin(), emigrants[i].end());
+        }
+
+        for (size_t i = 0; i < islands_.size(); i++) {
+            if (islands_[i]->isFinished() || immigrants[i].empty())
+                continue;
+            if (immigrants[i].size() > (size_t) islands_[i]->getPopulationSize())
+                immigrants[i].resize(islands_[i]->getPopulationSize());
+            islands_[i]->immigrate(immigrants[i]);
+        }
+        numMigrations_++;
+    }
+
+    bool IslandModel::fit() {
+        for (auto &island: islands_)
+            island->restart();
+        numMigrations_ = 0;
+
+        if (numThreads_ > 1 && !threadPool_)
+            threadPool_ = std::make_shared<ThreadPool>(numThreads_);
+
+        while (true) {
+            auto stepIsland = [this](size_t i) { islands_[i]->step(migrationInterval_); };
+            if (threadPool_) {
+                threadPool_->parallelFor(0, islands_.size(), stepIsland);
+            } else {
+                for (size_t i = 0; i < islands_.size(); i++)
+                    stepIsland(i);
+            }
+
+            bool finished = true, cancelled = false;
+            for (auto &island: islands_) {
+                finished = finished && island->isFinished();
+                cancelled = cancelled || island->isCancelled();
+            }
+            if (finished || cancelled)
+                break;
+            migrate();
+        }
+
+        bestIsland_ = 0;
+        for (size_t i = 1; i < islands_.size(); i++) {
+            if (islands_[i]->getBestFitnessValue() < islands_[bestIsland_]->getBestFitnessValue())
+                bestIsland_ = (int) i;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,158 @@
+#ifndef SRES_ISLANDMODEL_H
+#define SRES_ISLANDMODEL_H
+
+#include <memory>
+#include <vector>
+#include "SRES.h"
+#include "ThreadPool.h"
+
+namespace opt {
+
+    /**
+     * @brief runs several SRES populations (islands) side by side and
+     * periodically copies the best individuals of each island into its
+     * neighbours.
+     * @details Each island has its own seed, derived from the seed of the
+     * model, and is stepped on its own thread with SRES::step. Every
+     * migrationInterval generations all islands pause, the best
+     * migrationSize parents of every island are sent to the island(s)
+     * given by the topology and replace the worst parents there.
+     * Islands only interact at migration so, for a given seed, results do
+     * not depend on the number of threads or on how they are scheduled.
+     */
+    class IslandModel {
+
+    public:
+
+        enum Topology {
+            /**
+             * @brief island i sends its migrants to island i + 1
+             */
+            Ring,
+
+            /**
+             * @brief at each migration every island sends its migrants to
+             * another island chosen at random
+             */
+            Random
+        };
+
+        IslandModel(CostFunction cost, int numIslands, int populationSize, int numGenerations,
+                    const DoubleVector &startingValues, const DoubleVector &lb,
+                    const DoubleVector &ub, int childrate = 7);
+
+        /**
+         * @brief run every island to completion, migrating
+         * between islands as configured.
+         */
+        bool fit();
+
+        [[nodiscard]] int getNumIslands() const;
+
+        /**
+         * @brief island @param i, for example to configure its pf
+         * or stopping criteria before fit() is called
+         */
+        SRES &getIsland(int i);
+
+        [[nodiscard]] int getMigrationInterval() const;
+
+        /**
+         * @brief number of generations between migrations
+         */
+        void setMigrationInterval(int migrationInterval);
+
+        [[nodiscard]] int getMigrationSize() const;
+
+        /**
+         * @brief number of individuals each island sends at every migration
+         */
+        void setMigrationSize(int migrationSize);
+
+        [[nodiscard]] Topology getTopology() const;
+
+        void setTopology(Topology topology);
+
+        [[nodiscard]] int getNumThreads() const;
+
+        /**
+         * @brief number of threads the islands are stepped on.
+         * Defaults to one per island.
+         */
+        void setNumThreads(int numThreads);
+
+        [[nodiscard]] unsigned long long getSeed() const;
+
+        /**
+         * @brief seed the model. Island i is seeded with
+         * RandomNumberGenerator::deriveSeed(seed, i).
+         */
+        void setSeed(unsigned long long seed);
+
+        /**
+         * @brief the stopping criteria of every island
+         */
+        void setStopAfterStalledGenerations(unsigned int stopAfterStalledGenerations);
+
+        /**
+         * @brief best fitness found by any island
+         */
+        [[nodiscard]] double getBestFitnessValue() const;
+
+        /**
+         * @brief parameters of the best individual found by any island
+         */
+        [[nodiscard]] const DoubleVector &getSolutionValues() const;
+
+        /**
+         * @brief index of the island which found the best individual
+         */
+        [[nodiscard]] int getBestIsland() const;
+
+        /**
+         * @brief best fitness of island @param i at every generation
+         */
+        DoubleVector getHallOfFame(int i);
+
+        /**
+         * @brief the hall of fame of every island
+         */
+        DoubleMatrix getHallsOfFame();
+
+        /**
+         * @brief number of migrations performed by the last call to fit()
+         */
+        [[nodiscard]] int getNumMigrations() const;
+
+    private:
+
+        /**
+         * @brief exchange individuals between the islands
+         * which have not yet finished
+         */
+        void migrate();
+
+        [[nodiscard]] size_t destination(size_t source, RandomNumberGenerator &rng) const;
+
+        std::vector<std::unique_ptr<SRES>> islands_;
+
+        int migrationInterval_ = 10;
+
+        int migrationSize_ = 1;
+
+        Topology topology_ = Ring;
+
+        int numThreads_;
+
+        unsigned long long seed_;
+
+        int numMigrations_ = 0;
+
+        int bestIsland_ = 0;
+
+        std::shared_ptr<ThreadPool> threadPool_;
+    };
+
+}
+
+#endif //SRES_ISLANDMODEL_H
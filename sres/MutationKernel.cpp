@@ -0,0 +1,361 @@
+#include "MutationKernel.h"
+#include "Error.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SRES_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace opt {
+
+    namespace {
+        // exp(x) = 2^k * exp(r) with k = round(x / ln 2) and |r| <= ln 2 / 2
+        constexpr double ExpLo = -708.0;
+        constexpr double ExpHi = 709.0;
+        constexpr double Log2e = 1.4426950408889634074;
+        constexpr double Ln2Hi = 6.93145751953125e-1;
+        constexpr double Ln2Lo = 1.42860682030941723212e-6;
+
+        // adding and subtracting 1.5 * 2^52 rounds to the nearest
+        // integer, which is then held in the low bits of the sum
+        constexpr double RoundShift = 6755399441055744.0;
+        constexpr std::int64_t RoundShiftBits = 0x4338000000000000;
+
+        // Taylor series of exp(r), good to an ulp or so for |r| <= ln 2 / 2
+        constexpr double C13 = 1.0 / 6227020800.0;
+        constexpr double C12 = 1.0 / 479001600.0;
+        constexpr double C11 = 1.0 / 39916800.0;
+        constexpr double C10 = 1.0 / 3628800.0;
+        constexpr double C9 = 1.0 / 362880.0;
+        constexpr double C8 = 1.0 / 40320.0;
+        constexpr double C7 = 1.0 / 5040.0;
+        constexpr double C6 = 1.0 / 720.0;
+        constexpr double C5 = 1.0 / 120.0;
+        constexpr double C4 = 1.0 / 24.0;
+        constexpr double C3 = 1.0 / 6.0;
+        constexpr double C2 = 0.5;
+        constexpr double C1 = 1.0;
+        constexpr double C0 = 1.0;
+
+        /**
+         * @brief one lane of the kernel. The vector implementations
+         * perform exactly these operations, in this order.
+         */
+        inline bool mutateLane(double &x, double &variance, double maxVariance, double lb, double ub,
+                               double v1Term, double tau, double varianceNormal, double stepNormal) {
+            double scaled = variance * kernelExp(v1Term + tau * varianceNormal);
+            variance = maxVariance < scaled ? maxVariance : scaled;
+            double trial = x + variance * stepNormal;
+            bool outOfBounds = (lb > trial) || (trial > ub);
+            if (!outOfBounds)
+                x = trial;
+            return outOfBounds;
+        }
+
+        size_t mutationKernelScalar(size_t first, size_t n, double *x, double *variance, const double *maxVariance,
+                                    const double *lb, const double *ub, double v1Term, double tau,
+                                    const double *varianceNormals, const double *stepNormals,
+                                    std::uint8_t *outOfBounds) {
+            size_t count = 0;
+            for (size_t j = first; j < n; j++) {
+                outOfBounds[j] = mutateLane(x[j], variance[j], maxVariance[j], lb[j], ub[j],
+                                            v1Term, tau, varianceNormals[j], stepNormals[j]);
+                count += outOfBounds[j];
+            }
+            return count;
+        }
+
+        /**
+         * @brief squared distance of @param x to [lb, ub]
+         */
+        inline double boundViolation(double x, double lb, double ub) {
+            double below = lb > x ? lb - x : 0.0;
+            double above = x > ub ? x - ub : 0.0;
+            return below * below + above * above;
+        }
+
+        /**
+         * @brief the bound terms of phi are accumulated in 8 partial sums,
+         * term j going to sum j % 8, which are then added pairwise. The
+         * vector implementations fill the same 8 sums.
+         */
+        constexpr size_t PhiLanes = 8;
+
+        inline double phiRow(const double *acc, const double *constraintValues, size_t numConstraints) {
+            double s0 = acc[0] + acc[4];
+            double s1 = acc[1] + acc[5];
+            double s2 = acc[2] + acc[6];
+            double s3 = acc[3] + acc[7];
+            double total = (s0 + s2) + (s1 + s3);
+            for (size_t k = 0; k < numConstraints; k++) {
+                if (constraintValues[k] > 0.0)
+                    total += constraintValues[k] * constraintValues[k];
+            }
+            return total;
+        }
+
+        void phiKernelScalar(size_t numIndividuals, size_t n, const double *population, const double *lb,
+                             const double *ub, const double *constraintValues, size_t numConstraints, double *phi) {
+            for (size_t i = 0; i < numIndividuals; i++) {
+                const double *x = population + i * n;
+                double acc[PhiLanes] = {0, 0, 0, 0, 0, 0, 0, 0};
+                for (size_t j = 0; j < n; j++)
+                    acc[j % PhiLanes] += boundViolation(x[j], lb[j], ub[j]);
+                phi[i] = phiRow(acc, constraintValues ? constraintValues + i * numConstraints : nullptr,
+                                numConstraints);
+            }
+        }
+
+#ifdef SRES_X86_KERNELS
+
+        __attribute__((target("avx2")))
+        inline __m256d boundViolation4(__m256d x, __m256d lb, __m256d ub) {
+            __m256d below = _mm256_and_pd(_mm256_cmp_pd(lb, x, _CMP_GT_OQ), _mm256_sub_pd(lb, x));
+            __m256d above = _mm256_and_pd(_mm256_cmp_pd(x, ub, _CMP_GT_OQ), _mm256_sub_pd(x, ub));
+            return _mm256_add_pd(_mm256_mul_pd(below, below), _mm256_mul_pd(above, above));
+        }
+
+        __attribute__((target("avx2")))
+        void phiKernelAVX2(size_t numIndividuals, size_t n, const double *population, const double *lb,
+                           const double *ub, const double *constraintValues, size_t numConstraints, double *phi) {
+            for (size_t i = 0; i < numIndividuals; i++) {
+                const double *x = population + i * n;
+                __m256d lo = _mm256_setzero_pd();
+                __m256d hi = _mm256_setzero_pd();
+                size_t j = 0;
+                for (; j + PhiLanes <= n; j += PhiLanes) {
+                    lo = _mm256_add_pd(lo, boundViolation4(
+                            _mm256_loadu_pd(x + j), _mm256_loadu_pd(lb + j), _mm256_loadu_pd(ub + j)));
+                    hi = _mm256_add_pd(hi, boundViolation4(
+                            _mm256_loadu_pd(x + j + 4), _mm256_loadu_pd(lb + j + 4), _mm256_loadu_pd(ub + j + 4)));
+                }
+                double acc[PhiLanes];
+                _mm256_storeu_pd(acc, lo);
+                _mm256_storeu_pd(acc + 4, hi);
+                for (; j < n; j++)
+                    acc[j % PhiLanes] += boundViolation(x[j], lb[j], ub[j]);
+                phi[i] = phiRow(acc, constraintValues ? constraintValues + i * numConstraints : nullptr,
+                                numConstraints);
+            }
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256d exp4(__m256d x) {
+            x = _mm256_blendv_pd(x, _mm256_set1_pd(ExpLo), _mm256_cmp_pd(x, _mm256_set1_pd(ExpLo), _CMP_LT_OQ));
+            x = _mm256_blendv_pd(x, _mm256_set1_pd(ExpHi), _mm256_cmp_pd(x, _mm256_set1_pd(ExpHi), _CMP_GT_OQ));
+
+            __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(Log2e)), _mm256_set1_pd(RoundShift));
+            __m256d k = _mm256_sub_pd(shifted, _mm256_set1_pd(RoundShift));
+            __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(Ln2Hi)));
+            r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(Ln2Lo)));
+
+            __m256d p = _mm256_set1_pd(C13);
+            for (double c: {C12, C11, C10, C9, C8, C7, C6, C5, C4, C3, C2, C1, C0})
+                p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(c));
+
+            __m256i bits = _mm256_sub_epi64(_mm256_castpd_si256(shifted), _mm256_set1_epi64x(RoundShiftBits));
+            bits = _mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+            return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+        }
+
+        __attribute__((target("avx2")))
+        size_t mutationKernelAVX2(size_t n, double *x, double *variance, const double *maxVariance,
+                                  const double *lb, const double *ub, double v1Term, double tau,
+                                  const double *varianceNormals, const double *stepNormals,
+                                  std::uint8_t *outOfBounds) {
+            size_t count = 0;
+            size_t j = 0;
+            for (; j + 4 <= n; j += 4) {
+                __m256d e = exp4(_mm256_add_pd(_mm256_set1_pd(v1Term), _mm256_mul_pd(
+                        _mm256_set1_pd(tau), _mm256_loadu_pd(varianceNormals + j))));
+                __m256d scaled = _mm256_mul_pd(_mm256_loadu_pd(variance + j), e);
+                __m256d maxVar = _mm256_loadu_pd(maxVariance + j);
+                __m256d var = _mm256_blendv_pd(scaled, maxVar, _mm256_cmp_pd(maxVar, scaled, _CMP_LT_OQ));
+                _mm256_storeu_pd(variance + j, var);
+
+                __m256d current = _mm256_loadu_pd(x + j);
+                __m256d trial = _mm256_add_pd(current, _mm256_mul_pd(var, _mm256_loadu_pd(stepNormals + j)));
+                __m256d out = _mm256_or_pd(
+                        _mm256_cmp_pd(_mm256_loadu_pd(lb + j), trial, _CMP_GT_OQ),
+                        _mm256_cmp_pd(trial, _mm256_loadu_pd(ub + j), _CMP_GT_OQ));
+                _mm256_storeu_pd(x + j, _mm256_blendv_pd(trial, current, out));
+
+                int mask = _mm256_movemask_pd(out);
+                for (int lane = 0; lane < 4; lane++)
+                    outOfBounds[j + lane] = (mask >> lane) & 1;
+                count += __builtin_popcount(mask);
+            }
+            return count + mutationKernelScalar(j, n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                                                varianceNormals, stepNormals, outOfBounds);
+        }
+
+        __attribute__((target("avx512f")))
+        inline __m512d exp8(__m512d x) {
+            x = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, _mm512_set1_pd(ExpLo), _CMP_LT_OQ), x,
+                                     _mm512_set1_pd(ExpLo));
+            x = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, _mm512_set1_pd(ExpHi), _CMP_GT_OQ), x,
+                                     _mm512_set1_pd(ExpHi));
+
+            __m512d shifted = _mm512_add_pd(_mm512_mul_pd(x, _mm512_set1_pd(Log2e)), _mm512_set1_pd(RoundShift));
+            __m512d k = _mm512_sub_pd(shifted, _mm512_set1_pd(RoundShift));
+            __m512d r = _mm512_sub_pd(x, _mm512_mul_pd(k, _mm512_set1_pd(Ln2Hi)));
+            r = _mm512_sub_pd(r, _mm512_mul_pd(k, _mm512_set1_pd(Ln2Lo)));
+
+            __m512d p = _mm512_set1_pd(C13);
+            for (double c: {C12, C11, C10, C9, C8, C7, C6, C5, C4, C3, C2, C1, C0})
+                p = _mm512_add_pd(_mm512_mul_pd(p, r), _mm512_set1_pd(c));
+
+            __m512i bits = _mm512_sub_epi64(_mm512_castpd_si512(shifted), _mm512_set1_epi64(RoundShiftBits));
+            // with every lane selected this is _mm512_slli_epi64, which gcc
+            // warns may read its undefined merge source uninitialized
+            bits = _mm512_maskz_slli_epi64(0xFF, _mm512_add_epi64(bits, _mm512_set1_epi64(1023)), 52);
+            return _mm512_mul_pd(p, _mm512_castsi512_pd(bits));
+        }
+
+        __attribute__((target("avx512f")))
+        size_t mutationKernelAVX512(size_t n, double *x, double *variance, const double *maxVariance,
+                                    const double *lb, const double *ub, double v1Term, double tau,
+                                    const double *varianceNormals, const double *stepNormals,
+                                    std::uint8_t *outOfBounds) {
+            size_t count = 0;
+            size_t j = 0;
+            for (; j + 8 <= n; j += 8) {
+                __m512d e = exp8(_mm512_add_pd(_mm512_set1_pd(v1Term), _mm512_mul_pd(
+                        _mm512_set1_pd(tau), _mm512_loadu_pd(varianceNormals + j))));
+                __m512d scaled = _mm512_mul_pd(_mm512_loadu_pd(variance + j), e);
+                __m512d maxVar = _mm512_loadu_pd(maxVariance + j);
+                __m512d var = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(maxVar, scaled, _CMP_LT_OQ), scaled, maxVar);
+                _mm512_storeu_pd(variance + j, var);
+
+                __m512d current = _mm512_loadu_pd(x + j);
+                __m512d trial = _mm512_add_pd(current, _mm512_mul_pd(var, _mm512_loadu_pd(stepNormals + j)));
+                __mmask8 out = _mm512_cmp_pd_mask(_mm512_loadu_pd(lb + j), trial, _CMP_GT_OQ)
+                               | _mm512_cmp_pd_mask(trial, _mm512_loadu_pd(ub + j), _CMP_GT_OQ);
+                _mm512_storeu_pd(x + j, _mm512_mask_blend_pd(out, trial, current));
+
+                for (int lane = 0; lane < 8; lane++)
+                    outOfBounds[j + lane] = (out >> lane) & 1;
+                count += __builtin_popcount(out);
+            }
+            return count + mutationKernelScalar(j, n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                                                varianceNormals, stepNormals, outOfBounds);
+        }
+
+        __attribute__((target("avx512f")))
+        void phiKernelAVX512(size_t numIndividuals, size_t n, const double *population, const double *lb,
+                             const double *ub, const double *constraintValues, size_t numConstraints, double *phi) {
+            for (size_t i = 0; i < numIndividuals; i++) {
+                const double *x = population + i * n;
+                __m512d sum = _mm512_setzero_pd();
+                size_t j = 0;
+                for (; j + PhiLanes <= n; j += PhiLanes) {
+                    __m512d xj = _mm512_loadu_pd(x + j);
+                    __m512d lbj = _mm512_loadu_pd(lb + j);
+                    __m512d ubj = _mm512_loadu_pd(ub + j);
+                    __m512d below = _mm512_maskz_sub_pd(_mm512_cmp_pd_mask(lbj, xj, _CMP_GT_OQ), lbj, xj);
+                    __m512d above = _mm512_maskz_sub_pd(_mm512_cmp_pd_mask(xj, ubj, _CMP_GT_OQ), xj, ubj);
+                    sum = _mm512_add_pd(sum, _mm512_add_pd(_mm512_mul_pd(below, below), _mm512_mul_pd(above, above)));
+                }
+                double acc[PhiLanes];
+                _mm512_storeu_pd(acc, sum);
+                for (; j < n; j++)
+                    acc[j % PhiLanes] += boundViolation(x[j], lb[j], ub[j]);
+                phi[i] = phiRow(acc, constraintValues ? constraintValues + i * numConstraints : nullptr,
+                                numConstraints);
+            }
+        }
+
+#endif
+    }
+
+    double kernelExp(double x) {
+        x = x < ExpLo ? ExpLo : x;
+        x = x > ExpHi ? ExpHi : x;
+
+        double shifted = x * Log2e + RoundShift;
+        double k = shifted - RoundShift;
+        double r = x - k * Ln2Hi;
+        r = r - k * Ln2Lo;
+
+        double p = C13;
+        for (double c: {C12, C11, C10, C9, C8, C7, C6, C5, C4, C3, C2, C1, C0})
+            p = p * r + c;
+
+        std::int64_t bits;
+        std::memcpy(&bits, &shifted, sizeof(bits));
+        bits = (bits - RoundShiftBits + 1023) << 52;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    SimdLevel detectSimdLevel() {
+#ifdef SRES_X86_KERNELS
+        static const SimdLevel level = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f"))
+                return SimdLevel::AVX512;
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevel::AVX2;
+            return SimdLevel::Scalar;
+        }();
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    size_t mutationKernel(SimdLevel level, size_t n, double *x, double *variance, const double *maxVariance,
+                          const double *lb, const double *ub, double v1Term, double tau,
+                          const double *varianceNormals, const double *stepNormals,
+                          std::uint8_t *outOfBounds) {
+        if (level > detectSimdLevel()) {
+            INVALID_ARGUMENT_ERROR << "This processor does not support the requested instruction set" << std::endl;
+        }
+        switch (level) {
+#ifdef SRES_X86_KERNELS
+            case SimdLevel::AVX512:
+                return mutationKernelAVX512(n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                                            varianceNormals, stepNormals, outOfBounds);
+            case SimdLevel::AVX2:
+                return mutationKernelAVX2(n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                                          varianceNormals, stepNormals, outOfBounds);
+#endif
+            default:
+                return mutationKernelScalar(0, n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                                            varianceNormals, stepNormals, outOfBounds);
+        }
+    }
+
+    size_t mutationKernel(size_t n, double *x, double *variance, const double *maxVariance,
+                          const double *lb, const double *ub, double v1Term, double tau,
+                          const double *varianceNormals, const double *stepNormals,
+                          std::uint8_t *outOfBounds) {
+        return mutationKernel(detectSimdLevel(), n, x, variance, maxVariance, lb, ub, v1Term, tau,
+                              varianceNormals, stepNormals, outOfBounds);
+    }
+
+    void phiKernel(SimdLevel level, size_t numIndividuals, size_t n, const double *population, const double *lb,
+                   const double *ub, const double *constraintValues, size_t numConstraints, double *phi) {
+        if (level > detectSimdLevel()) {
+            INVALID_ARGUMENT_ERROR << "This processor does not support the requested instruction set" << std::endl;
+        }
+        switch (level) {
+#ifdef SRES_X86_KERNELS
+            case SimdLevel::AVX512:
+                return phiKernelAVX512(numIndividuals, n, population, lb, ub, constraintValues, numConstraints, phi);
+            case SimdLevel::AVX2:
+                return phiKernelAVX2(numIndividuals, n, population, lb, ub, constraintValues, numConstraints, phi);
+#endif
+            default:
+                return phiKernelScalar(numIndividuals, n, population, lb, ub, constraintValues, numConstraints, phi);
+        }
+    }
+
+    void phiKernel(size_t numIndividuals, size_t n, const double *population, const double *lb, const double *ub,
+                   const double *constraintValues, size_t numConstraints, double *phi) {
+        phiKernel(detectSimdLevel(), numIndividuals, n, population, lb, ub, constraintValues, numConstraints, phi);
+    }
+
+}
@@ -0,0 +1,84 @@
+#ifndef SRES_MUTATIONKERNEL_H
+#define SRES_MUTATIONKERNEL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace opt {
+
+    /**
+     * @brief instruction sets the mutation kernel has an implementation for
+     */
+    enum class SimdLevel {
+        Scalar,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * @brief the widest instruction set supported by this processor
+     * (and compiler). Detected once and cached.
+     */
+    SimdLevel detectSimdLevel();
+
+    /**
+     * @brief exp(@param x) for x clamped to [-708, 709].
+     * @details the same range reduction and polynomial as the vector
+     * kernels, with the operations in the same order, so all
+     * implementations of the kernel give bit identical results.
+     */
+    double kernelExp(double x);
+
+    /**
+     * @brief first attempt at mutating one individual, one lane per parameter.
+     * @details for every parameter j:
+     *
+     *     variance[j] = min(variance[j] * exp(v1Term + tau * varianceNormals[j]), maxVariance[j])
+     *     trial       = x[j] + variance[j] * stepNormals[j]
+     *
+     * when lb[j] <= trial <= ub[j] x[j] is set to trial and outOfBounds[j]
+     * to 0. Otherwise x[j] is left unchanged and outOfBounds[j] set to 1
+     * so the caller can retry those parameters.
+     * @returns the number of out of bounds parameters
+     */
+    size_t mutationKernel(size_t n, double *x, double *variance, const double *maxVariance,
+                          const double *lb, const double *ub, double v1Term, double tau,
+                          const double *varianceNormals, const double *stepNormals,
+                          std::uint8_t *outOfBounds);
+
+    /**
+     * @brief mutationKernel using the implementation for @param level,
+     * which must be supported by this processor. For testing and benchmarks.
+     */
+    size_t mutationKernel(SimdLevel level, size_t n, double *x, double *variance, const double *maxVariance,
+                          const double *lb, const double *ub, double v1Term, double tau,
+                          const double *varianceNormals, const double *stepNormals,
+                          std::uint8_t *outOfBounds);
+
+    /**
+     * @brief constraint violation (phi) of a block of individuals.
+     * @details for individual i, the row i of the row major
+     * @param numIndividuals x @param n matrix @param population:
+     *
+     *     phi[i] = sum_j (distance of x[j] to [lb[j], ub[j]])^2
+     *            + sum_k max(constraintValues[i][k], 0)^2
+     *
+     * @param constraintValues is a row major numIndividuals x
+     * @param numConstraints matrix of inequality constraints, satisfied
+     * when <= 0, and may be nullptr when numConstraints is 0. The bound
+     * terms are summed in the same order by every implementation so the
+     * result does not depend on the instruction set.
+     */
+    void phiKernel(size_t numIndividuals, size_t n, const double *population, const double *lb, const double *ub,
+                   const double *constraintValues, size_t numConstraints, double *phi);
+
+    /**
+     * @brief phiKernel using the implementation for @param level,
+     * which must be supported by this processor. For testing and benchmarks.
+     */
+    void phiKernel(SimdLevel level, size_t numIndividuals, size_t n, const double *population, const double *lb,
+                   const double *ub, const double *constraintValues, size_t numConstraints, double *phi);
+
+}
+
+#endif //SRES_MUTATIONKERNEL_H
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include "OptItems.h"
 #include "Error.h"
+#include "MutationKernel.h"
 
 namespace opt {
 
@@ -39,17 +40,82 @@ namespace opt {
         return optItems_.size();
     }
 
+    int OptItems::size() const {
+        return optItems_.size();
+    }
+
     std::vector<OptItem>::iterator OptItems::begin() {
+        dirty_ = true;
         return optItems_.begin();
     }
 
     std::vector<OptItem>::iterator OptItems::end() {
+        dirty_ = true;
         return optItems_.end();
     }
 
     OptItem &OptItems::operator[](int index) {
+        dirty_ = true;
         return optItems_[index];
     }
 
+    std::vector<OptItem>::const_iterator OptItems::begin() const {
+        return optItems_.begin();
+    }
+
+    std::vector<OptItem>::const_iterator OptItems::end() const {
+        return optItems_.end();
+    }
+
+    const OptItem &OptItems::operator[](int index) const {
+        return optItems_[index];
+    }
+
+    void OptItems::sync() const {
+        if (!dirty_)
+            return;
+        lb_.resize(optItems_.size());
+        ub_.resize(optItems_.size());
+        start_.resize(optItems_.size());
+        for (size_t i = 0; i < optItems_.size(); i++) {
+            lb_[i] = optItems_[i].getLb();
+            ub_[i] = optItems_[i].getUb();
+            start_[i] = optItems_[i].getStartingValue();
+        }
+        dirty_ = false;
+    }
+
+    const std::vector<double> &OptItems::lb() const {
+        sync();
+        return lb_;
+    }
+
+    const std::vector<double> &OptItems::ub() const {
+        sync();
+        return ub_;
+    }
+
+    const std::vector<double> &OptItems::start() const {
+        sync();
+        return start_;
+    }
+
+    void OptItems::checkConstraints(const double *x, std::int8_t *out) const {
+        sync();
+        const double *lb = lb_.data();
+        const double *ub = ub_.data();
+        // branch free so the compares vectorize
+        for (size_t i = 0; i < lb_.size(); i++)
+            out[i] = std::int8_t((x[i] > ub[i]) - (lb[i] > x[i]));
+    }
+
+    double OptItems::violation(const double *x) const {
+        sync();
+        // the same kernel SRES ranks its population with
+        double sum;
+        phiKernel(1, lb_.size(), x, lb_.data(), ub_.data(), nullptr, 0, &sum);
+        return sum;
+    }
+
 }
 
@@ -5,6 +5,7 @@
 #ifndef SRES_OPTITEMS_H
 #define SRES_OPTITEMS_H
 
+#include <cstdint>
 #include <vector>
 #include "OptItem.h"
 
@@ -23,16 +24,72 @@ namespace opt {
 
         int size();
 
+        [[nodiscard]] int size() const;
+
+        /**
+         * @brief non const access to the items. Marks the
+         * contiguous bound arrays as needing to be rebuilt.
+         */
         std::vector<OptItem>::iterator begin();
 
         std::vector<OptItem>::iterator end();
 
         OptItem& operator[](int index);
 
+        [[nodiscard]] std::vector<OptItem>::const_iterator begin() const;
+
+        [[nodiscard]] std::vector<OptItem>::const_iterator end() const;
+
+        const OptItem& operator[](int index) const;
+
+        /**
+         * @brief lower bound of every item, contiguous.
+         * @details the lb, ub and start arrays are rebuilt from the items
+         * on first use after any non const access to the items. Items must
+         * not be modified while other threads read the arrays.
+         */
+        [[nodiscard]] const std::vector<double> &lb() const;
+
+        /**
+         * @brief upper bound of every item, contiguous. @see lb
+         */
+        [[nodiscard]] const std::vector<double> &ub() const;
+
+        /**
+         * @brief starting value of every item, contiguous. @see lb
+         */
+        [[nodiscard]] const std::vector<double> &start() const;
+
+        /**
+         * @brief OptItem::checkConstraint for every item at once.
+         * @details out[i] is -1 when @param x[i] is below the lower bound
+         * of item i, 1 when above the upper bound and 0 otherwise.
+         */
+        void checkConstraints(const double *x, std::int8_t *out) const;
+
+        /**
+         * @brief sum of the squared distances of @param x
+         * to the bounds it falls outside of. 0 when x is feasible.
+         */
+        [[nodiscard]] double violation(const double *x) const;
+
     private:
 
+        /**
+         * @brief rebuild the contiguous arrays if the items may have changed
+         */
+        void sync() const;
+
         std::vector<OptItem> optItems_;
 
+        mutable std::vector<double> lb_;
+
+        mutable std::vector<double> ub_;
+
+        mutable std::vector<double> start_;
+
+        mutable bool dirty_ = true;
+
     };
 }
 
@@ -21,6 +21,13 @@ namespace opt {
             optItems_(std::move(optItems)),
             numberOfParameters_(optItems.size()) {}
 
+    Optimizer::Optimizer(
+            opt::BatchCostFunction batchCost, const std::vector<double> &startingValues,
+            const std::vector<double> &lb, const std::vector<double> &ub)
+            : batchCost_(batchCost),
+              optItems_(OptItems(startingValues, lb, ub)),
+              numberOfParameters_(startingValues.size()) {}
+
     CostFunction Optimizer::getCost() const {
         return cost_;
     }
@@ -29,6 +36,14 @@ namespace opt {
         cost_ = cost;
     }
 
+    BatchCostFunction Optimizer::getBatchCost() const {
+        return batchCost_;
+    }
+
+    void Optimizer::setBatchCost(BatchCostFunction batchCost) {
+        batchCost_ = batchCost;
+    }
+
     const OptItems &Optimizer::getOptItems() const {
         return optItems_;
     }
@@ -38,7 +53,11 @@ namespace opt {
     }
 
     void Optimizer::setSeed(unsigned long long int seed) {
-        RandomNumberGenerator::getInstance().setSeed(seed);
+        rng_.setSeed(seed);
+    }
+
+    unsigned long long int Optimizer::getSeed() const {
+        return rng_.getSeed();
     }
 
     bool Optimizer::setSolution(const double &value,
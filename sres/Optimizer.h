@@ -6,6 +6,7 @@
 #define SRES_OPTIMIZER_H
 
 #include "OptItems.h"
+#include "PopulationMatrix.h"
 #include "RandomNumberGenerator.h"
 
 /*
@@ -19,9 +20,6 @@
 
 namespace opt {
 
-    using DoubleMatrix = std::vector<std::vector<double>>;
-    using DoubleVector = std::vector<double>;
-
     /**
      * @brief cost function with signature for parameters (to estimate).
      * @param individual or genome. This is a double vector representing candiate parameters
@@ -29,6 +27,17 @@ namespace opt {
      */
     typedef double(*CostFunction)(double *);
 
+    /**
+     * @brief cost function that evaluates a whole block of individuals in one call.
+     * @param population contiguous row major matrix of numIndividuals x numParameters
+     * candidate parameters, i.e. individual i starts at population[i * numParameters].
+     * @param numIndividuals number of rows in population
+     * @param numParameters number of columns in population
+     * @param fitness output array of size numIndividuals. The callee writes the
+     * fitness of row i to fitness[i].
+     */
+    typedef void(*BatchCostFunction)(double *population, int numIndividuals, int numParameters, double *fitness);
+
 
     /**
      * @brief base class for optimization algorithms.
@@ -75,6 +84,16 @@ namespace opt {
          */
         Optimizer(CostFunction cost, OptItems optItems);
 
+        /**
+         * @brief construct an Optimizer that evaluates blocks
+         * of individuals with a single call to @param batchCost.
+         * Otherwise the same as the CostFunction overload.
+         */
+        Optimizer(
+                BatchCostFunction batchCost, const DoubleVector &startingValues,
+                const DoubleVector &lb, const DoubleVector &ub
+        );
+
         /**
          * @brief getter for OptItems instance
          */
@@ -95,8 +114,27 @@ namespace opt {
          */
         void setCost(CostFunction cost);
 
+        /**
+         * @brief getter for batch cost function
+         */
+        [[nodiscard]] BatchCostFunction getBatchCost() const;
+
+        /**
+         * @brief setter for batch cost function. When set it
+         * takes precedence over the per individual cost function.
+         */
+        void setBatchCost(BatchCostFunction batchCost);
+
+        /**
+         * @brief seed the random number generator owned by
+         * this optimizer. Optimizers with the same seed draw the
+         * same random numbers, independent of any other optimizer
+         * in the process.
+         */
         void setSeed(unsigned long long int seed);
 
+        [[nodiscard]] unsigned long long int getSeed() const;
+
         bool setSolution(const double &value, const std::vector<double> &variables);
 
         std::vector<double> getHallOfFame();
@@ -135,6 +173,12 @@ namespace opt {
          */
         double bestFitnessValue_ = 10000000.0;
 
+        /**
+         * @brief cost function that evaluates many individuals
+         * per call. nullptr unless the optimizer was built with one.
+         */
+        BatchCostFunction batchCost_ = nullptr;
+
         /**
          * @brief optimization items. Defines the fitting start
          * values as well as lower and upper bounds. Also
@@ -147,7 +191,7 @@ namespace opt {
          * values to try and the output are the fitness values of
          * those parameters.
          */
-        CostFunction cost_; // way to inject cost function from Python
+        CostFunction cost_ = nullptr; // way to inject cost function from Python
 
         /**
          * @brief how many parameters are in the estimation problem.
@@ -156,6 +200,15 @@ namespace opt {
          */
         int numberOfParameters_; // number of parameters to estimate
 
+        /**
+         * @brief random number generator owned by this optimizer.
+         * @details algorithms draw from substreams of this generator
+         * (see RandomNumberGenerator::substream) so that the numbers
+         * drawn for one individual do not depend on the order in
+         * which individuals are processed.
+         */
+        RandomNumberGenerator rng_;
+
 
 
     };
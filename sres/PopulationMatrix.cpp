@@ -0,0 +1,96 @@
+#include "PopulationMatrix.h"
+#include "Error.h"
+
+namespace opt {
+
+    PopulationMatrix::PopulationMatrix(std::size_t rows, std::size_t cols, Layout layout)
+            : rows_(rows), cols_(cols), layout_(layout), data_(rows * cols) {}
+
+    PopulationMatrix::PopulationMatrix(const DoubleMatrix &matrix, Layout layout)
+            : layout_(layout) {
+        fromDoubleMatrix(matrix);
+    }
+
+    void PopulationMatrix::resize(std::size_t rows, std::size_t cols) {
+        rows_ = rows;
+        cols_ = cols;
+        data_.resize(rows * cols);
+    }
+
+    std::size_t PopulationMatrix::rows() const {
+        return rows_;
+    }
+
+    std::size_t PopulationMatrix::cols() const {
+        return cols_;
+    }
+
+    std::size_t PopulationMatrix::size() const {
+        return rows_;
+    }
+
+    PopulationMatrix::Layout PopulationMatrix::getLayout() const {
+        return layout_;
+    }
+
+    std::size_t PopulationMatrix::rowStride() const {
+        return layout_ == RowMajor ? cols_ : 1;
+    }
+
+    std::size_t PopulationMatrix::colStride() const {
+        return layout_ == RowMajor ? 1 : rows_;
+    }
+
+    double &PopulationMatrix::operator()(std::size_t i, std::size_t j) {
+        return data_[i * rowStride() + j * colStride()];
+    }
+
+    const double &PopulationMatrix::operator()(std::size_t i, std::size_t j) const {
+        return data_[i * rowStride() + j * colStride()];
+    }
+
+    RowView<double> PopulationMatrix::operator[](std::size_t i) {
+        return {data_.data() + i * rowStride(), cols_, colStride()};
+    }
+
+    RowView<const double> PopulationMatrix::operator[](std::size_t i) const {
+        return {data_.data() + i * rowStride(), cols_, colStride()};
+    }
+
+    double *PopulationMatrix::data() {
+        return data_.data();
+    }
+
+    const double *PopulationMatrix::data() const {
+        return data_.data();
+    }
+
+    DoubleMatrix PopulationMatrix::toDoubleMatrix() const {
+        DoubleMatrix matrix(rows_);
+        for (std::size_t i = 0; i < rows_; i++)
+            matrix[i] = (*this)[i].toVector();
+        return matrix;
+    }
+
+    void PopulationMatrix::fromDoubleMatrix(const DoubleMatrix &matrix) {
+        std::size_t cols = matrix.empty() ? 0 : matrix[0].size();
+        for (const auto &row: matrix) {
+            if (row.size() != cols) {
+                INVALID_ARGUMENT_ERROR << "All rows of a PopulationMatrix must have the same size. Expected "
+                                       << cols << " but got a row of size " << row.size() << std::endl;
+            }
+        }
+        resize(matrix.size(), cols);
+        for (std::size_t i = 0; i < rows_; i++)
+            for (std::size_t j = 0; j < cols_; j++)
+                (*this)(i, j) = matrix[i][j];
+    }
+
+    void PopulationMatrix::swap(PopulationMatrix &other) noexcept {
+        std::swap(rows_, other.rows_);
+        std::swap(cols_, other.cols_);
+        std::swap(layout_, other.layout_);
+        data_.swap(other.data_);
+    }
+
+}
@@ -0,0 +1,228 @@
+#ifndef SRES_POPULATIONMATRIX_H
+#define SRES_POPULATIONMATRIX_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <new>
+#include <vector>
+
+namespace opt {
+
+    using DoubleMatrix = std::vector<std::vector<double>>;
+    using DoubleVector = std::vector<double>;
+
+    /**
+     * @brief allocator returning memory aligned to @tparam Alignment
+     * bytes, so that rows of a PopulationMatrix start on a cache line
+     * and can be loaded with aligned SIMD instructions.
+     */
+    template<class T, std::size_t Alignment = 64>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        template<class U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() = default;
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+        T *allocate(std::size_t n) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T *p, std::size_t) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+        template<class U>
+        bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+
+        template<class U>
+        bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+    };
+
+    /**
+     * @brief iterator over every stride'th element of a buffer.
+     * Used to walk a row of a column major matrix.
+     */
+    template<class T>
+    class StridedIterator {
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_const_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *;
+        using reference = T &;
+
+        StridedIterator(T *ptr, std::size_t stride) : ptr_(ptr), stride_(stride) {}
+
+        reference operator*() const { return *ptr_; }
+
+        StridedIterator &operator++() {
+            ptr_ += stride_;
+            return *this;
+        }
+
+        StridedIterator operator++(int) {
+            StridedIterator tmp = *this;
+            ptr_ += stride_;
+            return tmp;
+        }
+
+        bool operator==(const StridedIterator &other) const { return ptr_ == other.ptr_; }
+
+        bool operator!=(const StridedIterator &other) const { return ptr_ != other.ptr_; }
+
+    private:
+        T *ptr_;
+        std::size_t stride_;
+    };
+
+    /**
+     * @brief lightweight, non owning view of one row (individual)
+     * of a PopulationMatrix. Stays valid until the matrix is resized.
+     */
+    template<class T>
+    class RowView {
+
+    public:
+        using iterator = StridedIterator<T>;
+
+        RowView(T *data, std::size_t size, std::size_t stride)
+                : data_(data), size_(size), stride_(stride) {}
+
+        T &operator[](std::size_t j) const { return data_[j * stride_]; }
+
+        [[nodiscard]] std::size_t size() const { return size_; }
+
+        /**
+         * @brief pointer to the first element. The elements are only
+         * contiguous when the matrix is row major, @see isContiguous.
+         */
+        T *data() const { return data_; }
+
+        [[nodiscard]] bool isContiguous() const { return stride_ == 1; }
+
+        iterator begin() const { return iterator(data_, stride_); }
+
+        iterator end() const { return iterator(data_ + size_ * stride_, stride_); }
+
+        /**
+         * @brief copy of the row as a std::vector
+         */
+        [[nodiscard]] DoubleVector toVector() const { return DoubleVector(begin(), end()); }
+
+        /**
+         * @brief overwrite the elements of this row with @param other
+         * which must have the same size.
+         */
+        template<class U>
+        void assign(const RowView<U> &other) const {
+            for (std::size_t j = 0; j < size_; j++)
+                (*this)[j] = other[j];
+        }
+
+    private:
+        T *data_;
+        std::size_t size_;
+        std::size_t stride_;
+    };
+
+    /**
+     * @brief Dense rows x cols matrix of doubles held in a single
+     * aligned buffer. Rows are individuals and columns parameters.
+     * @details Replaces a std::vector<std::vector<double>> so that a
+     * population is one allocation rather than one per individual.
+     * In the default row major layout a block of consecutive individuals
+     * is itself a contiguous row major matrix which can be handed to a
+     * BatchCostFunction without copying. A column major layout, where
+     * each parameter is contiguous across individuals, is also available.
+     */
+    class PopulationMatrix {
+
+    public:
+
+        enum Layout {
+            RowMajor,
+            ColumnMajor
+        };
+
+        PopulationMatrix() = default;
+
+        PopulationMatrix(std::size_t rows, std::size_t cols, Layout layout = RowMajor);
+
+        /**
+         * @brief construct from nested vectors. All rows must have the same size.
+         */
+        explicit PopulationMatrix(const DoubleMatrix &matrix, Layout layout = RowMajor);
+
+        /**
+         * @brief change the shape of the matrix. Existing values are not preserved.
+         */
+        void resize(std::size_t rows, std::size_t cols);
+
+        [[nodiscard]] std::size_t rows() const;
+
+        [[nodiscard]] std::size_t cols() const;
+
+        [[nodiscard]] std::size_t size() const;
+
+        [[nodiscard]] Layout getLayout() const;
+
+        double &operator()(std::size_t i, std::size_t j);
+
+        const double &operator()(std::size_t i, std::size_t j) const;
+
+        /**
+         * @brief view of row @param i
+         */
+        RowView<double> operator[](std::size_t i);
+
+        RowView<const double> operator[](std::size_t i) const;
+
+        /**
+         * @brief start of the underlying buffer
+         */
+        double *data();
+
+        [[nodiscard]] const double *data() const;
+
+        /**
+         * @brief copy of the matrix as nested vectors
+         */
+        [[nodiscard]] DoubleMatrix toDoubleMatrix() const;
+
+        /**
+         * @brief replace the contents (and shape) with @param matrix
+         */
+        void fromDoubleMatrix(const DoubleMatrix &matrix);
+
+        /**
+         * @brief exchange buffers with @param other in constant time
+         */
+        void swap(PopulationMatrix &other) noexcept;
+
+    private:
+
+        [[nodiscard]] std::size_t rowStride() const;
+
+        [[nodiscard]] std::size_t colStride() const;
+
+        std::size_t rows_ = 0;
+
+        std::size_t cols_ = 0;
+
+        Layout layout_ = RowMajor;
+
+        std::vector<double, AlignedAllocator<double>> data_;
+    };
+
+}
+
+#endif //SRES_POPULATIONMATRIX_H
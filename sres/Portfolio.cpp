@@ -0,0 +1,261 @@
+#include "Portfolio.h"
+#include "Error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace opt {
+
+    namespace {
+
+        /**
+         * @brief negative if @param a ranks above @param b, 0 if they tie
+         * and positive otherwise. Feasible individuals rank above infeasible
+         * ones, which rank by their violation like SRES::rankParents().
+         */
+        int compareIndividuals(const Individual &a, const Individual &b) {
+            if ((a.phi == 0) != (b.phi == 0))
+                return a.phi == 0 ? -1 : 1;
+            double x = a.phi == 0 ? a.fitness : a.phi;
+            double y = b.phi == 0 ? b.fitness : b.phi;
+            return x < y ? -1 : (y < x ? 1 : 0);
+        }
+
+        /**
+         * @brief one sided p-value of a Mann-Whitney U test of the hypothesis
+         * that @param leader ranks above @param other, using the normal
+         * approximation. Small values mean other is dominated by leader.
+         */
+        double dominancePValue(const std::vector<Individual> &leader, const std::vector<Individual> &other) {
+            double u = 0.0;
+            for (const Individual &a: leader) {
+                for (const Individual &b: other) {
+                    int order = compareIndividuals(a, b);
+                    u += order < 0 ? 1.0 : (order == 0 ? 0.5 : 0.0);
+                }
+            }
+            auto m = (double) leader.size();
+            auto n = (double) other.size();
+            double z = (u - m * n / 2.0) / std::sqrt(m * n * (m + n + 1.0) / 12.0);
+            return 0.5 * std::erfc(z / std::sqrt(2.0));
+        }
+
+    }
+
+    Portfolio::Portfolio(CostFunction cost, int numRuns, int populationSize, int numGenerations,
+                         const DoubleVector &startingValues, const DoubleVector &lb,
+                         const DoubleVector &ub, int childrate)
+            : numThreads_((int) std::max(1u, std::thread::hardware_concurrency())),
+              seed_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {
+        if (numRuns < 1) {
+            INVALID_ARGUMENT_ERROR << "A portfolio needs at least one run, got " << numRuns << std::endl;
+        }
+        runs_.reserve(numRuns);
+        for (int i = 0; i < numRuns; i++)
+            runs_.push_back(std::make_unique<SRES>(
+                    cost, populationSize, numGenerations, startingValues, lb, ub, childrate));
+        setSeed(seed_);
+    }
+
+    Portfolio::Portfolio(BatchCostFunction batchCost, int numRuns, int populationSize, int numGenerations,
+                         const DoubleVector &startingValues, const DoubleVector &lb,
+                         const DoubleVector &ub, int childrate)
+            : Portfolio((CostFunction) nullptr, numRuns, populationSize, numGenerations,
+                        startingValues, lb, ub, childrate) {
+        for (auto &run: runs_)
+            run->setBatchCost(batchCost);
+    }
+
+    int Portfolio::getNumRuns() const {
+        return (int) runs_.size();
+    }
+
+    SRES &Portfolio::getRun(int i) {
+        if (i < 0 || i >= getNumRuns()) {
+            INVALID_ARGUMENT_ERROR << "Run " << i << " does not exist. There are "
+                                   << getNumRuns() << " runs" << std::endl;
+        }
+        return *runs_[i];
+    }
+
+    int Portfolio::getNumThreads() const {
+        return numThreads_;
+    }
+
+    void Portfolio::setNumThreads(int numThreads) {
+        numThreads_ = numThreads < 1 ? 1 : numThreads;
+        threadPool_.reset();
+    }
+
+    unsigned long long Portfolio::getSeed() const {
+        return seed_;
+    }
+
+    void Portfolio::setSeed(unsigned long long seed) {
+        seed_ = seed;
+        for (size_t i = 0; i < runs_.size(); i++)
+            runs_[i]->setSeed(RandomNumberGenerator::deriveSeed(seed, i));
+    }
+
+    int Portfolio::getRungInterval() const {
+        return rungInterval_;
+    }
+
+    void Portfolio::setRungInterval(int rungInterval) {
+        if (rungInterval < 0) {
+            INVALID_ARGUMENT_ERROR << "The rung interval cannot be negative, got " << rungInterval << std::endl;
+        }
+        rungInterval_ = rungInterval;
+    }
+
+    double Portfolio::getReductionFactor() const {
+        return reductionFactor_;
+    }
+
+    void Portfolio::setReductionFactor(double reductionFactor) {
+        if (!(reductionFactor > 1.0)) {
+            INVALID_ARGUMENT_ERROR << "The reduction factor must be greater than 1, got "
+                                   << reductionFactor << std::endl;
+        }
+        reductionFactor_ = reductionFactor;
+    }
+
+    int Portfolio::getMinRuns() const {
+        return minRuns_;
+    }
+
+    void Portfolio::setMinRuns(int minRuns) {
+        if (minRuns < 1) {
+            INVALID_ARGUMENT_ERROR << "At least one run must be kept, got " << minRuns << std::endl;
+        }
+        minRuns_ = minRuns;
+    }
+
+    double Portfolio::getSignificance() const {
+        return significance_;
+    }
+
+    void Portfolio::setSignificance(double significance) {
+        if (!(significance > 0.0 && significance < 1.0)) {
+            INVALID_ARGUMENT_ERROR << "The significance must be between 0 and 1, got " << significance << std::endl;
+        }
+        significance_ = significance;
+    }
+
+    void Portfolio::setStopAfterStalledGenerations(unsigned int stopAfterStalledGenerations) {
+        for (auto &run: runs_)
+            run->setStopAfterStalledGenerations(stopAfterStalledGenerations);
+    }
+
+    const std::vector<PortfolioResult> &Portfolio::getResults() const {
+        return results_;
+    }
+
+    int Portfolio::getBestRun() const {
+        return bestRun_;
+    }
+
+    double Portfolio::getBestFitnessValue() const {
+        return runs_[bestRun_]->getBestFitnessValue();
+    }
+
+    const DoubleVector &Portfolio::getSolutionValues() const {
+        return runs_[bestRun_]->getSolutionValues();
+    }
+
+    void Portfolio::cancelLosingRuns() {
+        if (active_.size() <= (size_t) minRuns_)
+            return;
+
+        auto keep = (size_t) std::ceil((double) active_.size() / reductionFactor_);
+        keep = std::max(keep, (size_t) minRuns_);
+        if (keep >= active_.size())
+            return;
+
+        // ties go to the run seeded first, so the outcome is reproducible
+        std::stable_sort(active_.begin(), active_.end(), [this](size_t a, size_t b) {
+            return runs_[a]->getBestFitnessValue() < runs_[b]->getBestFitnessValue();
+        });
+
+        // race every run against the leader, worst first so
+        // that the better dominated runs are the ones kept
+        std::vector<Individual> leader = runs_[active_[0]]->getBestIndividuals(std::numeric_limits<size_t>::max());
+        size_t numLeft = active_.size();
+        long long freed = 0;
+        for (size_t k = active_.size() - 1; k > 0 && numLeft > keep; k--) {
+            SRES &run = *runs_[active_[k]];
+            if (dominancePValue(leader, run.getBestIndividuals(std::numeric_limits<size_t>::max())) >= significance_)
+                continue;
+            freed += std::max(0, run.getNumGenerations() - run.getCurrentGeneration());
+            cancelled_[active_[k]] = true;
+            numLeft--;
+        }
+        if (numLeft == active_.size())
+            return;
+        active_.erase(std::remove_if(active_.begin(), active_.end(), [this](size_t i) {
+            return cancelled_[i];
+        }), active_.end());
+
+        // the best runs get any remainder
+        auto numSurvivors = (long long) active_.size();
+        for (size_t k = 0; k < active_.size(); k++) {
+            long long share = freed / numSurvivors + ((long long) k < freed % numSurvivors ? 1 : 0);
+            SRES &run = *runs_[active_[k]];
+            run.setNumGenerations((int) std::min<long long>(
+                    run.getNumGenerations() + share, std::numeric_limits<int>::max()));
+        }
+        std::sort(active_.begin(), active_.end());
+    }
+
+    bool Portfolio::fit() {
+        active_.clear();
+        cancelled_.assign(runs_.size(), false);
+        // cancelLosingRuns() moves generations between runs, so
+        // remember each run's own budget to restore afterwards
+        std::vector<int> numGenerations(runs_.size());
+        for (size_t i = 0; i < runs_.size(); i++) {
+            runs_[i]->restart();
+            numGenerations[i] = runs_[i]->getNumGenerations();
+            active_.push_back(i);
+        }
+
+        if (numThreads_ > 1 && !threadPool_)
+            threadPool_ = std::make_shared<ThreadPool>(numThreads_);
+        // the runs share the pool by being stepped on it
+        // concurrently, so each of them evaluates serially
+        for (auto &run: runs_)
+            run->setThreadPool(nullptr);
+
+        int generations = rungInterval_ > 0 ? rungInterval_ : std::numeric_limits<int>::max();
+        while (!active_.empty()) {
+            auto stepRun = [this, generations](size_t k) { runs_[active_[k]]->step(generations); };
+            if (threadPool_) {
+                threadPool_->parallelFor(0, active_.size(), stepRun);
+            } else {
+                for (size_t k = 0; k < active_.size(); k++)
+                    stepRun(k);
+            }
+
+            active_.erase(std::remove_if(active_.begin(), active_.end(), [this](size_t i) {
+                return runs_[i]->isFinished() || runs_[i]->isCancelled();
+            }), active_.end());
+
+            if (rungInterval_ > 0)
+                cancelLosingRuns();
+        }
+
+        results_.clear();
+        bestRun_ = 0;
+        for (size_t i = 0; i < runs_.size(); i++) {
+            SRES &run = *runs_[i];
+            results_.push_back({run.getSeed(), run.getBestFitnessValue(), run.getSolutionValues(),
+                                run.getHallOfFame(), run.getCurrentGeneration(), (bool) cancelled_[i]});
+            if (run.getBestFitnessValue() < runs_[bestRun_]->getBestFitnessValue())
+                bestRun_ = (int) i;
+            run.setNumGenerations(numGenerations[i]);
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,176 @@
+#ifndef SRES_PORTFOLIO_H
+#define SRES_PORTFOLIO_H
+
+#include <memory>
+#include <vector>
+#include "SRES.h"
+#include "ThreadPool.h"
+
+namespace opt {
+
+    /**
+     * @brief outcome of one run of a Portfolio
+     */
+    struct PortfolioResult {
+        unsigned long long seed;
+        double bestFitness;
+        DoubleVector solutionValues;
+        DoubleVector hallOfFame;
+
+        /**
+         * @brief generations the run completed
+         */
+        int numGenerations;
+
+        /**
+         * @brief true if the run was stopped early because
+         * other runs of the portfolio were doing better
+         */
+        bool cancelled;
+    };
+
+    /**
+     * @brief runs several independently seeded SRES fits of the same
+     * problem concurrently and keeps the best.
+     * @details Run i is seeded with RandomNumberGenerator::deriveSeed(seed, i).
+     * Runs are stepped concurrently on a shared thread pool, rungInterval
+     * generations at a time, each evaluating its candidates on the thread
+     * it is stepped on. After each rung the runs still going are raced
+     * against the one with the best fitness: a run is cancelled when a one
+     * sided Mann-Whitney U test over the ranks of their parents says it is
+     * statistically dominated by the leader at the configured significance. As in successive halving,
+     * at most all but 1 / reductionFactor of the runs, and never the last
+     * minRuns, are cancelled per rung, the worst first. The generations a
+     * cancelled run had left are shared out between the surviving runs, so
+     * the total number of generations the portfolio may spend stays the
+     * same. Setting the rung interval to 0 disables cancellation and every
+     * run goes to completion. For a given seed, results do not depend on
+     * the number of threads.
+     */
+    class Portfolio {
+
+    public:
+
+        Portfolio(CostFunction cost, int numRuns, int populationSize, int numGenerations,
+                  const DoubleVector &startingValues, const DoubleVector &lb,
+                  const DoubleVector &ub, int childrate = 7);
+
+        Portfolio(BatchCostFunction batchCost, int numRuns, int populationSize, int numGenerations,
+                  const DoubleVector &startingValues, const DoubleVector &lb,
+                  const DoubleVector &ub, int childrate = 7);
+
+        /**
+         * @brief run the portfolio, cancelling losing runs as configured
+         */
+        bool fit();
+
+        [[nodiscard]] int getNumRuns() const;
+
+        /**
+         * @brief run @param i, for example to configure its pf
+         * or stopping criteria before fit() is called
+         * @details fit() makes it evaluate serially, the portfolio's
+         * threads being spent on stepping the runs concurrently.
+         */
+        SRES &getRun(int i);
+
+        [[nodiscard]] int getNumThreads() const;
+
+        /**
+         * @brief number of threads the runs are stepped on. Defaults to
+         * the number of hardware threads. The cost function must be thread
+         * safe when this is greater than 1.
+         */
+        void setNumThreads(int numThreads);
+
+        [[nodiscard]] unsigned long long getSeed() const;
+
+        void setSeed(unsigned long long seed);
+
+        [[nodiscard]] int getRungInterval() const;
+
+        /**
+         * @brief number of generations between rounds of cancellation.
+         * 0 disables cancellation.
+         */
+        void setRungInterval(int rungInterval);
+
+        [[nodiscard]] double getReductionFactor() const;
+
+        /**
+         * @brief each round of cancellation keeps at least
+         * 1 / @param reductionFactor of the runs still going
+         */
+        void setReductionFactor(double reductionFactor);
+
+        [[nodiscard]] double getSignificance() const;
+
+        /**
+         * @brief a run is cancelled when the test that it is dominated by
+         * the leader has a p-value below @param significance. Defaults to 0.05.
+         */
+        void setSignificance(double significance);
+
+        [[nodiscard]] int getMinRuns() const;
+
+        /**
+         * @brief runs are not cancelled once
+         * only @param minRuns are still going
+         */
+        void setMinRuns(int minRuns);
+
+        /**
+         * @brief the stopping criteria of every run
+         */
+        void setStopAfterStalledGenerations(unsigned int stopAfterStalledGenerations);
+
+        /**
+         * @brief one result per run, in the order the runs were seeded
+         */
+        [[nodiscard]] const std::vector<PortfolioResult> &getResults() const;
+
+        [[nodiscard]] int getBestRun() const;
+
+        [[nodiscard]] double getBestFitnessValue() const;
+
+        [[nodiscard]] const DoubleVector &getSolutionValues() const;
+
+    private:
+
+        /**
+         * @brief cancel the active runs dominated by the best one and
+         * give their remaining generations to the others
+         */
+        void cancelLosingRuns();
+
+        std::vector<std::unique_ptr<SRES>> runs_;
+
+        /**
+         * @brief indices of the runs which are neither finished nor cancelled
+         */
+        std::vector<size_t> active_;
+
+        std::vector<bool> cancelled_;
+
+        std::vector<PortfolioResult> results_;
+
+        int numThreads_;
+
+        unsigned long long seed_;
+
+        int rungInterval_ = 10;
+
+        double reductionFactor_ = 2.0;
+
+        int minRuns_ = 1;
+
+        double significance_ = 0.05;
+
+        int bestRun_ = 0;
+
+        std::shared_ptr<ThreadPool> threadPool_;
+    };
+
+}
+
+#endif //SRES_PORTFOLIO_H
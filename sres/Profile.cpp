@@ -0,0 +1,146 @@
+#include <algorithm>
+#include "Profile.h"
+
+namespace opt {
+
+    namespace {
+        unsigned highestBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63u - (unsigned) __builtin_clzll(value);
+#else
+            unsigned bit = 0;
+            while (value >>= 1)
+                bit++;
+            return bit;
+#endif
+        }
+
+        double toSeconds(std::uint64_t nanoseconds) {
+            return (double) nanoseconds * 1e-9;
+        }
+    }
+
+    size_t LatencyHistogram::bucketIndex(std::uint64_t nanoseconds) {
+        if (nanoseconds < NumSubBuckets)
+            return (size_t) nanoseconds;
+        unsigned exponent = highestBit(nanoseconds);
+        size_t subBucket = (nanoseconds >> (exponent - SubBucketBits)) & (NumSubBuckets - 1);
+        return (exponent - SubBucketBits + 1) * NumSubBuckets + subBucket;
+    }
+
+    std::uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+        if (index < NumSubBuckets)
+            return index;
+        unsigned shift = (unsigned) (index / NumSubBuckets) - 1;
+        std::uint64_t subBucket = index % NumSubBuckets;
+        std::uint64_t lower = (NumSubBuckets + subBucket) << shift;
+        return lower + ((std::uint64_t(1) << shift) - 1);
+    }
+
+    void LatencyHistogram::record(std::uint64_t nanoseconds) {
+        record(nanoseconds, 1);
+    }
+
+    void LatencyHistogram::record(std::uint64_t nanoseconds, std::uint64_t count) {
+        if (count == 0)
+            return;
+        counts_[bucketIndex(nanoseconds)].fetch_add(count, std::memory_order_relaxed);
+        count_.fetch_add(count, std::memory_order_relaxed);
+        sum_.fetch_add(nanoseconds * count, std::memory_order_relaxed);
+
+        std::uint64_t current = min_.load(std::memory_order_relaxed);
+        while (nanoseconds < current && !min_.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed));
+        current = max_.load(std::memory_order_relaxed);
+        while (nanoseconds > current && !max_.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed));
+    }
+
+    std::uint64_t LatencyHistogram::getCount() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t LatencyHistogram::getMin() const {
+        return getCount() ? min_.load(std::memory_order_relaxed) : 0;
+    }
+
+    std::uint64_t LatencyHistogram::getMax() const {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    double LatencyHistogram::getMean() const {
+        std::uint64_t count = getCount();
+        return count ? (double) sum_.load(std::memory_order_relaxed) / (double) count : 0.0;
+    }
+
+    std::uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+        std::uint64_t count = getCount();
+        if (count == 0)
+            return 0;
+        // the rank of the value wanted, at least the first
+        auto rank = (std::uint64_t) (percentile / 100.0 * (double) count + 0.5);
+        if (rank < 1)
+            rank = 1;
+        std::uint64_t seen = 0;
+        for (size_t i = 0; i < NumBuckets; i++) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return std::min(bucketUpperBound(i), getMax());
+        }
+        return getMax();
+    }
+
+    void LatencyHistogram::reset() {
+        for (auto &count: counts_)
+            count.store(0, std::memory_order_relaxed);
+        count_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        min_.store(UINT64_MAX, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    void Profiler::add(Phase phase, Clock::duration duration) {
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        phaseNanoseconds_[phase].fetch_add((std::uint64_t) nanoseconds, std::memory_order_relaxed);
+    }
+
+    void Profiler::addCostCall(Clock::duration duration, size_t numIndividuals) {
+        if (numIndividuals == 0)
+            return;
+        auto nanoseconds = (std::uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        costLatency_.record(nanoseconds / numIndividuals, numIndividuals);
+    }
+
+    const LatencyHistogram &Profiler::getCostLatency() const {
+        return costLatency_;
+    }
+
+    Profile Profiler::getProfile() const {
+        auto phase = [this](Phase p) {
+            return toSeconds(phaseNanoseconds_[p].load(std::memory_order_relaxed));
+        };
+        Profile profile{};
+        profile.enabled = 1;
+        profile.replicateSeconds = phase(Replicate);
+        profile.mutateSeconds = phase(Mutate);
+        profile.mutateRngSeconds = phase(MutateRng);
+        profile.mutateKernelSeconds = phase(MutateKernel);
+        profile.mutateBoundRetrySeconds = phase(MutateBoundRetry);
+        profile.evaluateSeconds = phase(Evaluate);
+        profile.selectSeconds = phase(Select);
+        profile.findBestIndividualSeconds = phase(FindBestIndividual);
+        profile.numCostCalls = costLatency_.getCount();
+        profile.costCallMeanSeconds = costLatency_.getMean() * 1e-9;
+        profile.costCallMinSeconds = toSeconds(costLatency_.getMin());
+        profile.costCallP50Seconds = toSeconds(costLatency_.getValueAtPercentile(50));
+        profile.costCallP90Seconds = toSeconds(costLatency_.getValueAtPercentile(90));
+        profile.costCallP99Seconds = toSeconds(costLatency_.getValueAtPercentile(99));
+        profile.costCallMaxSeconds = toSeconds(costLatency_.getMax());
+        return profile;
+    }
+
+    void Profiler::reset() {
+        for (auto &nanoseconds: phaseNanoseconds_)
+            nanoseconds.store(0, std::memory_order_relaxed);
+        costLatency_.reset();
+    }
+
+}
@@ -0,0 +1,256 @@
+#ifndef SRES_PROFILE_H
+#define SRES_PROFILE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace opt {
+
+    /**
+     * @brief where the time of a run went, returned by
+     * EvolutionaryOptimizer::getProfile().
+     * @details plain data so that it can be read from C and Python.
+     * Phases marked wall time are measured around the whole phase on the
+     * optimizer thread. The parts of the mutation are summed over the
+     * children, which may be mutated on several threads, so they can add
+     * up to more than the wall time of mutate. Cost function latencies
+     * are per individual; a BatchCostFunction call is shared equally
+     * between the individuals it evaluates.
+     */
+    struct Profile {
+        /**
+         * @brief 0 when the library was built without SRES_ENABLE_PROFILING,
+         * in which case everything else is 0 too
+         */
+        int enabled;
+
+        /**
+         * @brief wall time making the children: copying the parents,
+         * recombining their step sizes and mutating, so mutateSeconds
+         * is part of it
+         */
+        double replicateSeconds;
+
+        /**
+         * @brief wall time mutating the children
+         */
+        double mutateSeconds;
+
+        /**
+         * @brief drawing the random numbers of the children
+         */
+        double mutateRngSeconds;
+
+        /**
+         * @brief the step size update and first mutation attempt
+         */
+        double mutateKernelSeconds;
+
+        /**
+         * @brief further attempts for parameters which left their bounds
+         */
+        double mutateBoundRetrySeconds;
+
+        /**
+         * @brief wall time in evaluatePopulation, including
+         * the fitness cache and evaluation store
+         */
+        double evaluateSeconds;
+
+        /**
+         * @brief wall time of stochastic ranking
+         */
+        double selectSeconds;
+
+        double findBestIndividualSeconds;
+
+        unsigned long long numCostCalls;
+
+        double costCallMeanSeconds;
+
+        double costCallMinSeconds;
+
+        double costCallP50Seconds;
+
+        double costCallP90Seconds;
+
+        double costCallP99Seconds;
+
+        double costCallMaxSeconds;
+    };
+
+    /**
+     * @brief histogram of durations in nanoseconds with a bounded
+     * relative error, in the manner of an HDR histogram.
+     * @details values below 16 have a bucket each. Above that every
+     * power of 2 is split into 16 buckets, so a value is known to within
+     * 1/16th (6.25%) whatever its size, in a fixed 8 KB of counters.
+     * record() is lock free and may be called from several threads.
+     */
+    class LatencyHistogram {
+
+    public:
+
+        static constexpr unsigned SubBucketBits = 4;
+
+        static constexpr size_t NumSubBuckets = 1u << SubBucketBits;
+
+        static constexpr size_t NumBuckets = (64 - SubBucketBits + 1) * NumSubBuckets;
+
+        void record(std::uint64_t nanoseconds);
+
+        /**
+         * @brief record @param count values of @param nanoseconds each
+         */
+        void record(std::uint64_t nanoseconds, std::uint64_t count);
+
+        [[nodiscard]] std::uint64_t getCount() const;
+
+        [[nodiscard]] std::uint64_t getMin() const;
+
+        [[nodiscard]] std::uint64_t getMax() const;
+
+        [[nodiscard]] double getMean() const;
+
+        /**
+         * @brief upper bound of the bucket holding the value
+         * @param percentile percent of the values are at or below, 0 if empty
+         */
+        [[nodiscard]] std::uint64_t getValueAtPercentile(double percentile) const;
+
+        void reset();
+
+        [[nodiscard]] static size_t bucketIndex(std::uint64_t nanoseconds);
+
+        /**
+         * @brief largest value which goes in bucket @param index
+         */
+        [[nodiscard]] static std::uint64_t bucketUpperBound(size_t index);
+
+    private:
+        std::array<std::atomic<std::uint64_t>, NumBuckets> counts_{};
+
+        std::atomic<std::uint64_t> count_{0};
+
+        std::atomic<std::uint64_t> sum_{0};
+
+        std::atomic<std::uint64_t> min_{UINT64_MAX};
+
+        std::atomic<std::uint64_t> max_{0};
+    };
+
+    /**
+     * @brief accumulates the time spent in each phase of the optimizer
+     * and the latency of the cost function. Lock free.
+     */
+    class Profiler {
+
+    public:
+
+        enum Phase {
+            Replicate,
+            Mutate,
+            MutateRng,
+            MutateKernel,
+            MutateBoundRetry,
+            Evaluate,
+            Select,
+            FindBestIndividual,
+            NumPhases
+        };
+
+        typedef std::chrono::steady_clock Clock;
+
+        void add(Phase phase, Clock::duration duration);
+
+        /**
+         * @brief @param duration of a cost function call which
+         * evaluated @param numIndividuals individuals
+         */
+        void addCostCall(Clock::duration duration, size_t numIndividuals);
+
+        [[nodiscard]] const LatencyHistogram &getCostLatency() const;
+
+        [[nodiscard]] Profile getProfile() const;
+
+        void reset();
+
+    private:
+        std::array<std::atomic<std::uint64_t>, NumPhases> phaseNanoseconds_{};
+
+        LatencyHistogram costLatency_;
+    };
+
+    /**
+     * @brief adds the time from construction to destruction to a phase
+     */
+    class ScopedPhaseTimer {
+
+    public:
+
+        ScopedPhaseTimer(Profiler &profiler, Profiler::Phase phase)
+                : profiler_(profiler), phase_(phase), start_(Profiler::Clock::now()) {}
+
+        ~ScopedPhaseTimer() {
+            profiler_.add(phase_, Profiler::Clock::now() - start_);
+        }
+
+        ScopedPhaseTimer(const ScopedPhaseTimer &) = delete;
+
+        ScopedPhaseTimer &operator=(const ScopedPhaseTimer &) = delete;
+
+    private:
+        Profiler &profiler_;
+
+        Profiler::Phase phase_;
+
+        Profiler::Clock::time_point start_;
+    };
+
+    /**
+     * @brief records the time from construction to destruction as a cost function call
+     */
+    class ScopedCostTimer {
+
+    public:
+
+        ScopedCostTimer(Profiler &profiler, size_t numIndividuals)
+                : profiler_(profiler), numIndividuals_(numIndividuals), start_(Profiler::Clock::now()) {}
+
+        ~ScopedCostTimer() {
+            profiler_.addCostCall(Profiler::Clock::now() - start_, numIndividuals_);
+        }
+
+        ScopedCostTimer(const ScopedCostTimer &) = delete;
+
+        ScopedCostTimer &operator=(const ScopedCostTimer &) = delete;
+
+    private:
+        Profiler &profiler_;
+
+        size_t numIndividuals_;
+
+        Profiler::Clock::time_point start_;
+    };
+
+}
+
+/**
+ * SRES_PROFILE_PHASE(Phase) times the rest of the enclosing scope as
+ * Profiler::Phase and SRES_PROFILE_COST_CALL(n) times it as a cost
+ * function call evaluating n individuals. Both expect a profiler_ member
+ * and compile to nothing unless the library is built with
+ * SRES_ENABLE_PROFILING, which defines SRES_PROFILING.
+ */
+#ifdef SRES_PROFILING
+#define SRES_PROFILE_PHASE(PHASE) ::opt::ScopedPhaseTimer sresPhaseTimer(*profiler_, ::opt::Profiler::PHASE)
+#define SRES_PROFILE_COST_CALL(N) ::opt::ScopedCostTimer sresCostTimer(*profiler_, N)
+#else
+#define SRES_PROFILE_PHASE(PHASE)
+#define SRES_PROFILE_COST_CALL(N)
+#endif
+
+#endif //SRES_PROFILE_H
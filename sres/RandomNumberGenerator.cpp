@@ -3,14 +3,105 @@
 //
 
 #include "RandomNumberGenerator.h"
+#include <cmath>
 #include <random>
 
 namespace opt {
 
+    namespace {
+        constexpr std::uint32_t PhiloxM0 = 0xD2511F53u;
+        constexpr std::uint32_t PhiloxM1 = 0xCD9E8D57u;
+        constexpr std::uint32_t PhiloxW0 = 0x9E3779B9u;
+        constexpr std::uint32_t PhiloxW1 = 0xBB67AE85u;
+
+        constexpr std::uint64_t RootStream = ~std::uint64_t(0);
+
+        constexpr double TwoPi = 6.283185307179586476925286766559;
+
+        inline void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t &hi, std::uint32_t &lo) {
+            std::uint64_t product = std::uint64_t(a) * std::uint64_t(b);
+            hi = std::uint32_t(product >> 32);
+            lo = std::uint32_t(product);
+        }
+    }
+
+    Philox4x32::Philox4x32(std::uint64_t key, std::uint64_t stream)
+            : key_{std::uint32_t(key), std::uint32_t(key >> 32)},
+              counter_{0, 0, std::uint32_t(stream), std::uint32_t(stream >> 32)},
+              block_{0, 0, 0, 0} {}
+
+    void Philox4x32::generateBlock() {
+        std::uint32_t ctr[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+        std::uint32_t key[2] = {key_[0], key_[1]};
+        std::uint32_t hi0, lo0, hi1, lo1;
+
+        for (int round = 0; round < 10; round++) {
+            if (round > 0) {
+                key[0] += PhiloxW0;
+                key[1] += PhiloxW1;
+            }
+            mulhilo(PhiloxM0, ctr[0], hi0, lo0);
+            mulhilo(PhiloxM1, ctr[2], hi1, lo1);
+            ctr[0] = hi1 ^ ctr[1] ^ key[0];
+            ctr[1] = lo1;
+            ctr[2] = hi0 ^ ctr[3] ^ key[1];
+            ctr[3] = lo0;
+        }
+
+        block_[0] = ctr[0];
+        block_[1] = ctr[1];
+        block_[2] = ctr[2];
+        block_[3] = ctr[3];
+        index_ = 0;
+
+        // the block counter occupies the low two words
+        if (++counter_[0] == 0)
+            ++counter_[1];
+    }
+
+    void Philox4x32::discard(unsigned long long n) {
+        setPosition(getPosition() + n);
+    }
+
+    std::uint64_t Philox4x32::getKey() const {
+        return (std::uint64_t(key_[1]) << 32) | key_[0];
+    }
+
+    std::uint64_t Philox4x32::getStream() const {
+        return (std::uint64_t(counter_[3]) << 32) | counter_[2];
+    }
+
+    std::uint64_t Philox4x32::getPosition() const {
+        std::uint64_t nextBlock = (std::uint64_t(counter_[1]) << 32) | counter_[0];
+        return nextBlock * 4 - (4 - index_);
+    }
+
+    void Philox4x32::setPosition(std::uint64_t position) {
+        std::uint64_t block = position / 4;
+        counter_[0] = std::uint32_t(block);
+        counter_[1] = std::uint32_t(block >> 32);
+        index_ = 4;
+        if (position % 4) {
+            generateBlock();
+            index_ = position % 4;
+        }
+    }
+
+    bool Philox4x32::operator==(const Philox4x32 &other) const {
+        return getKey() == other.getKey() && getStream() == other.getStream()
+               && getPosition() == other.getPosition();
+    }
+
+    bool Philox4x32::operator!=(const Philox4x32 &other) const {
+        return !(*this == other);
+    }
 
 
     RandomNumberGenerator::RandomNumberGenerator(unsigned long long seed)
-            : seed_(seed), generator_(std::default_random_engine(seed)) {}
+            : seed_(seed), generator_(Philox4x32(seed, RootStream)) {}
+
+    RandomNumberGenerator::RandomNumberGenerator(unsigned long long seed, std::uint64_t stream)
+            : seed_(seed), generator_(Philox4x32(seed, stream)) {}
 
     RandomNumberGenerator &RandomNumberGenerator::getInstance() {
         static RandomNumberGenerator singleton;
@@ -26,20 +117,53 @@ namespace opt {
         // rng with that seed. So setting the seed also resets the rng
         // with that seed
         seed_ = seed;
-        generator_ = std::default_random_engine(seed_);
+        generator_ = Philox4x32(seed_, RootStream);
+        hasSpareNormal_ = false;
     }
 
-    const std::default_random_engine &RandomNumberGenerator::getGenerator() const {
+    RandomNumberGenerator RandomNumberGenerator::substream(std::uint32_t generation, std::uint32_t index) const {
+        return RandomNumberGenerator(seed_, (std::uint64_t(generation) << 32) | index);
+    }
+
+    unsigned long long RandomNumberGenerator::deriveSeed(unsigned long long seed, unsigned long long index) {
+        // splitmix64 finalizer
+        std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    const Philox4x32 &RandomNumberGenerator::getGenerator() const {
         return generator_;
     }
 
-    void RandomNumberGenerator::setGenerator(const std::default_random_engine &generator) {
+    void RandomNumberGenerator::setGenerator(const Philox4x32 &generator) {
         generator_ = generator;
+        hasSpareNormal_ = false;
+    }
+
+    RandomNumberGenerator::State RandomNumberGenerator::getState() const {
+        return {seed_, generator_.getKey(), generator_.getStream(), generator_.getPosition(),
+                spareNormal_, hasSpareNormal_};
+    }
+
+    void RandomNumberGenerator::setState(const State &state) {
+        seed_ = state.seed;
+        generator_ = Philox4x32(state.key, state.stream);
+        generator_.setPosition(state.position);
+        spareNormal_ = state.spareNormal;
+        hasSpareNormal_ = state.hasSpareNormal;
+    }
+
+    double RandomNumberGenerator::uniform01() {
+        // 27 + 26 bits, the same construction as genrand_res53
+        std::uint32_t a = generator_() >> 5;
+        std::uint32_t b = generator_() >> 6;
+        return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
     }
 
     double RandomNumberGenerator::uniformReal(double lb, double ub) {
-        std::uniform_real_distribution<double> distibution(lb, ub);
-        return distibution(generator_);
+        return lb + (ub - lb) * uniform01();
     }
 
     std::vector<double> RandomNumberGenerator::uniformReal(double lb, double ub, int size) {
@@ -51,8 +175,21 @@ namespace opt {
     }
 
     double RandomNumberGenerator::uniformInt(int lb, int ub) {
-        std::uniform_int_distribution<int> distibution(lb, ub);
-        return distibution(generator_);
+        // unbiased integer in [lb, ub] by multiply and reject (Lemire 2019)
+        std::uint64_t range = std::uint64_t(std::int64_t(ub) - std::int64_t(lb)) + 1;
+        if (range > 0xFFFFFFFFull)
+            return lb + double(std::uint64_t(uniform01() * double(range)));
+
+        std::uint64_t m = std::uint64_t(generator_()) * range;
+        auto low = std::uint32_t(m);
+        if (low < range) {
+            auto threshold = std::uint32_t((0x100000000ull - range) % range);
+            while (low < threshold) {
+                m = std::uint64_t(generator_()) * range;
+                low = std::uint32_t(m);
+            }
+        }
+        return double(std::int64_t(lb) + std::int64_t(m >> 32));
     }
 
     std::vector<double> RandomNumberGenerator::uniformInt(int lb, int ub, int size) {
@@ -65,8 +202,39 @@ namespace opt {
 
 
     double RandomNumberGenerator::normal(double mu, double sigma) {
-        std::normal_distribution<double> distibution(mu, sigma);
-        return distibution(generator_);
+        if (hasSpareNormal_) {
+            hasSpareNormal_ = false;
+            return mu + sigma * spareNormal_;
+        }
+        // Box-Muller. 1 - u is in (0, 1] so the log is finite
+        double u1 = 1.0 - uniform01();
+        double u2 = uniform01();
+        double r = std::sqrt(-2.0 * std::log(u1));
+        spareNormal_ = r * std::sin(TwoPi * u2);
+        hasSpareNormal_ = true;
+        return mu + sigma * r * std::cos(TwoPi * u2);
+    }
+
+    void RandomNumberGenerator::fillUniform(double *out, size_t n, double lb, double ub) {
+        double range = ub - lb;
+        for (size_t i = 0; i < n; i++)
+            out[i] = lb + range * uniform01();
+    }
+
+    void RandomNumberGenerator::fillNormal(double *out, size_t n, double mu, double sigma) {
+        size_t even = n & ~size_t(1);
+        fillUniform(out, even);
+
+        // each pair of uniforms is replaced by a pair of normals in place
+        for (size_t i = 0; i < even; i += 2) {
+            double r = std::sqrt(-2.0 * std::log(1.0 - out[i]));
+            double theta = TwoPi * out[i + 1];
+            out[i] = mu + sigma * r * std::cos(theta);
+            out[i + 1] = mu + sigma * r * std::sin(theta);
+        }
+
+        if (n != even)
+            out[n - 1] = normal(mu, sigma);
     }
 
     std::vector<double> RandomNumberGenerator::normal(double mu, double sigma, int size) {
@@ -78,4 +246,4 @@ namespace opt {
     }
 
 
-}
\ No newline at end of file
+}
@@ -6,46 +6,196 @@
 #define SRES_RANDOMNUMBERGENERATOR_H
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <random>
 
 namespace opt {
 
+    /**
+     * @brief Philox4x32-10 counter based random bit engine
+     * (Salmon et al. 2011, "Parallel random numbers: as easy as 1, 2, 3").
+     * @details Each output block is a pure function of a 64 bit key
+     * (the seed), a 64 bit stream id and a 64 bit block counter. Engines
+     * with the same key but different stream ids therefore produce
+     * independent sequences without sharing any state, which is what
+     * lets every individual of every generation have its own stream.
+     * Satisfies the UniformRandomBitGenerator requirements.
+     */
+    class Philox4x32 {
+
+    public:
+
+        using result_type = std::uint32_t;
+
+        explicit Philox4x32(std::uint64_t key = 0, std::uint64_t stream = 0);
+
+        static constexpr result_type min() { return 0; }
+
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        result_type operator()() {
+            if (index_ >= 4)
+                generateBlock();
+            return block_[index_++];
+        }
+
+        /**
+         * @brief skip the next @param n outputs
+         */
+        void discard(unsigned long long n);
+
+        [[nodiscard]] std::uint64_t getKey() const;
+
+        [[nodiscard]] std::uint64_t getStream() const;
+
+        /**
+         * @brief the number of 32 bit outputs drawn so far
+         */
+        [[nodiscard]] std::uint64_t getPosition() const;
+
+        /**
+         * @brief jump to output number @param position of this stream
+         */
+        void setPosition(std::uint64_t position);
+
+        bool operator==(const Philox4x32 &other) const;
+
+        bool operator!=(const Philox4x32 &other) const;
+
+    private:
+
+        void generateBlock();
+
+        std::uint32_t key_[2];
+
+        /**
+         * @brief words 0 and 1 are the block counter, words
+         * 2 and 3 the stream id.
+         */
+        std::uint32_t counter_[4];
+
+        std::uint32_t block_[4];
+
+        /**
+         * @brief index of the next unused word in block_.
+         * 4 means a new block must be generated.
+         */
+        unsigned int index_ = 4;
+    };
 
     /**
-     * @brief A singleton Random number generator. We only want one
-     * random number generator as if we instantiate multiple
-     * then we'll get a repeated predictable sequence of numbers.
+     * @brief Random number generator owned by each optimizer.
+     * @details Wraps a Philox4x32 engine keyed by the seed. Calls to
+     * substream() give generators that share the seed but draw from
+     * an independent stream identified by a generation and an index,
+     * so that parallel work can draw random numbers without sharing
+     * state and still reproduce the same numbers for a given seed,
+     * regardless of how the work is scheduled.
      */
     class RandomNumberGenerator {
 
     public:
 
+        /**
+         * @brief index of the substream used to replicate
+         * parents in a generation
+         */
+        static constexpr std::uint32_t ReplicateStream = 0xFFFFFFFFu;
+
+        /**
+         * @brief index of the substream used for
+         * stochastic ranking in a generation
+         */
+        static constexpr std::uint32_t SelectStream = 0xFFFFFFFEu;
+
+        explicit RandomNumberGenerator(unsigned long long seed = std::chrono::high_resolution_clock::now().time_since_epoch().count());
+
+        /**
+         * @brief a process wide generator.
+         * @details kept for code written against the original singleton.
+         * Optimizers own their own generator and do not use this one.
+         */
         static RandomNumberGenerator& getInstance();
 
         [[nodiscard]] unsigned long long int getSeed() const;
 
         void setSeed(unsigned long long int seed);
 
+        /**
+         * @brief generator with the same seed which draws from the independent
+         * stream identified by @param generation and @param index.
+         * @details the same (seed, generation, index) always gives the same sequence.
+         */
+        [[nodiscard]] RandomNumberGenerator substream(std::uint32_t generation, std::uint32_t index) const;
+
+        /**
+         * @brief a well mixed seed for the @param index'th of several
+         * optimizers which are all seeded from @param seed
+         */
+        static unsigned long long deriveSeed(unsigned long long seed, unsigned long long index);
+
         double uniformReal(double lb, double ub);
 
         std::vector<double> uniformReal(double lb, double ub, int size);
 
-        [[nodiscard]] const std::default_random_engine &getGenerator() const;
+        [[nodiscard]] const Philox4x32 &getGenerator() const;
+
+        void setGenerator(const Philox4x32 &generator);
 
-        void setGenerator(const std::default_random_engine &generator);
+        /**
+         * @brief everything needed to put a generator back exactly
+         * where it was, for example in a checkpoint
+         */
+        struct State {
+            unsigned long long seed;
+            std::uint64_t key;
+            std::uint64_t stream;
+            std::uint64_t position;
+            double spareNormal;
+            bool hasSpareNormal;
+        };
 
+        [[nodiscard]] State getState() const;
+
+        void setState(const State &state);
+
+        /**
+         * @brief normally distributed number.
+         * @details Box-Muller gives two variates per pair of uniforms,
+         * the second is kept and returned by the next call.
+         */
         double normal(double mu, double sigma);
 
         std::vector<double> normal(double mu, double sigma, int size);
 
+        /**
+         * @brief fill @param out with @param n normally distributed numbers
+         * @details draws all the uniforms first and then transforms them
+         * pairwise in a separate loop which has no calls into the engine,
+         * so the transform can be vectorized and both Box-Muller variates
+         * are used. Does not allocate.
+         */
+        void fillNormal(double *out, size_t n, double mu = 0.0, double sigma = 1.0);
+
+        /**
+         * @brief fill @param out with @param n numbers uniformly distributed in [lb, ub)
+         */
+        void fillUniform(double *out, size_t n, double lb = 0.0, double ub = 1.0);
+
         double uniformInt(int lb, int ub);
 
         std::vector<double> uniformInt(int lb, int ub, int size);
 
     private:
 
-        explicit RandomNumberGenerator(unsigned long long seed = std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        RandomNumberGenerator(unsigned long long seed, std::uint64_t stream);
+
+        /**
+         * @brief uniform double in [0, 1) with 53 random bits
+         */
+        double uniform01();
 
         /**
          * @brief seed defaults to the current time
@@ -55,8 +205,15 @@ namespace opt {
          */
         unsigned long long seed_;
 
-        std::default_random_engine generator_;
+        Philox4x32 generator_;
+
+        /**
+         * @brief second variate of the last Box-Muller
+         * transform done by normal(), if not yet used
+         */
+        double spareNormal_ = 0.0;
 
+        bool hasSpareNormal_ = false;
 
     };
 
@@ -0,0 +1,124 @@
+#include "RandomNumberPrefetcher.h"
+
+namespace opt {
+
+    bool GenerationShape::operator==(const GenerationShape &other) const {
+        return populationSize == other.populationSize && childRate == other.childRate &&
+               numParameters == other.numParameters && numSelectUniforms == other.numSelectUniforms;
+    }
+
+    bool GenerationRandomNumbers::holds(const RandomNumberGenerator &rng, int generation,
+                                        const GenerationShape &shape) const {
+        return this->generation == generation && seed == rng.getSeed() && this->shape == shape;
+    }
+
+    void GenerationRandomNumbers::reserve(const GenerationShape &shape) {
+        size_t numIndividuals = shape.childRate * shape.populationSize;
+        parents.resize(shape.populationSize * (shape.childRate - 1));
+        normals.resize(numIndividuals, 2 * shape.numParameters + 1);
+        childStreams.resize(numIndividuals, RandomNumberGenerator(0));
+        selectUniforms.resize(shape.numSelectUniforms);
+    }
+
+    void GenerationRandomNumbers::fill(const RandomNumberGenerator &rng, int generation,
+                                       const GenerationShape &shape) {
+        // nothing matches while half filled
+        this->generation = 0;
+        size_t mu = shape.populationSize;
+
+        // the same loops as SRES::replicate()
+        RandomNumberGenerator replicateStream = rng.substream(generation, RandomNumberGenerator::ReplicateStream);
+        size_t next = 0;
+        for (size_t i = 0; i < mu; i++)
+            for (size_t j = 1; j < shape.childRate; j++)
+                parents[next++] = (size_t) replicateStream.uniformInt(0, (int) (i + mu - 1));
+
+        for (size_t child = mu; child < normals.rows(); child++) {
+            RandomNumberGenerator childStream = rng.substream(generation, child);
+            childStream.fillNormal(normals[child].data(), normals.cols());
+            childStreams[child] = childStream;
+        }
+
+        selectStream = rng.substream(generation, RandomNumberGenerator::SelectStream);
+        selectStream.fillUniform(selectUniforms.data(), selectUniforms.size());
+
+        seed = rng.getSeed();
+        this->shape = shape;
+        this->generation = generation;
+    }
+
+    RandomNumberPrefetcher::RandomNumberPrefetcher()
+            : thread_(&RandomNumberPrefetcher::run, this) {}
+
+    RandomNumberPrefetcher::~RandomNumberPrefetcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        changed_.notify_all();
+        thread_.join();
+    }
+
+    void RandomNumberPrefetcher::prefetch(const RandomNumberGenerator &rng, int generation,
+                                          const GenerationShape &shape) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return !pending_ && !filling_; });
+        GenerationRandomNumbers &back = buffers_[1 - front_];
+        if (back.holds(rng, generation, shape) || buffers_[front_].holds(rng, generation, shape))
+            return;
+
+        // sized here so that the thread never allocates
+        back.reserve(shape);
+        rng_ = rng;
+        generation_ = generation;
+        shape_ = shape;
+        pending_ = true;
+        changed_.notify_all();
+    }
+
+    const GenerationRandomNumbers &RandomNumberPrefetcher::acquire(const RandomNumberGenerator &rng, int generation,
+                                                                   const GenerationShape &shape) {
+        // the thread only writes to the back buffer
+        if (buffers_[front_].holds(rng, generation, shape))
+            return buffers_[front_];
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this] { return !pending_ && !filling_; });
+        if (buffers_[1 - front_].holds(rng, generation, shape)) {
+            front_ = 1 - front_;
+        } else {
+            // not prefetched, for example after a restart or a checkpoint was loaded
+            buffers_[front_].reserve(shape);
+            buffers_[front_].fill(rng, generation, shape);
+        }
+        return buffers_[front_];
+    }
+
+    const GenerationRandomNumbers *RandomNumberPrefetcher::find(const RandomNumberGenerator &rng, int generation,
+                                                                const GenerationShape &shape) const {
+        if (buffers_[front_].holds(rng, generation, shape))
+            return &buffers_[front_];
+        return nullptr;
+    }
+
+    void RandomNumberPrefetcher::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            changed_.wait(lock, [this] { return stopping_ || pending_; });
+            if (stopping_)
+                return;
+
+            pending_ = false;
+            filling_ = true;
+            GenerationRandomNumbers &back = buffers_[1 - front_];
+            lock.unlock();
+
+            back.fill(rng_, generation_, shape_);
+
+            lock.lock();
+            filling_ = false;
+            changed_.notify_all();
+        }
+    }
+
+}
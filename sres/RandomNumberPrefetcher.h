@@ -0,0 +1,177 @@
+#ifndef SRES_RANDOMNUMBERPREFETCHER_H
+#define SRES_RANDOMNUMBERPREFETCHER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PopulationMatrix.h"
+#include "RandomNumberGenerator.h"
+
+namespace opt {
+
+    /**
+     * @brief the sizes which decide how many random numbers
+     * a generation of SRES draws
+     */
+    struct GenerationShape {
+        size_t populationSize = 0;
+
+        size_t childRate = 0;
+
+        size_t numParameters = 0;
+
+        /**
+         * @brief how many uniforms of the select stream to draw up front.
+         * select() carries on from selectStream when it needs more.
+         */
+        size_t numSelectUniforms = 0;
+
+        bool operator==(const GenerationShape &other) const;
+    };
+
+    /**
+     * @brief every random number SRES draws in one generation, drawn from
+     * the same substreams and in the same order as replicate(), mutate()
+     * and select() would draw them, so using them changes nothing.
+     */
+    struct GenerationRandomNumbers {
+        /**
+         * @brief 0 until filled
+         */
+        int generation = 0;
+
+        unsigned long long seed = 0;
+
+        GenerationShape shape;
+
+        /**
+         * @brief the parent each child of replicate() takes the other
+         * half of its variance from, in the order of the children
+         */
+        std::vector<size_t> parents;
+
+        /**
+         * @brief one row of 2 * numParameters + 1 normals per individual,
+         * as mutateIndividual() uses them. The rows of the parents are unused.
+         */
+        PopulationMatrix normals;
+
+        /**
+         * @brief the stream of each child positioned after its row
+         * of normals, for the retries of steps that left the bounds
+         */
+        std::vector<RandomNumberGenerator> childStreams;
+
+        /**
+         * @brief the first shape.numSelectUniforms uniforms in [0, 1)
+         * of the select stream
+         */
+        DoubleVector selectUniforms;
+
+        /**
+         * @brief the select stream positioned after selectUniforms
+         */
+        RandomNumberGenerator selectStream{0};
+
+        /**
+         * @brief true when this holds @param generation of a run seeded
+         * like @param rng with the sizes @param shape
+         */
+        [[nodiscard]] bool holds(const RandomNumberGenerator &rng, int generation,
+                                 const GenerationShape &shape) const;
+
+        /**
+         * @brief size the buffers for @param shape. Allocates only if they grow.
+         */
+        void reserve(const GenerationShape &shape);
+
+        /**
+         * @brief draw the numbers of @param generation from the substreams
+         * of @param rng. reserve() must have been called for @param shape.
+         */
+        void fill(const RandomNumberGenerator &rng, int generation, const GenerationShape &shape);
+    };
+
+    /**
+     * @brief draws the random numbers of the next generation on a
+     * background thread while the current one is being evaluated.
+     * @details double buffered: the optimizer reads the front buffer
+     * while the thread fills the back one, and acquire() swaps them once
+     * the optimizer moves on to the generation in the back buffer. Since
+     * every number is a function of the seed, the generation and the
+     * substream alone, the results are the same as drawing them in place,
+     * whichever thread draws them and whenever. Not thread safe, only the
+     * thread running the optimizer may call it.
+     */
+    class RandomNumberPrefetcher {
+
+    public:
+
+        RandomNumberPrefetcher();
+
+        /**
+         * @brief waits for the generation being filled, if any
+         */
+        ~RandomNumberPrefetcher();
+
+        RandomNumberPrefetcher(const RandomNumberPrefetcher &) = delete;
+
+        RandomNumberPrefetcher &operator=(const RandomNumberPrefetcher &) = delete;
+
+        /**
+         * @brief start filling @param generation of the run seeded like
+         * @param rng in the background. Returns straight away.
+         */
+        void prefetch(const RandomNumberGenerator &rng, int generation, const GenerationShape &shape);
+
+        /**
+         * @brief the numbers of @param generation, waiting for them if
+         * they are being prefetched and drawing them here if they were not.
+         * @details valid until the next call to acquire().
+         */
+        const GenerationRandomNumbers &acquire(const RandomNumberGenerator &rng, int generation,
+                                               const GenerationShape &shape);
+
+        /**
+         * @brief the numbers of @param generation if they have already been
+         * acquired, otherwise nullptr. Does not wait.
+         */
+        [[nodiscard]] const GenerationRandomNumbers *find(const RandomNumberGenerator &rng, int generation,
+                                                          const GenerationShape &shape) const;
+
+    private:
+
+        void run();
+
+        std::mutex mutex_;
+
+        std::condition_variable changed_;
+
+        /**
+         * @brief buffers_[front_] is read by the optimizer,
+         * the other one is filled by thread_
+         */
+        GenerationRandomNumbers buffers_[2];
+
+        int front_ = 0;
+
+        RandomNumberGenerator rng_{0};
+
+        int generation_ = 0;
+
+        GenerationShape shape_;
+
+        bool pending_ = false;
+
+        bool filling_ = false;
+
+        bool stopping_ = false;
+
+        std::thread thread_;
+    };
+
+}
+
+#endif //SRES_RANDOMNUMBERPREFETCHER_H
@@ -3,6 +3,11 @@
 //
 
 #include "SRES.h"
+#include "Checkpoint.h"
+#include "Error.h"
+#include "MutationKernel.h"
+#include "RandomNumberPrefetcher.h"
+#include <algorithm>
 #include <vector>
 #include <iostream>
 
@@ -12,6 +17,11 @@ namespace opt {
                const DoubleVector &ub, int childrate)
             : EvolutionaryOptimizer(cost, populationSize, numGenerations, startingValues, lb, ub, childrate) {};
 
+    SRES::SRES(BatchCostFunction batchCost, int populationSize,
+               int numGenerations, const DoubleVector &startingValues, const DoubleVector &lb,
+               const DoubleVector &ub, int childrate)
+            : EvolutionaryOptimizer(batchCost, populationSize, numGenerations, startingValues, lb, ub, childrate) {};
+
     const DoubleVector &SRES::getMaxVariance() const {
         return maxVariance_;
     }
@@ -28,57 +38,46 @@ namespace opt {
         pf_ = pf;
     }
 
-    bool SRES::swap(size_t from, size_t to) {
-        DoubleVector pTmp = population_[to];
-        population_[to] = population_[from];
-        population_[from] = pTmp;
-
-        pTmp = variance_[to];
-        variance_[to] = variance_[from];
-        variance_[from] = pTmp;
-
-        double dTmp = populationFitness_[to];
-        populationFitness_[to] = populationFitness_[from];
-        populationFitness_[from] = dTmp;
-
-        dTmp = phi_[to];
-        phi_[to] = phi_[from];
-        phi_[from] = dTmp;
-
-        return true;
-    }
-
     bool SRES::replicate() {
         bool Continue = true;
+        SRES_PROFILE_PHASE(Replicate);
 
         size_t Parent;
         size_t i, j;
 
-        auto itSrc = population_.begin();
-        auto endSrc = itSrc + populationSize_;
-        auto itTarget = endSrc;
-        auto itSrcVariance = variance_.begin();
-        auto itTargetVariance = itSrcVariance + populationSize_;
+        size_t target = populationSize_;
 
         double *pVariance;
         double *pVarianceEnd;
         double *pParentVariance;
 
+        const GenerationRandomNumbers *prefetched = nullptr;
+        if (prefetcher_)
+            prefetched = &prefetcher_->acquire(rng_, currentGeneration_, generationShape());
+        generationRandomNumbers_ = prefetched;
+        size_t nextParent = 0;
+
+        RandomNumberGenerator rng = rng_.substream(currentGeneration_, RandomNumberGenerator::ReplicateStream);
+
         // iterate over parents
-        for (i = 0; itSrc != endSrc && Continue; ++itSrc, ++itSrcVariance, ++i) {
+        for (i = 0; i < populationSize_ && Continue; ++i) {
+            const double *pSrc = population_[i].data();
+            const double *pSrcVariance = variance_[i].data();
+
             // iterate over the child rate - 1 since the first child is the parent.
-            for (j = 1; j < getChildRate(); ++j, ++itTarget, ++itTargetVariance) {
+            for (j = 1; j < getChildRate(); ++j, ++target) {
                 // first just copy the individuals
-                *itTarget = *itSrc;
-                *itTargetVariance = *itSrcVariance;
+                std::copy(pSrc, pSrc + numberOfParameters_, population_[target].data());
+                std::copy(pSrcVariance, pSrcVariance + numberOfParameters_, variance_[target].data());
 
                 // do recombination on the sigma
                 // since sigmas already have one parent's component
                 // need only average with the sigmas of the other parent
-                Parent = RandomNumberGenerator::getInstance().uniformInt(0, i + populationSize_ - 1);
+                Parent = prefetched ? prefetched->parents[nextParent++]
+                                    : rng.uniformInt(0, i + populationSize_ - 1);
 
-                // extract the pointer to first element from itTargetVariance
-                pVariance = itTargetVariance->data();
+                // extract the pointer to first element of the target variance
+                pVariance = variance_[target].data();
                 pVarianceEnd = pVariance + numberOfParameters_;
                 // extract pointer to Parent element of variance vector
                 pParentVariance = variance_[Parent].data();
@@ -94,112 +93,86 @@ namespace opt {
     }
 
     bool SRES::mutate() {
-        auto it = population_.begin() + populationSize_;
-        auto end = population_.end();
-        auto itVariance = variance_.begin() + populationSize_;
-
-        double *pVariable, *pVariableEnd, *pVariance, *pMaxVariance;
-//        double *pPhi = mPhi.array() + populationSize_;
-        double *pPhi = &phi_[0] + populationSize_;
-        double *pValue = &populationFitness_[0] + populationSize_;
-
         bool Continue = true;
-        size_t i, j;
-        double v1;
-
-        // Mutate each new individual
-        for (i = populationSize_; it != end && Continue; ++it, ++itVariance, ++i) {
-            pVariable = it->data();
-            pVariableEnd = pVariable + numberOfParameters_;
-            pVariance = itVariance->data();
-            pMaxVariance = maxVariance_.data();
-
-            v1 = RandomNumberGenerator::getInstance().normal(0, 1);
-
-            for (j = 0; pVariable != pVariableEnd; ++pVariable, ++pVariance, ++pMaxVariance, ++j) {
-                double &mut = *pVariable;
-                double Store = mut;
-
-
-                const OptItem &OptItem = optItems_[j];
-
-                size_t l = std::numeric_limits<size_t>::max();
+        SRES_PROFILE_PHASE(Mutate);
 
-                try {
-                    // update the parameter for the variances
-                    *pVariance = std::min(*pVariance * exp(
-                            tauPrime_ * v1 + tau_ * RandomNumberGenerator::getInstance().normal(0, 1)
-                    ), *pMaxVariance);
-
-                    for (l = 0; l < 10; l++) {
-                        // calculate the mutated parameter
-                        mut = Store + *pVariance * RandomNumberGenerator::getInstance().normal(0, 1);
+        // Mutate each new individual. Every child draws from its own
+        // random number stream, so the children can be mutated
+        // concurrently and still give the same result for a given seed.
+        forEachIndividual(populationSize_, population_.size(),
+                          [this](size_t child) { mutateIndividual(child); });
 
-                        if (OptItem.checkConstraint(mut) == 0)
-                            break;
-                    }
-                }
+        // their fitness and phi are computed when the caller of ask() calls tell()
+        return Continue;
+    }
 
-                catch (...) {
-                    mut = (OptItem.getUb() + OptItem.getLb()) * 0.5;
+    void SRES::mutateIndividual(size_t indivNum) {
+        double *x = population_[indivNum].data();
+        double *variance = variance_[indivNum].data();
+        std::uint8_t *outOfBounds = outOfBounds_.data() + indivNum * numberOfParameters_;
+
+        // one block holds v1, then a normal per variance and a normal for
+        // the first attempt at each step. Retries draw from rng directly.
+        // When prefetched, the block is already drawn and the stream of
+        // the child is positioned after it.
+        RandomNumberGenerator rng = generationRandomNumbers_
+                                    ? generationRandomNumbers_->childStreams[indivNum]
+                                    : rng_.substream(currentGeneration_, indivNum);
+        const double *normals;
+        if (generationRandomNumbers_) {
+            normals = generationRandomNumbers_->normals[indivNum].data();
+        } else {
+            SRES_PROFILE_PHASE(MutateRng);
+            rng.fillNormal(randomNumbers_[indivNum].data(), randomNumbers_.cols());
+            normals = randomNumbers_[indivNum].data();
+        }
+        double v1 = normals[0];
+        const double *varianceNormals = normals + 1;
+        const double *stepNormals = normals + 1 + numberOfParameters_;
+
+        // update every variance and make the first attempt at every step
+        const double *lb = optItems_.lb().data();
+        const double *ub = optItems_.ub().data();
+        size_t numOutOfBounds;
+        {
+            SRES_PROFILE_PHASE(MutateKernel);
+            numOutOfBounds = mutationKernel(
+                    numberOfParameters_, x, variance, maxVariance_.data(), lb, ub,
+                    tauPrime_ * v1, tau_, varianceNormals, stepNormals, outOfBounds);
+        }
+        if (numOutOfBounds == 0)
+            return;
+        SRES_PROFILE_PHASE(MutateBoundRetry);
+
+        // up to 9 more attempts for the parameters that left their bounds.
+        // If none lands inside, the parameter keeps its old value
+        for (size_t j = 0; j < numberOfParameters_; j++) {
+            if (!outOfBounds[j])
+                continue;
+
+            double store = x[j];
+            for (int l = 1; l < 10; l++) {
+                double mut = store + variance[j] * rng.normal(0, 1);
+                if (!(lb[j] > mut || mut > ub[j])) {
+                    x[j] = mut;
+                    break;
                 }
-
-                if (l == 10)
-                    mut = Store;
-
-                /**
-                 * todo The below was in the original code. Currently not sure if this applied to us.
-                 */
-                // We need to set the value here so that further checks take
-                // account of the value.
-                // *mProblemContext.master()->getContainerVariables()[j] = (mut);
             }
-
-            // calculate its fitness
-            Continue = evaluate(*it);
-            *pValue++ = fitnessValue_;
-            *pPhi++ = phi(i);
         }
-
-        return Continue;
     }
 
 
     // evaluate the distance of parameters and constraints to boundaries
-    double SRES::phi(size_t indivNum) {
-        double phiVal = 0.0;
-        double phiCalc;
-
-        auto it = optItems_.begin();
-        auto end = optItems_.end();
-        double *pValue = population_[indivNum].data();
-
-        for (; it != end; ++it, pValue++) {
-            switch (it->checkConstraint()) {
-                case -1:
-                    phiCalc = it->getLb() - *pValue;
-                    phiVal += phiCalc * phiCalc;
-                    break;
-
-                case 1:
-                    phiCalc = *pValue - it->getLb();
-                    phiVal += phiCalc * phiCalc;
-                    break;
-            }
+    void SRES::computePhi(size_t first, size_t last, const double *constraintValues) {
+        if (first == last)
+            return;
+        if (numConstraints_ > 0 && !constraintValues) {
+            INVALID_ARGUMENT_ERROR << "This optimizer has " << numConstraints_
+                                   << " constraints but no constraint values were given" << std::endl;
         }
-
-        /**
-         * If / when we add constraints into the fray, we add them here.
-         */
-        // it = mProblemContext.master()->getConstraintList().begin();
-        // end = mProblemContext.master()->getConstraintList().end();
-        // for (; it != end; ++it) {
-        //     phiCalc = (*it)->getConstraintViolation();
-        //     if (phiCalc > 0.0)
-        //         phiVal += phiCalc * phiCalc;
-        // }
-
-        return phiVal;
+        phiKernel(last - first, numberOfParameters_, population_[first].data(),
+                  optItems_.lb().data(), optItems_.ub().data(),
+                  constraintValues, numConstraints_, phi_.data() + first);
     }
 
     bool SRES::initialize() {
@@ -209,23 +182,20 @@ namespace opt {
             pf_ = 0.475;
         }
 
-        population_.resize(childRate_ * populationSize_);
-
-        for (i = 0; i < childRate_ * populationSize_; i++)
-            population_[i] = std::vector<double>(numberOfParameters_);
+        population_.resize(childRate_ * populationSize_, numberOfParameters_);
 
-        variance_.resize(childRate_ * populationSize_);
-
-        for (i = 0; i < childRate_ * populationSize_; i++)
-            variance_[i] = std::vector<double>(numberOfParameters_);
+        variance_.resize(childRate_ * populationSize_, numberOfParameters_);
 
         maxVariance_.resize(numberOfParameters_);
 
+        // also brings the contiguous bound arrays up to date before
+        // mutate() reads them from several threads
+        const std::vector<double> &lb = optItems_.lb();
+        const std::vector<double> &ub = optItems_.ub();
         for (i = 0; i < numberOfParameters_; i++) {
-            const OptItem &optItem = optItems_[i];
             try {
                 maxVariance_[i] =
-                        (optItem.getUb() - optItem.getLb()) / sqrt(double(numberOfParameters_));
+                        (ub[i] - lb[i]) / sqrt(double(numberOfParameters_));
             }
             catch (...) {
                 maxVariance_[i] = 1.0e3;
@@ -235,9 +205,22 @@ namespace opt {
         populationFitness_.resize(childRate_ * populationSize_);
         populationFitness_.assign(populationFitness_.size(), std::numeric_limits<double>::infinity());
         bestFitnessValue_ = std::numeric_limits<double>::infinity();
+        // at most one entry per generation plus the initial ones, reserved
+        // up front so that the generation loop does not allocate
+        hallOfFame_.reserve(hallOfFame_.size() + numGenerations_ + 3);
         hallOfFame_.push_back(bestFitnessValue_);
+        solutionValues_.reserve(numberOfParameters_);
 
         phi_.resize(childRate_ * populationSize_);
+        evaluated_.resize(childRate_ * populationSize_);
+
+        rankKeys_.resize(childRate_ * populationSize_);
+        selectedPopulation_.resize(childRate_ * populationSize_, numberOfParameters_);
+        selectedVariance_.resize(childRate_ * populationSize_, numberOfParameters_);
+        randomNumbers_.resize(childRate_ * populationSize_, 2 * numberOfParameters_ + 1);
+        outOfBounds_.resize(childRate_ * populationSize_ * numberOfParameters_);
+        prefetcher_ = prefetchRandomNumbers_ ? std::make_shared<RandomNumberPrefetcher>() : nullptr;
+        generationRandomNumbers_ = nullptr;
 
         try {
 
@@ -264,27 +247,22 @@ namespace opt {
         double la;
 
         bool Continue = true;
-
-        auto it = population_.begin() + first;
-        auto end = population_.begin() + populationSize_;
-        auto itVariance = variance_.begin() + first;
+        const OptItems &optItems = optItems_;
 
         double *pVariable, *pVariableEnd, *pVariance, *pMaxVariance;
-        double *pPhi = phi_.data() + first;
-        double *pValue = populationFitness_.data() + first;
 
         // set the first individual to the initial guess
-        if (it == population_.begin()) {
-            pVariable = it->data();
+        if (first == 0) {
+            pVariable = population_[0].data();
             pVariableEnd = pVariable + numberOfParameters_;
-            pVariance = itVariance->data();
+            pVariance = variance_[0].data();
             pMaxVariance = maxVariance_.data();
 
             bool pointInParameterDomain = true;
 
             for (j = 0; pVariable != pVariableEnd; ++pVariable, ++pVariance, ++pMaxVariance, ++j) {
                 double &mut = *pVariable;
-                const OptItem &optItem = optItems_[j];
+                const OptItem &optItem = optItems[j];
 
                 mut = optItem.getStartingValue();
 
@@ -331,24 +309,23 @@ namespace opt {
                              sqrt(double(numberOfParameters_));
             }
 
-            Continue = evaluate(*it);
-            *pValue++ = fitnessValue_;
-            *pPhi++ = phi(0);
-
-            ++it;
-            ++itVariance;
             ++first;
         }
 
-        for (i = first; it < end; ++it, ++itVariance, ++i) {
-            pVariable = it->data();
+        for (i = first; i < populationSize_; ++i) {
+            pVariable = population_[i].data();
             pVariableEnd = pVariable + numberOfParameters_;
-            pVariance = itVariance->data();
+            pVariance = variance_[i].data();
             pMaxVariance = maxVariance_.data();
 
+            RandomNumberGenerator rng = rng_.substream(currentGeneration_, i);
+            // one uniform per parameter
+            double *uniforms = randomNumbers_[i].data();
+            rng.fillUniform(uniforms, numberOfParameters_);
+
             for (j = 0; pVariable != pVariableEnd; ++pVariable, ++pVariance, ++pMaxVariance, ++j) {
                 double &mut = *pVariable;
-                const OptItem &OptItem = optItems_[j];
+                const OptItem &OptItem = optItems[j];
 
                 // calculate lower and upper bounds
                 mn = OptItem.getLb();
@@ -363,22 +340,22 @@ namespace opt {
                         la = log10(mx) - log10(std::max(mn, std::numeric_limits<double>::min()));
 
                         if (la < 1.8 || mn <= 0.0) // linear
-                            mut = mn + RandomNumberGenerator::getInstance().uniformReal(0, 1) * (mx - mn);
+                            mut = mn + uniforms[j] * (mx - mn);
                         else
                             mut = pow(10.0, log10(std::max(mn, std::numeric_limits<double>::min())) +
-                                            la * RandomNumberGenerator::getInstance().uniformReal(0, 1));
+                                            la * uniforms[j]);
                     } else if (mx > 0) // 0 is in the interval (mn, mx)
                     {
                         la = log10(mx) + log10(-mn);
 
                         if (la < 3.6) // linear
-                            mut = mn + RandomNumberGenerator::getInstance().uniformReal(0, 1) * (mx - mn);
+                            mut = mn + uniforms[j] * (mx - mn);
                         else {
                             double mean = (mx + mn) * 0.5;
                             double sigma = mean * 0.01;
 
                             do {
-                                mut = RandomNumberGenerator::getInstance().normal(mean, sigma);
+                                mut = rng.normal(mean, sigma);
                             } while ((mut < mn) || (mut > mx));
                         }
                     } else // the interval (mn, mx] is in (-inf, 0]
@@ -391,10 +368,10 @@ namespace opt {
                         la = log10(mx) - log10(std::max(mn, std::numeric_limits<double>::min()));
 
                         if (la < 1.8 || mn <= 0.0) // linear
-                            mut = -(mn + RandomNumberGenerator::getInstance().uniformReal(0, 1) * (mx - mn));
+                            mut = -(mn + uniforms[j] * (mx - mn));
                         else
                             mut = -pow(10.0, log10(std::max(mn, std::numeric_limits<double>::min())) +
-                                             la * RandomNumberGenerator::getInstance().uniformReal(0, 1));
+                                             la * uniforms[j]);
                     }
                 }
 
@@ -442,18 +419,15 @@ namespace opt {
                 *pVariance = std::min(OptItem.getUb() - mut, mut - OptItem.getLb()) /
                              sqrt(double(numberOfParameters_));
             }
-
-            // calculate its fitness
-            Continue = evaluate(*it);
-            *pValue++ = fitnessValue_;
-            *pPhi++ = phi(i);
         }
 
+        // their fitness and phi are computed when the caller of ask() calls tell()
         return Continue;
     }
 
     // check the best individual at this generation
     size_t SRES::findBestIndividual() {
+        SRES_PROFILE_PHASE(FindBestIndividual);
         size_t i, bestIndex = std::numeric_limits<size_t>::max();
         double bestValue = std::numeric_limits<double>::max();
 
@@ -461,114 +435,262 @@ namespace opt {
             if (populationFitness_[i] < bestValue && phi_[i] == 0) {
                 bestIndex = i;
                 bestValue = populationFitness_[i];
-                solutionValues_ = population_[i];
             }
 
+        if (bestIndex != std::numeric_limits<size_t>::max())
+            solutionValues_.assign(population_[bestIndex].begin(), population_[bestIndex].end());
+
         return bestIndex;
     }
 
     void SRES::select() {
+        SRES_PROFILE_PHASE(Select);
         size_t i, j;
         size_t TotalPopulation = population_.size();
         bool wasSwapped;
-        size_t sweepNum = TotalPopulation;  // This is default based on paper
+
+        // the uniforms are prefetched with the rest of the generation, apart
+        // from those of the initial population and any beyond the prefix drawn
+        const GenerationRandomNumbers *prefetched =
+                prefetcher_ ? prefetcher_->find(rng_, currentGeneration_, generationShape()) : nullptr;
+        const double *uniforms = prefetched ? prefetched->selectUniforms.data() : nullptr;
+        size_t numUniforms = prefetched ? prefetched->selectUniforms.size() : 0;
+        size_t nextUniform = 0;
+        RandomNumberGenerator rng = prefetched ? prefetched->selectStream
+                                               : rng_.substream(currentGeneration_, RandomNumberGenerator::SelectStream);
+
+        // Comparisons are only random between individuals with a phi,
+        // and only when pf_ is non zero.
+        bool deterministic = pf_ == 0 ||
+                             std::all_of(phi_.begin(), phi_.begin() + TotalPopulation,
+                                         [](double phi) { return phi == 0; });
+
+        // only a random comparison can look at the fitness of an
+        // infeasible individual, the only kind which is ever put off
+        if (!deterministic)
+            evaluateDeferred();
+
+        // Rank an index array with the fitness and phi of each
+        // individual packed next to it, rather than moving whole
+        // individuals around on every swap.
+        for (i = 0; i < TotalPopulation; i++)
+            rankKeys_[i] = {populationFitness_[i], phi_[i], i, evaluated_[i] != 0};
 
         // Selection Method for Stochastic Ranking
         // stochastic ranking "bubble sort"
 
-        for (i = 0; i < sweepNum; i++) // Here sweepNum is optimal number of sweeps from paper
-        {
-            wasSwapped = false;
-
-            // :TODO: since we are only interested in mPopulationSize highest ranked
-            // individuals the upper limit of the loop can be improved.
-            for (j = 0; j < TotalPopulation - 1; j++)  // lambda is number of individuals
+        auto compare = [&](RankKey &upper, RankKey &lower) {
+            if ((upper.phi == 0 && lower.phi == 0) || // within bounds
+                ((nextUniform < numUniforms ? uniforms[nextUniform++] : rng.uniformReal(0, 1)) <
+                 pf_))      // random chance to compare values outside bounds
             {
-                if ((phi_[j] == 0 && phi_[j + 1] == 0) || // within bounds
-                    (RandomNumberGenerator::getInstance().uniformReal(0, 1) <
-                     pf_))      // random chance to compare values outside bounds
+                // compare obj fcn using mValue alternative code
+                if (upper.fitness > lower.fitness) {
+                    std::swap(upper, lower);
+                    return true;
+                }
+            } else {
+                if (upper.phi > lower.phi) // upper further outside then lower
                 {
-                    // compare obj fcn using mValue alternative code
-                    if (populationFitness_[j] > populationFitness_[j + 1]) {
-                        swap(j, j + 1);
-                        wasSwapped = true;
-                    }
-                } else {
-                    if (phi_[j] > phi_[j + 1]) // j further outside then j+1
-                    {
-                        swap(j, j + 1);
-                        wasSwapped = true;
-                    }
+                    std::swap(upper, lower);
+                    return true;
                 }
             }
+            return false;
+        };
+
+        if (deterministic) {
+            // Without random comparisons the ranking is a stable sort, and
+            // the parents are the same whichever way the bubbles run. Sweeps
+            // run from the bottom to the top so that each sweep carries the
+            // winner of the remaining individuals up to position i, after
+            // which position i is never compared again, and we can stop once
+            // the populationSize_ highest ranked individuals are settled.
+            size_t sweepNum = std::min(TotalPopulation, (size_t) populationSize_);
+            for (i = 0; i < sweepNum; i++) {
+                wasSwapped = false;
+                for (j = TotalPopulation - 1; j > i; j--)
+                    wasSwapped |= compare(rankKeys_[j - 1], rankKeys_[j]);
+
+                // if nothing was swapped, then they're ordered!
+                if (!wasSwapped) break;
+            }
+        } else {
+            // Random comparisons can still move an individual out of the
+            // top after any number of sweeps, so this is the ranking of
+            // Runarsson and Yao: up to TotalPopulation sweeps over the
+            // whole population.
+            size_t sweepNum = TotalPopulation;  // This is default based on paper
+            for (i = 0; i < sweepNum; i++) {
+                wasSwapped = false;
+                for (j = 0; j + 1 < TotalPopulation; j++)
+                    wasSwapped |= compare(rankKeys_[j], rankKeys_[j + 1]);
+
+                // if nothing was swapped, then they're ordered!
+                if (!wasSwapped) break;
+            }
+        }
 
-            // if nothing was swapped, then they're ordered!
-            if (!wasSwapped) break;
+        // Gather the selected individuals into the parent slots of a
+        // second buffer and swap the buffers. Only the parents are copied,
+        // so the child slots are left holding stale rows which replicate()
+        // overwrites in the next generation.
+        for (i = 0; i < populationSize_; i++) {
+            const RankKey &key = rankKeys_[i];
+            const double *pSrc = population_[key.index].data();
+            const double *pSrcVariance = variance_[key.index].data();
+            std::copy(pSrc, pSrc + numberOfParameters_, selectedPopulation_[i].data());
+            std::copy(pSrcVariance, pSrcVariance + numberOfParameters_, selectedVariance_[i].data());
+            populationFitness_[i] = key.fitness;
+            phi_[i] = key.phi;
+            evaluated_[i] = key.evaluated;
         }
+
+        population_.swap(selectedPopulation_);
+        variance_.swap(selectedVariance_);
     }
 
+    GenerationShape SRES::generationShape() const {
+        GenerationShape shape;
+        shape.populationSize = populationSize_;
+        shape.childRate = childRate_;
+        shape.numParameters = numberOfParameters_;
+        // select() only draws a uniform when comparing an individual with a
+        // phi, which takes constraints. Enough for every comparison, up to a point.
+        if (numConstraints_ > 0 && pf_ != 0) {
+            size_t total = shape.childRate * shape.populationSize;
+            shape.numSelectUniforms = std::min(total * (total - 1), (size_t) 1 << 16);
+        }
+        return shape;
+    }
 
-    bool SRES::fit() {
-        bool Continue = true;
-        size_t bestIndex = std::numeric_limits<size_t>::max();
+    void SRES::prefetchNextGeneration() {
+        if (prefetcher_ && currentGeneration_ < numGenerations_)
+            prefetcher_->prefetch(rng_, currentGeneration_ + 1, generationShape());
+    }
 
-        size_t Stalled = 0;
 
-        if (!initialize()) {
-            // comment out mpCallBack code for now. Its to do with
-            // logging the results and I may roll my own.
-            // if (mpCallBack)
-            //    mpCallBack->finishItem(mhGenerations);
+    CandidateBatch SRES::ask() {
+        switch (askTellPhase_) {
+            case AskTellPhase::AwaitingCreationFitness:
+            case AskTellPhase::AwaitingChildFitness:
+                LOGIC_ERROR << "ask() was called twice without a call to tell() in between" << std::endl;
+
+            case AskTellPhase::Finished:
+                return {nullptr, 0, (size_t) numberOfParameters_, 0};
+
+            case AskTellPhase::NotStarted:
+                initialize();
+                stalledGenerations_ = 0;
+                numSkippedEvaluations_ = 0;
+                numEvaluations_ = 0;
+#ifdef SRES_PROFILING
+                profiler_->reset();
+#endif
+                runStartTime_ = std::chrono::steady_clock::now();
+                lastCheckpointGeneration_ = 0;
+                lastCheckpointTime_ = runStartTime_;
+                lastReportGeneration_ = 0;
+                lastReportTime_ = runStartTime_;
+
+                // initialise the population. This is the first generation.
+                currentGeneration_ = 1;
+                creation(0);
+                prefetchNextGeneration();
+
+                askTellPhase_ = AskTellPhase::AwaitingCreationFitness;
+                return {population_[0].data(), (size_t) populationSize_, (size_t) numberOfParameters_, 0};
+
+            case AskTellPhase::ReadyForGeneration:
+                currentGeneration_++;
+
+                replicate();
+                prefetchNextGeneration();
+
+                askTellPhase_ = AskTellPhase::AwaitingChildFitness;
+                return {population_[populationSize_].data(), population_.size() - populationSize_,
+                        (size_t) numberOfParameters_, (size_t) populationSize_};
+        }
+        return {nullptr, 0, (size_t) numberOfParameters_, 0};
+    }
 
-            return false;
+    bool SRES::tell(const double *fitness) {
+        if (numConstraints_ > 0) {
+            INVALID_ARGUMENT_ERROR << "This optimizer has " << numConstraints_
+                                   << " constraints, pass their values to tell()" << std::endl;
         }
+        return tell(fitness, nullptr);
+    }
 
-        // initialise the population
-        Continue = creation(0);
+    bool SRES::tell(const double *fitness, const double *constraintValues) {
+        size_t first = 0, last = 0;
+        if (askTellPhase_ == AskTellPhase::AwaitingCreationFitness) {
+            last = populationSize_;
+        } else if (askTellPhase_ == AskTellPhase::AwaitingChildFitness) {
+            first = populationSize_;
+            last = population_.size();
+        }
 
-        // initialise solution variables. (cw not the same as original)
-        bestFitnessValue_ = populationFitness_[0];
-        solutionValues_ = population_[0];
-        hallOfFame_.push_back(populationFitness_[0]);
+        // the caller has evaluated every candidate of the block
+        std::fill(evaluated_.begin() + first, evaluated_.begin() + last, 1);
+        numEvaluations_ += last - first;
+        computePhi(first, last, constraintValues);
+        update(fitness);
+        reportGeneration();
+        checkpointIfDue();
+        return askTellPhase_ == AskTellPhase::ReadyForGeneration;
+    }
 
-        if (bestFitnessValue_ == -std::numeric_limits<double>::infinity())
-            Continue = false;
+    bool SRES::update(const double *fitness) {
+        bool Continue = true;
+        size_t bestIndex = std::numeric_limits<size_t>::max();
+        size_t first, last;
 
+        switch (askTellPhase_) {
+            case AskTellPhase::AwaitingCreationFitness:
+                first = 0;
+                last = populationSize_;
+                break;
+            case AskTellPhase::AwaitingChildFitness:
+                first = populationSize_;
+                last = population_.size();
+                break;
+            default:
+                LOGIC_ERROR << "tell() must follow a call to ask() which returned candidates" << std::endl;
+        }
 
-        // get the index of the fittest
-        bestIndex = findBestIndividual();
+        // fit() evaluates straight into populationFitness_
+        if (fitness != populationFitness_.data() + first)
+            std::copy(fitness, fitness + (last - first), populationFitness_.data() + first);
 
-        if (bestIndex != std::numeric_limits<size_t>::max()) {
-            // and store that value
-            bestFitnessValue_ = populationFitness_[bestIndex];
-            solutionValues_ = population_[bestIndex];
-            hallOfFame_.push_back(populationFitness_[bestIndex]);
+        if (askTellPhase_ == AskTellPhase::AwaitingCreationFitness) {
+            // initialise solution variables. (cw not the same as original)
+            bestFitnessValue_ = populationFitness_[0];
+            solutionValues_.assign(population_[0].begin(), population_[0].end());
+            hallOfFame_.push_back(populationFitness_[0]);
 
             if (bestFitnessValue_ == -std::numeric_limits<double>::infinity())
                 Continue = false;
 
 
-            // todo will need something to replace this
-            // We found a new best value lets report it.
-            // mpParentTask->output(COutputInterface::DURING);
-        }
-
-        if (!Continue) {
-            // if (mpCallBack)
-            //    mpCallBack->finishItem(mhGenerations);
+            // get the index of the fittest
+            bestIndex = findBestIndividual();
 
-            return true;
-        }
+            if (bestIndex != std::numeric_limits<size_t>::max()) {
+                // and store that value
+                bestFitnessValue_ = populationFitness_[bestIndex];
+                solutionValues_.assign(population_[bestIndex].begin(), population_[bestIndex].end());
+                hallOfFame_.push_back(populationFitness_[bestIndex]);
 
-        for (currentGeneration_ = 2;
-             currentGeneration_ <= numGenerations_ && Continue;
-             currentGeneration_++, Stalled++) {
+                if (bestFitnessValue_ == -std::numeric_limits<double>::infinity())
+                    Continue = false;
 
-            if (stopAfterStalledGenerations_ != 0 && Stalled > stopAfterStalledGenerations_)
-                break;
-
-            Continue = replicate();
 
+                // todo will need something to replace this
+                // We found a new best value lets report it.
+                // mpParentTask->output(COutputInterface::DURING);
+            }
+        } else {
             // select the most fit
             select();
 
@@ -576,14 +698,12 @@ namespace opt {
             bestIndex = findBestIndividual();
 
             if (bestIndex != std::numeric_limits<size_t>::max() && populationFitness_[bestIndex] < bestFitnessValue_) {
-                if (bestIndex != std::numeric_limits<size_t>::max()) {
-                    // and store that value
-                    bestFitnessValue_ = populationFitness_[bestIndex];
-                    hallOfFame_.push_back(populationFitness_[bestIndex]);
-                    solutionValues_ = population_[bestIndex];
-                    if (bestFitnessValue_ == -std::numeric_limits<double>::infinity())
-                        Continue = false;
-                }
+                // and store that value
+                bestFitnessValue_ = populationFitness_[bestIndex];
+                hallOfFame_.push_back(populationFitness_[bestIndex]);
+                solutionValues_.assign(population_[bestIndex].begin(), population_[bestIndex].end());
+                if (bestFitnessValue_ == -std::numeric_limits<double>::infinity())
+                    Continue = false;
 
                 // if (mpCallBack)
                 //    Continue = mpCallBack->progressItem(mhGenerations);
@@ -592,6 +712,16 @@ namespace opt {
                 // mpParentTask->output(COutputInterface::MONITORING);
             }
 
+            stalledGenerations_++;
+        }
+
+        // decide whether there will be another generation. Note that the stall
+        // counter counts generations run rather than generations without
+        // improvement, as it always has.
+        if (!Continue || currentGeneration_ + 1 > numGenerations_ ||
+            (stopAfterStalledGenerations_ != 0 && stalledGenerations_ > stopAfterStalledGenerations_)) {
+            askTellPhase_ = AskTellPhase::Finished;
+
             //if (mLogVerbosity > 0)
             //    mMethodLog.enterLogEntry(
             //            COptLogEntry("Algorithm finished.",
@@ -600,9 +730,474 @@ namespace opt {
 
             //if (mpCallBack)
             //    mpCallBack->finishItem(mhGenerations);
+            return false;
+        }
 
+        askTellPhase_ = AskTellPhase::ReadyForGeneration;
+        return true;
+    }
+
+    bool SRES::tell(const DoubleVector &fitness) {
+        size_t expected = askTellPhase_ == AskTellPhase::AwaitingCreationFitness
+                          ? populationSize_ : population_.size() - populationSize_;
+        if (fitness.size() != expected) {
+            INVALID_ARGUMENT_ERROR << "Expected " << expected << " fitness values but got "
+                                   << fitness.size() << std::endl;
+        }
+        return tell(fitness.data());
+    }
+
+    bool SRES::tell(const DoubleVector &fitness, const DoubleVector &constraintValues) {
+        size_t expected = askTellPhase_ == AskTellPhase::AwaitingCreationFitness
+                          ? populationSize_ : population_.size() - populationSize_;
+        if (fitness.size() != expected) {
+            INVALID_ARGUMENT_ERROR << "Expected " << expected << " fitness values but got "
+                                   << fitness.size() << std::endl;
+        }
+        if (constraintValues.size() != expected * numConstraints_) {
+            INVALID_ARGUMENT_ERROR << "Expected " << expected * numConstraints_ << " constraint values but got "
+                                   << constraintValues.size() << std::endl;
+        }
+        return tell(fitness.data(), constraintValues.empty() ? nullptr : constraintValues.data());
+    }
+
+    void SRES::evaluateConstraints(size_t first, size_t last) {
+        // sized for the largest block, so only the first call allocates
+        constraintValues_.resize(population_.size() * numConstraints_);
+        forEachIndividual(first, last, [this, first](size_t i) {
+            (*constraintFunction_)(population_[i].data(), constraintValues_.data() + (i - first) * numConstraints_);
+        });
+    }
+
+    bool SRES::evaluateFeasible(size_t first, size_t last) {
+        for (size_t i = first; i < last; i++) {
+            evaluated_[i] = phi_[i] == 0;
+            if (!evaluated_[i]) {
+                populationFitness_[i] = std::numeric_limits<double>::infinity();
+                numSkippedEvaluations_++;
+            }
+        }
+
+        return evaluatePopulation(first, last, evaluated_.data());
+    }
+
+    double SRES::violation(size_t individual) const {
+        return phi_[individual];
+    }
+
+    void SRES::evaluateDeferred() {
+        size_t numDeferred = 0;
+        deferred_.resize(population_.size());
+        for (size_t i = 0; i < population_.size(); i++) {
+            deferred_[i] = !evaluated_[i];
+            numDeferred += deferred_[i];
+        }
+        if (numDeferred == 0)
+            return;
+
+        // selection is under way, so finish it even if the run has been cancelled
+        evaluatePopulation(0, population_.size(), deferred_.data(), false);
+        std::fill(evaluated_.begin(), evaluated_.begin() + population_.size(), 1);
+        // immigrants may not have been counted
+        numSkippedEvaluations_ -= std::min(numSkippedEvaluations_, numDeferred);
+    }
+
+    ConstraintFunction SRES::getConstraintFunction() const {
+        return constraintFunction_;
+    }
+
+    void SRES::setConstraintFunction(ConstraintFunction constraints, int numConstraints) {
+        if (constraints && numConstraints <= 0) {
+            INVALID_ARGUMENT_ERROR << "A constraint function needs at least one constraint" << std::endl;
+        }
+        setNumConstraints(constraints ? numConstraints : 0);
+        constraintFunction_ = constraints;
+    }
+
+    size_t SRES::getNumSkippedEvaluations() const {
+        return numSkippedEvaluations_;
+    }
+
+    int SRES::getNumConstraints() const {
+        return numConstraints_;
+    }
+
+    void SRES::setNumConstraints(int numConstraints) {
+        if (numConstraints < 0) {
+            INVALID_ARGUMENT_ERROR << "The number of constraints cannot be negative" << std::endl;
+        }
+        if (askTellPhase_ == AskTellPhase::AwaitingCreationFitness ||
+            askTellPhase_ == AskTellPhase::AwaitingChildFitness) {
+            LOGIC_ERROR << "The number of constraints cannot change between ask() and tell()" << std::endl;
+        }
+        numConstraints_ = numConstraints;
+    }
+
+    bool SRES::isFinished() const {
+        return askTellPhase_ == AskTellPhase::Finished;
+    }
+
+    std::vector<size_t> SRES::rankParents() const {
+        std::vector<size_t> order(populationSize_);
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            if (phi_[a] != phi_[b])
+                return phi_[a] < phi_[b];
+            return populationFitness_[a] < populationFitness_[b];
+        });
+        return order;
+    }
+
+    std::vector<Individual> SRES::getBestIndividuals(size_t n) const {
+        if (askTellPhase_ == AskTellPhase::NotStarted) {
+            LOGIC_ERROR << "There are no individuals before the optimization has started" << std::endl;
+        }
+        std::vector<size_t> order = rankParents();
+        n = std::min(n, order.size());
+
+        std::vector<Individual> best(n);
+        for (size_t k = 0; k < n; k++) {
+            best[k].parameters = population_[order[k]].toVector();
+            best[k].variances = variance_[order[k]].toVector();
+            best[k].fitness = populationFitness_[order[k]];
+            best[k].phi = phi_[order[k]];
+            best[k].evaluated = evaluated_[order[k]] != 0;
+        }
+        return best;
+    }
+
+    void SRES::immigrate(const std::vector<Individual> &individuals) {
+        if (askTellPhase_ != AskTellPhase::ReadyForGeneration) {
+            LOGIC_ERROR << "Individuals can only immigrate between a call to tell() and the next call to ask()"
+                        << std::endl;
+        }
+        if (individuals.size() > (size_t) populationSize_) {
+            INVALID_ARGUMENT_ERROR << "Cannot immigrate " << individuals.size()
+                                   << " individuals into a population of size " << populationSize_ << std::endl;
+        }
+
+        std::vector<size_t> order = rankParents();
+        for (size_t k = 0; k < individuals.size(); k++) {
+            const Individual &individual = individuals[k];
+            if (individual.parameters.size() != (size_t) numberOfParameters_ ||
+                individual.variances.size() != (size_t) numberOfParameters_) {
+                INVALID_ARGUMENT_ERROR << "Immigrants must have " << numberOfParameters_ << " parameters" << std::endl;
+            }
+            size_t slot = order[order.size() - 1 - k];
+            std::copy(individual.parameters.begin(), individual.parameters.end(), population_[slot].data());
+            std::copy(individual.variances.begin(), individual.variances.end(), variance_[slot].data());
+            populationFitness_[slot] = individual.fitness;
+            phi_[slot] = individual.phi;
+            evaluated_[slot] = individual.evaluated;
+            if (!individual.evaluated)
+                numSkippedEvaluations_++;
+        }
+    }
+
+    void SRES::restart() {
+        askTellPhase_ = AskTellPhase::NotStarted;
+    }
+
+    std::string SRES::serializeState() const {
+        if (askTellPhase_ != AskTellPhase::ReadyForGeneration && askTellPhase_ != AskTellPhase::Finished) {
+            LOGIC_ERROR << "A checkpoint can only be saved between a tell() and the next ask()" << std::endl;
+        }
+        BinaryWriter writer;
+
+        // the shape of the problem, checked when loading
+        writer.write<std::int32_t>(numberOfParameters_);
+        writer.write<std::int32_t>(populationSize_);
+        writer.write<std::int32_t>(childRate_);
+        writer.write<std::int32_t>(numConstraints_);
+
+        writer.write<std::int32_t>(askTellPhase_ == AskTellPhase::Finished);
+        writer.write<std::int32_t>(currentGeneration_);
+        writer.write<std::uint32_t>(stalledGenerations_);
+        writer.write<std::uint64_t>(numSkippedEvaluations_);
+        writer.write<std::uint64_t>(numEvaluations_);
+        writer.write(pf_);
+        writer.write(tau_);
+        writer.write(tauPrime_);
+        writer.write(bestFitnessValue_);
+        RandomNumberGenerator::State rngState = rng_.getState();
+        writer.write<std::uint64_t>(rngState.seed);
+        writer.write(rngState.key);
+        writer.write(rngState.stream);
+        writer.write(rngState.position);
+        writer.write(rngState.spareNormal);
+        writer.write<std::uint8_t>(rngState.hasSpareNormal);
+
+        writer.writeVector(solutionValues_);
+        writer.writeVector(hallOfFame_);
+        writer.writeVector(maxVariance_);
+        writer.writeArray(population_.data(), population_.rows() * population_.cols());
+        writer.writeArray(variance_.data(), variance_.rows() * variance_.cols());
+        writer.writeVector(populationFitness_);
+        writer.writeVector(phi_);
+        writer.writeVector(evaluated_);
+        return writer.release();
+    }
+
+    void SRES::deserializeState(const std::string &payload) {
+        BinaryReader reader(payload);
+        auto numParameters = reader.read<std::int32_t>();
+        auto populationSize = reader.read<std::int32_t>();
+        auto childRate = reader.read<std::int32_t>();
+        auto numConstraints = reader.read<std::int32_t>();
+        if (numParameters != numberOfParameters_ || populationSize != populationSize_ ||
+            childRate != childRate_ || numConstraints != numConstraints_) {
+            INVALID_ARGUMENT_ERROR << "The checkpoint is of a run with " << numParameters << " parameters, "
+                                   << "a population size of " << populationSize << ", a child rate of "
+                                   << childRate << " and " << numConstraints << " constraints, but this "
+                                   << "optimizer has " << numberOfParameters_ << ", " << populationSize_ << ", "
+                                   << childRate_ << " and " << numConstraints_ << std::endl;
         }
 
+        // sizes every buffer for the problem, the saved state then replaces the contents
+        initialize();
+
+        bool finished = reader.read<std::int32_t>() != 0;
+        currentGeneration_ = reader.read<std::int32_t>();
+        stalledGenerations_ = reader.read<std::uint32_t>();
+        numSkippedEvaluations_ = reader.read<std::uint64_t>();
+        numEvaluations_ = reader.read<std::uint64_t>();
+        pf_ = reader.read<double>();
+        tau_ = reader.read<double>();
+        tauPrime_ = reader.read<double>();
+        bestFitnessValue_ = reader.read<double>();
+        RandomNumberGenerator::State rngState{};
+        rngState.seed = reader.read<std::uint64_t>();
+        rngState.key = reader.read<std::uint64_t>();
+        rngState.stream = reader.read<std::uint64_t>();
+        rngState.position = reader.read<std::uint64_t>();
+        rngState.spareNormal = reader.read<double>();
+        rngState.hasSpareNormal = reader.read<std::uint8_t>() != 0;
+        rng_.setState(rngState);
+
+        solutionValues_ = reader.readVector<double>();
+        hallOfFame_ = reader.readVector<double>();
+        hallOfFame_.reserve(hallOfFame_.size() + numGenerations_ + 3);
+        reader.readArray(maxVariance_.data(), maxVariance_.size());
+        reader.readArray(population_.data(), population_.rows() * population_.cols());
+        reader.readArray(variance_.data(), variance_.rows() * variance_.cols());
+        reader.readArray(populationFitness_.data(), populationFitness_.size());
+        reader.readArray(phi_.data(), phi_.size());
+        reader.readArray(evaluated_.data(), evaluated_.size());
+        if (!reader.atEnd()) {
+            INVALID_ARGUMENT_ERROR << "Unexpected data at the end of the checkpoint" << std::endl;
+        }
+
+        askTellPhase_ = finished ? AskTellPhase::Finished : AskTellPhase::ReadyForGeneration;
+        runStartTime_ = std::chrono::steady_clock::now();
+        lastCheckpointGeneration_ = currentGeneration_;
+        lastCheckpointTime_ = runStartTime_;
+        lastReportGeneration_ = currentGeneration_;
+        lastReportTime_ = runStartTime_;
+    }
+
+    void SRES::saveCheckpoint(const std::string &path) const {
+        writeCheckpointFile(path, serializeState());
+    }
+
+    void SRES::loadCheckpoint(const std::string &path) {
+        deserializeState(readCheckpointFile(path));
+    }
+
+    bool SRES::resume() {
+        while (step(std::numeric_limits<int>::max()));
+        return true;
+    }
+
+    void SRES::setCheckpointSchedule(const std::string &path, int everyGenerations, double everySeconds) {
+        if (everyGenerations < 0 || everySeconds < 0) {
+            INVALID_ARGUMENT_ERROR << "The checkpoint interval cannot be negative" << std::endl;
+        }
+        checkpointPath_ = path;
+        checkpointEveryGenerations_ = everyGenerations;
+        checkpointEverySeconds_ = everySeconds;
+        lastCheckpointGeneration_ = currentGeneration_;
+        lastCheckpointTime_ = std::chrono::steady_clock::now();
+        if (checkpointPath_.empty()) {
+            // writes whatever is still pending before going
+            checkpointWriter_.reset();
+        } else if (!checkpointWriter_) {
+            checkpointWriter_ = std::make_shared<CheckpointWriter>();
+        }
+    }
+
+    void SRES::flushCheckpoints() {
+        if (checkpointWriter_)
+            checkpointWriter_->flush();
+    }
+
+    void SRES::checkpointIfDue() {
+        if (checkpointPath_.empty())
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        bool due = askTellPhase_ == AskTellPhase::Finished;
+        if (checkpointEveryGenerations_ > 0 &&
+            currentGeneration_ - lastCheckpointGeneration_ >= checkpointEveryGenerations_)
+            due = true;
+        if (checkpointEverySeconds_ > 0 &&
+            std::chrono::duration<double>(now - lastCheckpointTime_).count() >= checkpointEverySeconds_)
+            due = true;
+        if (!due)
+            return;
+
+        // the copy is taken here, the disk is left to the writer thread
+        checkpointWriter_->submit(checkpointPath_, serializeState());
+        lastCheckpointGeneration_ = currentGeneration_;
+        lastCheckpointTime_ = now;
+    }
+
+    void SRES::checkpointOnCancel() {
+        if (checkpointPath_.empty() || askTellPhase_ != AskTellPhase::ReadyForGeneration)
+            return;
+        // the process is likely about to exit, so wait for the disk
+        checkpointWriter_->submit(checkpointPath_, serializeState());
+        checkpointWriter_->flush();
+        lastCheckpointGeneration_ = currentGeneration_;
+        lastCheckpointTime_ = std::chrono::steady_clock::now();
+    }
+
+    GenerationCallback SRES::getGenerationCallback() const {
+        return generationCallback_;
+    }
+
+    void SRES::setGenerationCallback(GenerationCallback callback, int everyGenerations, double minSeconds) {
+        if (everyGenerations < 1 || minSeconds < 0) {
+            INVALID_ARGUMENT_ERROR << "Generation callbacks need an interval of at least 1 generation "
+                                      "and a non negative number of seconds" << std::endl;
+        }
+        generationCallback_ = callback;
+        reportEveryGenerations_ = everyGenerations;
+        reportMinSeconds_ = minSeconds;
+    }
+
+    bool SRES::getPrefetchRandomNumbers() const {
+        return prefetchRandomNumbers_;
+    }
+
+    void SRES::setPrefetchRandomNumbers(bool prefetchRandomNumbers) {
+        prefetchRandomNumbers_ = prefetchRandomNumbers;
+    }
+
+    void SRES::reportGeneration() {
+        if (!generationCallback_)
+            return;
+
+        auto now = std::chrono::steady_clock::now();
+        bool finished = askTellPhase_ == AskTellPhase::Finished;
+        if (!finished && (currentGeneration_ - lastReportGeneration_ < reportEveryGenerations_ ||
+                          std::chrono::duration<double>(now - lastReportTime_).count() < reportMinSeconds_))
+            return;
+        lastReportGeneration_ = currentGeneration_;
+        lastReportTime_ = now;
+
+        GenerationInfo info{};
+        info.generation = currentGeneration_;
+        info.numEvaluations = numEvaluations_;
+        info.bestFitness = bestFitnessValue_;
+
+        // parents whose fitness was put off hold infinity, so are left out
+        parentFitness_.clear();
+        for (size_t i = 0; i < (size_t) populationSize_; i++)
+            if (evaluated_[i])
+                parentFitness_.push_back(populationFitness_[i]);
+        if (parentFitness_.empty()) {
+            info.medianFitness = std::numeric_limits<double>::quiet_NaN();
+        } else {
+            auto middle = parentFitness_.begin() + parentFitness_.size() / 2;
+            std::nth_element(parentFitness_.begin(), middle, parentFitness_.end());
+            info.medianFitness = *middle;
+            if (parentFitness_.size() % 2 == 0)
+                info.medianFitness = (info.medianFitness + *std::max_element(parentFitness_.begin(), middle)) / 2;
+        }
+
+        size_t numFeasible = 0;
+        double sigma = 0;
+        for (size_t i = 0; i < (size_t) populationSize_; i++) {
+            numFeasible += phi_[i] == 0;
+            for (size_t j = 0; j < (size_t) numberOfParameters_; j++)
+                sigma += variance_(i, j);
+        }
+        info.feasibleFraction = (double) numFeasible / populationSize_;
+        info.meanSigma = sigma / ((double) populationSize_ * numberOfParameters_);
+        info.elapsedSeconds = std::chrono::duration<double>(now - runStartTime_).count();
+
+        if ((*generationCallback_)(&info) != 0)
+            askTellPhase_ = AskTellPhase::Finished;
+    }
+
+    bool SRES::step(int generations) {
+        // a driver over ask and tell which evaluates
+        // the candidates in place with the cost function
+        int stepped = 0;
+        while (stepped < generations) {
+            if (isCancelled()) {
+                checkpointOnCancel();
+                return false;
+            }
+
+            CandidateBatch candidates = ask();
+            if (candidates.numCandidates == 0)
+                return false;
+
+            size_t first = candidates.firstIndex;
+            size_t last = first + candidates.numCandidates;
+            const double *constraintValues = nullptr;
+            if (constraintFunction_) {
+                evaluateConstraints(first, last);
+                constraintValues = constraintValues_.data();
+            }
+
+            // before evaluating, so the evaluation store can record phi
+            computePhi(first, last, constraintValues);
+
+            size_t numSkippedEvaluations = numSkippedEvaluations_;
+            bool complete;
+            if (constraintFunction_ && first != 0 && pf_ == 0) {
+                // select() never compares the fitness of infeasible
+                // children, so their cost function is never needed
+                complete = evaluateFeasible(first, last);
+            } else {
+                complete = evaluatePopulation(first, last);
+                std::fill(evaluated_.begin() + first, evaluated_.begin() + last, 1);
+            }
+
+            if (!complete) {
+                // cancelled part way through. The children are made from the
+                // parents and the generation number alone, so dropping them
+                // leaves the state of the last complete generation.
+                numSkippedEvaluations_ = numSkippedEvaluations;
+                if (askTellPhase_ == AskTellPhase::AwaitingCreationFitness) {
+                    askTellPhase_ = AskTellPhase::NotStarted;
+                } else {
+                    currentGeneration_--;
+                    askTellPhase_ = AskTellPhase::ReadyForGeneration;
+                }
+                checkpointOnCancel();
+                return false;
+            }
+
+            update(populationFitness_.data() + first);
+            reportGeneration();
+            checkpointIfDue();
+            if (askTellPhase_ != AskTellPhase::ReadyForGeneration)
+                return false;
+
+            // the initial population does not count as a generation
+            if (first != 0)
+                stepped++;
+        }
+        return true;
+    }
+
+    bool SRES::fit() {
+        restart();
+        while (step(std::numeric_limits<int>::max()));
         return true;
     }
 
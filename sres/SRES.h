@@ -6,6 +6,10 @@
 #define SRES_SRES_H
 
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 #include <random>
 #include <functional>
@@ -14,6 +18,86 @@
 
 namespace opt {
 
+    class CheckpointWriter;
+
+    class RandomNumberPrefetcher;
+
+    struct GenerationRandomNumbers;
+
+    struct GenerationShape;
+
+    /**
+     * @brief inequality constraints of a problem.
+     * @param parameters the candidate parameters
+     * @param constraintValues output array with one value per constraint.
+     * A constraint is satisfied when its value is <= 0.
+     */
+    typedef void(*ConstraintFunction)(double *parameters, double *constraintValues);
+
+    /**
+     * @brief summary of a generation passed to a GenerationCallback.
+     * Plain data so that it can be read from C and Python.
+     */
+    struct GenerationInfo {
+        /**
+         * @brief 1 for the initial population
+         */
+        int generation;
+
+        /**
+         * @brief calls to the cost function so far, not counting
+         * fitness found in the fitness cache or evaluation store
+         */
+        unsigned long long numEvaluations;
+
+        double bestFitness;
+
+        /**
+         * @brief median fitness of the parents whose fitness has been
+         * evaluated, see SRES::setConstraintFunction. NaN if there are none.
+         */
+        double medianFitness;
+
+        /**
+         * @brief fraction of the parents with a phi of 0
+         */
+        double feasibleFraction;
+
+        /**
+         * @brief mean step size of the parents over all parameters
+         */
+        double meanSigma;
+
+        /**
+         * @brief seconds since the run started, or was loaded from a checkpoint
+         */
+        double elapsedSeconds;
+    };
+
+    /**
+     * @brief observer of a run, called after each generation.
+     * @param info valid for the duration of the call only.
+     * @returns non zero to stop the run after this generation.
+     */
+    typedef int(*GenerationCallback)(const GenerationInfo *info);
+
+    /**
+     * @brief a copy of one individual together with
+     * its strategy parameters, fitness and constraint violation.
+     * Used to move individuals between optimizers.
+     */
+    struct Individual {
+        DoubleVector parameters;
+        DoubleVector variances;
+        double fitness;
+        double phi;
+
+        /**
+         * @brief false when the objective of this infeasible
+         * individual was never needed and so never evaluated
+         */
+        bool evaluated = true;
+    };
 
     class SRES : public EvolutionaryOptimizer {
 
@@ -25,6 +109,10 @@ namespace opt {
              const DoubleVector &startingValues, const DoubleVector &lb,
              const DoubleVector &ub, int childrate = 7);
 
+        SRES(BatchCostFunction batchCost, int populationSize, int numGenerations,
+             const DoubleVector &startingValues, const DoubleVector &lb,
+             const DoubleVector &ub, int childrate = 7);
+
         [[nodiscard]] const DoubleVector &getMaxVariance() const;
 
         void setMaxVariance(const DoubleVector &maxVariance);
@@ -33,16 +121,274 @@ namespace opt {
 
         void setPf(double pf);
 
+        /**
+         * @brief run the optimization to completion.
+         * @details steps through ask() and tell() until the run finishes.
+         */
         bool fit() override;
 
+        /**
+         * @brief advance the run by up to @param generations generations,
+         * evaluating the candidates with the cost function.
+         * @details the initial population is evaluated by the first call
+         * and does not count as a generation.
+         * @returns false once the run has finished or was cancelled.
+         * A cancelled run stops after its last complete generation and,
+         * when checkpoints are scheduled, saves one before returning.
+         */
+        bool step(int generations);
+
+        /**
+         * @brief generate the next batch of candidates to evaluate.
+         * @details the first call initializes the optimizer and returns the
+         * initial population. Subsequent calls replicate and mutate the
+         * parents and return the children. The returned rows are owned by
+         * the optimizer and stay valid until the following call to tell().
+         * Each ask() must be followed by a tell(). Once the run has
+         * finished an empty batch is returned.
+         */
+        CandidateBatch ask();
+
+        /**
+         * @brief report the fitness of the candidates returned by the last
+         * call to ask(). @param fitness holds one value per candidate, in
+         * the same order. Runs selection, tracks the best individual and
+         * the stopping criteria.
+         * @returns true if there is another generation to ask() for.
+         */
+        bool tell(const double *fitness);
+
+        /**
+         * @brief tell(const double *) for a problem with inequality
+         * constraints. @param constraintValues holds getNumConstraints()
+         * values per candidate, row major in the order of the candidates.
+         * A constraint is satisfied when its value is <= 0 and the positive
+         * values are added, squared, to the phi of the candidate.
+         */
+        bool tell(const double *fitness, const double *constraintValues);
+
+        /**
+         * @brief same as tell(const double *) but checks the number of values
+         */
+        bool tell(const DoubleVector &fitness);
+
+        /**
+         * @brief same as tell(const double *, const double *)
+         * but checks the number of values
+         */
+        bool tell(const DoubleVector &fitness, const DoubleVector &constraintValues);
+
+        [[nodiscard]] ConstraintFunction getConstraintFunction() const;
+
+        /**
+         * @brief set a function computing @param numConstraints inequality
+         * constraint values for a candidate, used by step() and fit().
+         * @details the constraints are evaluated before the cost function.
+         * The cost function is then only called for the children which
+         * satisfy every constraint and bound. With a pf of 0 stochastic
+         * ranking never compares the fitness of an infeasible individual,
+         * so the cost function of infeasible children is never called and
+         * their fitness is left at infinity. With any other pf every child
+         * is evaluated, in one pass. Like the cost function, the constraint
+         * function must be thread safe when numThreads is greater than 1.
+         * Pass nullptr to remove the constraints.
+         */
+        void setConstraintFunction(ConstraintFunction constraints, int numConstraints);
+
+        /**
+         * @brief number of calls to the cost function saved by
+         * evaluating the constraints first, since the last restart
+         */
+        [[nodiscard]] size_t getNumSkippedEvaluations() const;
+
+        [[nodiscard]] int getNumConstraints() const;
+
+        /**
+         * @brief number of inequality constraint values the caller
+         * passes to tell() for each candidate. Defaults to 0, when
+         * only the parameter bounds count towards phi.
+         */
+        void setNumConstraints(int numConstraints);
+
+        /**
+         * @brief true when the last call to tell() ended the run
+         */
+        [[nodiscard]] bool isFinished() const;
+
+        /**
+         * @brief copies of the @param n best parents, feasible
+         * individuals first and then by fitness.
+         */
+        [[nodiscard]] std::vector<Individual> getBestIndividuals(size_t n) const;
+
+        /**
+         * @brief replace the worst parents with @param individuals.
+         * @details only valid between a tell() and the next ask(). The
+         * individuals take part in the next generation like any other parent.
+         */
+        void immigrate(const std::vector<Individual> &individuals);
+
+        /**
+         * @brief forget the current run so that the next
+         * call to ask() starts a new one
+         */
+        void restart();
+
+        /**
+         * @brief write the full state of the run to @param path so that
+         * loadCheckpoint() can carry on from exactly this point.
+         * @details the population, strategy parameters, fitness, phi,
+         * stopping counters, hall of fame and random number generator are
+         * all saved. The file is written to path + ".tmp" and renamed over
+         * path, so an existing checkpoint is only ever replaced by a
+         * complete one. Only valid between a tell() and the next ask(),
+         * or once the run has finished.
+         */
+        void saveCheckpoint(const std::string &path) const;
+
+        /**
+         * @brief restore the run saved by saveCheckpoint() to @param path.
+         * @details the optimizer must have been set up for the same
+         * problem: number of parameters, bounds, population size, child
+         * rate and number of constraints. Continue the run with resume(),
+         * step() or ask() and tell(); it then produces the same results as
+         * the run which was saved would have. Settings which are not part
+         * of the run, such as the number of generations and threads, are
+         * left as they are.
+         */
+        void loadCheckpoint(const std::string &path);
+
+        /**
+         * @brief carry on with the current run until it finishes. Unlike
+         * fit(), which starts a new run, this continues from where step()
+         * or loadCheckpoint() left off.
+         */
+        bool resume();
+
+        /**
+         * @brief save a checkpoint to @param path every @param everyGenerations
+         * generations and every @param everySeconds seconds, whichever comes
+         * first, and once more when the run finishes.
+         * @details a 0 disables that trigger and an empty path disables
+         * checkpointing. The state is copied after the generation and
+         * written on a background thread, so the run does not wait for
+         * the disk. An error while writing is thrown by the following
+         * checkpoint or by flushCheckpoints().
+         */
+        void setCheckpointSchedule(const std::string &path, int everyGenerations, double everySeconds = 0.0);
+
+        /**
+         * @brief wait until the scheduled checkpoints are written
+         */
+        void flushCheckpoints();
+
+        [[nodiscard]] GenerationCallback getGenerationCallback() const;
+
+        /**
+         * @brief call @param callback after the generations of a run,
+         * on the thread running it, at most once every @param everyGenerations
+         * generations and @param minSeconds seconds. The generation which
+         * ends the run is always reported. The run stops when the callback
+         * returns non zero. The summary is only computed for the generations
+         * reported, so a rate limited observer costs next to nothing.
+         * Pass nullptr to remove the callback.
+         */
+        void setGenerationCallback(GenerationCallback callback, int everyGenerations = 1, double minSeconds = 0.0);
+
+        [[nodiscard]] bool getPrefetchRandomNumbers() const;
+
+        /**
+         * @brief draw the random numbers of the next generation on a
+         * background thread while the children of the current one are
+         * evaluated, so that replicate(), mutate() and select() only read
+         * them. Off by default.
+         * @details the numbers are the same as when drawn in place, so the
+         * results for a given seed do not change. Pays off when the cost
+         * function is cheap enough for drawing random numbers to be a
+         * noticeable part of a generation and there is a core to spare.
+         * Takes effect from the next run.
+         */
+        void setPrefetchRandomNumbers(bool prefetchRandomNumbers);
+
     private:
-        bool swap(size_t from, size_t to);
+        /**
+         * @brief sort key used by the stochastic ranking in select().
+         * @details individual @param index of the current population
+         * together with its fitness and phi.
+         */
+        struct RankKey {
+            double fitness;
+            double phi;
+            size_t index;
+            bool evaluated;
+        };
+
+        /**
+         * @brief the part of tell() after phi has been computed and the
+         * block marked as evaluated, which step() does itself
+         */
+        bool update(const double *fitness);
+
+        /**
+         * @brief the state saved by saveCheckpoint()
+         */
+        [[nodiscard]] std::string serializeState() const;
+
+        void deserializeState(const std::string &payload);
+
+        /**
+         * @brief hand a checkpoint to checkpointWriter_
+         * if the schedule says one is due
+         */
+        void checkpointIfDue();
+
+        /**
+         * @brief save a checkpoint straight away
+         * if any are scheduled, for a cancelled run
+         */
+        void checkpointOnCancel();
+
+        /**
+         * @brief call generationCallback_ if it is due,
+         * finishing the run if it asks to stop
+         */
+        void reportGeneration();
+
+        /**
+         * @brief fill constraintValues_ for candidates
+         * [@param first, @param last) with the constraint function
+         */
+        void evaluateConstraints(size_t first, size_t last);
+
+        /**
+         * @brief evaluate the cost function for the candidates in
+         * [@param first, @param last) which have a phi of 0
+         */
+        bool evaluateFeasible(size_t first, size_t last);
+
+        /**
+         * @brief evaluate, in one pass, every individual whose fitness
+         * was put off, before a ranking which may compare it
+         */
+        void evaluateDeferred();
 
         bool replicate();
 
         bool mutate() override;
 
-        double phi(size_t indivNum);
+        /**
+         * @brief mutate the variances and parameters of a single
+         * child using the random number stream of that child
+         */
+        void mutateIndividual(size_t indivNum);
+
+        /**
+         * @brief phi of individuals [@param first, @param last) from their
+         * parameters and, when there are constraints, @param constraintValues
+         */
+        void computePhi(size_t first, size_t last, const double *constraintValues);
+
+        [[nodiscard]] double violation(size_t individual) const override;
 
         bool initialize() override;
 
@@ -50,14 +396,31 @@ namespace opt {
 
         size_t findBestIndividual() override;
 
+        /**
+         * @brief indices of the parents ordered from best
+         * to worst, feasible individuals first
+         */
+        [[nodiscard]] std::vector<size_t> rankParents() const;
+
         void select() override;
 
+        /**
+         * @brief the sizes deciding the random numbers of a generation
+         */
+        [[nodiscard]] GenerationShape generationShape() const;
+
+        /**
+         * @brief start drawing the random numbers of the generation after
+         * currentGeneration_ in the background, if prefetching and there is one
+         */
+        void prefetchNextGeneration();
+
         /**
          * @brief variance of every position in the
          * populationi matrix
          * @note (probably correct, might not be)
          */
-        DoubleMatrix variance_;
+        PopulationMatrix variance_;
 
         /**
          * @brief largest variance for a particular population.
@@ -76,6 +439,118 @@ namespace opt {
         double tauPrime_ = 100.0;    // parameter for updating variances
 
         DoubleVector phi_;
+
+        int numConstraints_ = 0;
+
+        ConstraintFunction constraintFunction_ = nullptr;
+
+        /**
+         * @brief row major constraint values of the block being evaluated by step()
+         */
+        DoubleVector constraintValues_;
+
+        /**
+         * @brief whether the fitness of each individual has been evaluated
+         */
+        std::vector<std::uint8_t> evaluated_;
+
+        /**
+         * @brief rows evaluated by evaluateDeferred(). Kept to reuse its memory.
+         */
+        std::vector<std::uint8_t> deferred_;
+
+        size_t numSkippedEvaluations_ = 0;
+
+        /**
+         * @brief where the optimizer is in the ask/tell cycle
+         */
+        enum class AskTellPhase {
+            NotStarted,
+            AwaitingCreationFitness,
+            ReadyForGeneration,
+            AwaitingChildFitness,
+            Finished
+        };
+
+        AskTellPhase askTellPhase_ = AskTellPhase::NotStarted;
+
+        /**
+         * @brief generations run since the initial population,
+         * compared against stopAfterStalledGenerations_
+         */
+        unsigned int stalledGenerations_ = 0;
+
+        /**
+         * @brief one row of random numbers per individual, filled in
+         * bulk from the individual's stream by creation() and mutate()
+         */
+        PopulationMatrix randomNumbers_;
+
+        /**
+         * @brief for each child and parameter, whether the first
+         * mutation attempt left the bounds. Filled by mutationKernel.
+         */
+        std::vector<std::uint8_t> outOfBounds_;
+
+        /**
+         * @brief ranking of the whole population, filled by select()
+         */
+        std::vector<RankKey> rankKeys_;
+
+        /**
+         * @brief buffers the selected individuals (and their
+         * variances) are gathered into before being swapped
+         * with population_ and variance_
+         */
+        PopulationMatrix selectedPopulation_;
+
+        PopulationMatrix selectedVariance_;
+
+        std::string checkpointPath_;
+
+        int checkpointEveryGenerations_ = 0;
+
+        double checkpointEverySeconds_ = 0.0;
+
+        int lastCheckpointGeneration_ = 0;
+
+        std::chrono::steady_clock::time_point lastCheckpointTime_;
+
+        /**
+         * @brief made by setCheckpointSchedule()
+         */
+        std::shared_ptr<CheckpointWriter> checkpointWriter_;
+
+        bool prefetchRandomNumbers_ = false;
+
+        /**
+         * @brief made by initialize() when prefetchRandomNumbers_ is set,
+         * so a run has one to itself
+         */
+        std::shared_ptr<RandomNumberPrefetcher> prefetcher_;
+
+        /**
+         * @brief the prefetched numbers of the generation being
+         * mutated, or nullptr to draw them in place
+         */
+        const GenerationRandomNumbers *generationRandomNumbers_ = nullptr;
+
+        GenerationCallback generationCallback_ = nullptr;
+
+        int reportEveryGenerations_ = 1;
+
+        double reportMinSeconds_ = 0.0;
+
+        int lastReportGeneration_ = 0;
+
+        std::chrono::steady_clock::time_point lastReportTime_;
+
+        std::chrono::steady_clock::time_point runStartTime_;
+
+        /**
+         * @brief fitness of the parents, partially sorted for the median
+         */
+        DoubleVector parentFitness_;
     };
 
 }
@@ -0,0 +1,855 @@
+#include <algorithm>
+#include <cmath>
+#include "Error.h"
+#include "TestProblems.h"
+
+namespace opt {
+
+    namespace {
+
+        const double Pi = 3.14159265358979323846;
+
+        const double E = 2.71828182845904523536;
+
+        /**
+         * @brief the tolerance of an equality constraint
+         */
+        const double EqualityTolerance = 1e-4;
+
+        double equality(double h) {
+            return std::fabs(h) - EqualityTolerance;
+        }
+
+        /*
+         * The scalable problems are sums over the parameters. Each is a Terms
+         * struct which accumulates one parameter at a time, so that the per
+         * individual and batch forms share the arithmetic. The batch form
+         * evaluates Lanes individuals side by side, one Terms each: the lanes
+         * are independent, so the compiler can vectorize across individuals
+         * without reordering any sum, and every individual gets exactly the
+         * value of the per individual form.
+         */
+
+        const int Lanes = 4;
+
+        struct RosenbrockTerms {
+            double sum = 0;
+
+            void add(const double *x, int j, int n) {
+                if (j + 1 < n) {
+                    double a = x[j + 1] - x[j] * x[j];
+                    double b = 1 - x[j];
+                    sum += 100 * a * a + b * b;
+                }
+            }
+
+            [[nodiscard]] double finish(int) const {
+                return sum;
+            }
+        };
+
+        struct RastriginTerms {
+            double sum = 0;
+
+            void add(const double *x, int j, int) {
+                sum += x[j] * x[j] - 10 * cos(2 * Pi * x[j]);
+            }
+
+            [[nodiscard]] double finish(int n) const {
+                return 10 * n + sum;
+            }
+        };
+
+        struct AckleyTerms {
+            double sumOfSquares = 0;
+            double sumOfCos = 0;
+
+            void add(const double *x, int j, int) {
+                sumOfSquares += x[j] * x[j];
+                sumOfCos += cos(2 * Pi * x[j]);
+            }
+
+            [[nodiscard]] double finish(int n) const {
+                return -20 * exp(-0.2 * sqrt(sumOfSquares / n)) - exp(sumOfCos / n) + 20 + E;
+            }
+        };
+
+        struct GriewankTerms {
+            double sum = 0;
+            double product = 1;
+
+            void add(const double *x, int j, int) {
+                sum += x[j] * x[j];
+                product *= cos(x[j] / sqrt(j + 1.0));
+            }
+
+            [[nodiscard]] double finish(int) const {
+                return 1 + sum / 4000 - product;
+            }
+        };
+
+        template<class Terms>
+        double evaluate(const double *x, int n) {
+            Terms terms;
+            for (int j = 0; j < n; j++)
+                terms.add(x, j, n);
+            return terms.finish(n);
+        }
+
+        template<class Terms>
+        void evaluateBatch(const double *population, int numIndividuals, int n, double *fitness) {
+            int i = 0;
+            for (; i + Lanes <= numIndividuals; i += Lanes) {
+                Terms terms[Lanes];
+                for (int j = 0; j < n; j++)
+                    for (int k = 0; k < Lanes; k++)
+                        terms[k].add(population + (size_t) (i + k) * n, j, n);
+                for (int k = 0; k < Lanes; k++)
+                    fitness[i + k] = terms[k].finish(n);
+            }
+            for (; i < numIndividuals; i++)
+                fitness[i] = evaluate<Terms>(population + (size_t) i * n, n);
+        }
+
+        /**
+         * @brief a CostFunction is not told the number of
+         * parameters, so the scalable problems have one per size
+         */
+        template<class Terms, int N>
+        double scalableCost(double *x) {
+            return evaluate<Terms>(x, N);
+        }
+
+        template<class Terms>
+        void scalableBatchCost(double *population, int numIndividuals, int numParameters, double *fitness) {
+            evaluateBatch<Terms>(population, numIndividuals, numParameters, fitness);
+        }
+
+        template<class Terms>
+        CostFunction scalableCostFor(int numParameters) {
+            switch (numParameters) {
+                case 2:
+                    return scalableCost<Terms, 2>;
+                case 5:
+                    return scalableCost<Terms, 5>;
+                case 10:
+                    return scalableCost<Terms, 10>;
+                case 20:
+                    return scalableCost<Terms, 20>;
+                case 30:
+                    return scalableCost<Terms, 30>;
+                default:
+                    return nullptr;
+            }
+        }
+
+        /**
+         * @brief batch form of a fixed size problem, evaluating the rows one
+         * at a time. F is a template argument so that it is inlined.
+         */
+        template<CostFunction F>
+        void rowBatchCost(double *population, int numIndividuals, int numParameters, double *fitness) {
+            for (int i = 0; i < numIndividuals; i++)
+                fitness[i] = F(population + (size_t) i * numParameters);
+        }
+
+        /**
+         * minimum = f(3, 0.5) = 0
+         */
+        double beale(double *x) {
+            double first = 1.5 - x[0] + x[0] * x[1];
+            double second = 2.25 - x[0] + x[0] * x[1] * x[1];
+            double third = 2.625 - x[0] + x[0] * x[1] * x[1] * x[1];
+            return first * first + second * second + third * third;
+        }
+
+        /*
+         * The CEC2006 problems, from J. J. Liang et al., "Problem definitions
+         * and evaluation criteria for the CEC 2006 special session on
+         * constrained real-parameter optimization". The report numbers the
+         * parameters from 1, so its x1 is x[0] here.
+         */
+
+        double g01(double *x) {
+            double f = 0;
+            for (int i = 0; i < 4; i++)
+                f += 5 * x[i] - 5 * x[i] * x[i];
+            for (int i = 4; i < 13; i++)
+                f -= x[i];
+            return f;
+        }
+
+        void g01Constraints(double *x, double *g) {
+            g[0] = 2 * x[0] + 2 * x[1] + x[9] + x[10] - 10;
+            g[1] = 2 * x[0] + 2 * x[2] + x[9] + x[11] - 10;
+            g[2] = 2 * x[1] + 2 * x[2] + x[10] + x[11] - 10;
+            g[3] = -8 * x[0] + x[9];
+            g[4] = -8 * x[1] + x[10];
+            g[5] = -8 * x[2] + x[11];
+            g[6] = -2 * x[3] - x[4] + x[9];
+            g[7] = -2 * x[5] - x[6] + x[10];
+            g[8] = -2 * x[7] - x[8] + x[11];
+        }
+
+        double g02(double *x) {
+            double sumCos4 = 0, productCos2 = 1, weightedSquares = 0;
+            for (int i = 0; i < 20; i++) {
+                double c = cos(x[i]);
+                sumCos4 += c * c * c * c;
+                productCos2 *= c * c;
+                weightedSquares += (i + 1) * x[i] * x[i];
+            }
+            return -std::fabs(sumCos4 - 2 * productCos2) / sqrt(weightedSquares);
+        }
+
+        void g02Constraints(double *x, double *g) {
+            double product = 1, sum = 0;
+            for (int i = 0; i < 20; i++) {
+                product *= x[i];
+                sum += x[i];
+            }
+            g[0] = 0.75 - product;
+            g[1] = sum - 7.5 * 20;
+        }
+
+        double g03(double *x) {
+            double f = -pow(sqrt(10.0), 10);
+            for (int i = 0; i < 10; i++)
+                f *= x[i];
+            return f;
+        }
+
+        void g03Constraints(double *x, double *g) {
+            double h = -1;
+            for (int i = 0; i < 10; i++)
+                h += x[i] * x[i];
+            g[0] = equality(h);
+        }
+
+        double g04(double *x) {
+            return 5.3578547 * x[2] * x[2] + 0.8356891 * x[0] * x[4] + 37.293239 * x[0] - 40792.141;
+        }
+
+        void g04Constraints(double *x, double *g) {
+            double u = 85.334407 + 0.0056858 * x[1] * x[4] + 0.0006262 * x[0] * x[3] - 0.0022053 * x[2] * x[4];
+            double v = 80.51249 + 0.0071317 * x[1] * x[4] + 0.0029955 * x[0] * x[1] + 0.0021813 * x[2] * x[2];
+            double w = 9.300961 + 0.0047026 * x[2] * x[4] + 0.0012547 * x[0] * x[2] + 0.0019085 * x[2] * x[3];
+            g[0] = u - 92;
+            g[1] = -u;
+            g[2] = v - 110;
+            g[3] = -v + 90;
+            g[4] = w - 25;
+            g[5] = -w + 20;
+        }
+
+        double g05(double *x) {
+            return 3 * x[0] + 0.000001 * pow(x[0], 3) + 2 * x[1] + (0.000002 / 3) * pow(x[1], 3);
+        }
+
+        void g05Constraints(double *x, double *g) {
+            g[0] = -x[3] + x[2] - 0.55;
+            g[1] = -x[2] + x[3] - 0.55;
+            g[2] = equality(1000 * sin(-x[2] - 0.25) + 1000 * sin(-x[3] - 0.25) + 894.8 - x[0]);
+            g[3] = equality(1000 * sin(x[2] - 0.25) + 1000 * sin(x[2] - x[3] - 0.25) + 894.8 - x[1]);
+            g[4] = equality(1000 * sin(x[3] - 0.25) + 1000 * sin(x[3] - x[2] - 0.25) + 1294.8);
+        }
+
+        double g06(double *x) {
+            return pow(x[0] - 10, 3) + pow(x[1] - 20, 3);
+        }
+
+        void g06Constraints(double *x, double *g) {
+            g[0] = -pow(x[0] - 5, 2) - pow(x[1] - 5, 2) + 100;
+            g[1] = pow(x[0] - 6, 2) + pow(x[1] - 5, 2) - 82.81;
+        }
+
+        double g07(double *x) {
+            return x[0] * x[0] + x[1] * x[1] + x[0] * x[1] - 14 * x[0] - 16 * x[1] + pow(x[2] - 10, 2)
+                   + 4 * pow(x[3] - 5, 2) + pow(x[4] - 3, 2) + 2 * pow(x[5] - 1, 2) + 5 * x[6] * x[6]
+                   + 7 * pow(x[7] - 11, 2) + 2 * pow(x[8] - 10, 2) + pow(x[9] - 7, 2) + 45;
+        }
+
+        void g07Constraints(double *x, double *g) {
+            g[0] = -105 + 4 * x[0] + 5 * x[1] - 3 * x[6] + 9 * x[7];
+            g[1] = 10 * x[0] - 8 * x[1] - 17 * x[6] + 2 * x[7];
+            g[2] = -8 * x[0] + 2 * x[1] + 5 * x[8] - 2 * x[9] - 12;
+            g[3] = 3 * pow(x[0] - 2, 2) + 4 * pow(x[1] - 3, 2) + 2 * x[2] * x[2] - 7 * x[3] - 120;
+            g[4] = 5 * x[0] * x[0] + 8 * x[1] + pow(x[2] - 6, 2) - 2 * x[3] - 40;
+            g[5] = x[0] * x[0] + 2 * pow(x[1] - 2, 2) - 2 * x[0] * x[1] + 14 * x[4] - 6 * x[5];
+            g[6] = 0.5 * pow(x[0] - 8, 2) + 2 * pow(x[1] - 4, 2) + 3 * x[4] * x[4] - x[5] - 30;
+            g[7] = -3 * x[0] + 6 * x[1] + 12 * pow(x[8] - 8, 2) - 7 * x[9];
+        }
+
+        double g08(double *x) {
+            return -pow(sin(2 * Pi * x[0]), 3) * sin(2 * Pi * x[1]) / (pow(x[0], 3) * (x[0] + x[1]));
+        }
+
+        void g08Constraints(double *x, double *g) {
+            g[0] = x[0] * x[0] - x[1] + 1;
+            g[1] = 1 - x[0] + pow(x[1] - 4, 2);
+        }
+
+        double g09(double *x) {
+            return pow(x[0] - 10, 2) + 5 * pow(x[1] - 12, 2) + pow(x[2], 4) + 3 * pow(x[3] - 11, 2)
+                   + 10 * pow(x[4], 6) + 7 * x[5] * x[5] + pow(x[6], 4) - 4 * x[5] * x[6] - 10 * x[5] - 8 * x[6];
+        }
+
+        void g09Constraints(double *x, double *g) {
+            g[0] = -127 + 2 * x[0] * x[0] + 3 * pow(x[1], 4) + x[2] + 4 * x[3] * x[3] + 5 * x[4];
+            g[1] = -282 + 7 * x[0] + 3 * x[1] + 10 * x[2] * x[2] + x[3] - x[4];
+            g[2] = -196 + 23 * x[0] + x[1] * x[1] + 6 * x[5] * x[5] - 8 * x[6];
+            g[3] = 4 * x[0] * x[0] + x[1] * x[1] - 3 * x[0] * x[1] + 2 * x[2] * x[2] + 5 * x[5] - 11 * x[6];
+        }
+
+        double g10(double *x) {
+            return x[0] + x[1] + x[2];
+        }
+
+        void g10Constraints(double *x, double *g) {
+            g[0] = -1 + 0.0025 * (x[3] + x[5]);
+            g[1] = -1 + 0.0025 * (x[4] + x[6] - x[3]);
+            g[2] = -1 + 0.01 * (x[7] - x[4]);
+            g[3] = -x[0] * x[5] + 833.33252 * x[3] + 100 * x[0] - 83333.333;
+            g[4] = -x[1] * x[6] + 1250 * x[4] + x[1] * x[3] - 1250 * x[3];
+            g[5] = -x[2] * x[7] + 1250000 + x[2] * x[4] - 2500 * x[4];
+        }
+
+        double g11(double *x) {
+            return x[0] * x[0] + pow(x[1] - 1, 2);
+        }
+
+        void g11Constraints(double *x, double *g) {
+            g[0] = equality(x[1] - x[0] * x[0]);
+        }
+
+        double g12(double *x) {
+            return -(100 - pow(x[0] - 5, 2) - pow(x[1] - 5, 2) - pow(x[2] - 5, 2)) / 100;
+        }
+
+        void g12Constraints(double *x, double *g) {
+            // feasible inside any of the 9^3 spheres centred on (p, q, r),
+            // p, q, r = 1, ..., 9. The nearest centre is found per coordinate.
+            double distance = 0;
+            for (int i = 0; i < 3; i++) {
+                double centre = std::min(std::max(std::round(x[i]), 1.0), 9.0);
+                distance += (x[i] - centre) * (x[i] - centre);
+            }
+            g[0] = distance - 0.0625;
+        }
+
+        double g13(double *x) {
+            return exp(x[0] * x[1] * x[2] * x[3] * x[4]);
+        }
+
+        void g13Constraints(double *x, double *g) {
+            g[0] = equality(x[0] * x[0] + x[1] * x[1] + x[2] * x[2] + x[3] * x[3] + x[4] * x[4] - 10);
+            g[1] = equality(x[1] * x[2] - 5 * x[3] * x[4]);
+            g[2] = equality(pow(x[0], 3) + pow(x[1], 3) + 1);
+        }
+
+        double g14(double *x) {
+            static const double c[10] = {-6.089, -17.164, -34.054, -5.914, -24.721,
+                                         -14.986, -24.1, -10.708, -26.662, -22.179};
+            double sum = 0;
+            for (int i = 0; i < 10; i++)
+                sum += x[i];
+            double f = 0;
+            for (int i = 0; i < 10; i++)
+                f += x[i] * (c[i] + log(x[i] / sum));
+            return f;
+        }
+
+        void g14Constraints(double *x, double *g) {
+            g[0] = equality(x[0] + 2 * x[1] + 2 * x[2] + x[5] + x[9] - 2);
+            g[1] = equality(x[3] + 2 * x[4] + x[5] + x[6] - 1);
+            g[2] = equality(x[2] + x[6] + x[7] + 2 * x[8] + x[9] - 1);
+        }
+
+        double g15(double *x) {
+            return 1000 - x[0] * x[0] - 2 * x[1] * x[1] - x[2] * x[2] - x[0] * x[1] - x[0] * x[2];
+        }
+
+        void g15Constraints(double *x, double *g) {
+            g[0] = equality(x[0] * x[0] + x[1] * x[1] + x[2] * x[2] - 25);
+            g[1] = equality(8 * x[0] + 14 * x[1] + 7 * x[2] - 56);
+        }
+
+        /**
+         * @brief the intermediate quantities of g16
+         */
+        struct G16 {
+            double y[18];
+            double c[18];
+
+            explicit G16(const double *x) {
+                y[1] = x[1] + x[2] + 41.6;
+                c[1] = 0.024 * x[3] - 4.62;
+                y[2] = 12.5 / c[1] + 12;
+                c[2] = 0.0003535 * x[0] * x[0] + 0.5311 * x[0] + 0.08705 * y[2] * x[0];
+                c[3] = 0.052 * x[0] + 78 + 0.002377 * y[2] * x[0];
+                y[3] = c[2] / c[3];
+                y[4] = 19 * y[3];
+                c[4] = 0.04782 * (x[0] - y[3]) + 0.1956 * pow(x[0] - y[3], 2) / x[1] + 0.6376 * y[4]
+                       + 1.594 * y[3];
+                c[5] = 100 * x[1];
+                c[6] = x[0] - y[3] - y[4];
+                c[7] = 0.950 - c[4] / c[5];
+                y[5] = c[6] * c[7];
+                y[6] = x[0] - y[5] - y[4] - y[3];
+                c[8] = (y[5] + y[4]) * 0.995;
+                y[7] = c[8] / y[1];
+                y[8] = c[8] / 3798;
+                c[9] = y[7] - 0.0663 * y[7] / y[8] - 0.3153;
+                y[9] = 96.82 / c[9] + 0.321 * y[1];
+                y[10] = 1.29 * y[5] + 1.258 * y[4] + 2.29 * y[3] + 1.71 * y[6];
+                y[11] = 1.71 * x[0] - 0.452 * y[4] + 0.580 * y[3];
+                c[10] = 12.3 / 752.3;
+                c[11] = (1.75 * y[2]) * (0.995 * x[0]);
+                c[12] = 0.995 * y[10] + 1998;
+                y[12] = c[10] * x[0] + c[11] / c[12];
+                y[13] = c[12] - 1.75 * y[2];
+                y[14] = 3623 + 64.4 * x[1] + 58.4 * x[2] + 146312 / (y[9] + x[4]);
+                c[13] = 0.995 * y[10] + 60.8 * x[1] + 48 * x[3] - 0.1121 * y[14] - 5095;
+                y[15] = y[13] / c[13];
+                y[16] = 148000 - 331000 * y[15] + 40 * y[13] - 61 * y[15] * y[13];
+                c[14] = 2324 * y[10] - 28740000 * y[2];
+                y[17] = 14130000 - 1328 * y[10] - 531 * y[11] + c[14] / c[12];
+                c[15] = y[13] / y[15] - y[13] / 0.52;
+                c[16] = 1.104 - 0.72 * y[15];
+                c[17] = y[9] + x[4];
+            }
+        };
+
+        double g16(double *x) {
+            G16 v(x);
+            return 0.000117 * v.y[14] + 0.1365 + 0.00002358 * v.y[13] + 0.000001502 * v.y[16]
+                   + 0.0321 * v.y[12] + 0.004324 * v.y[5] + 0.0001 * v.c[15] / v.c[16]
+                   + 37.48 * v.y[2] / v.c[12] - 0.0000005843 * v.y[17];
+        }
+
+        void g16Constraints(double *x, double *g) {
+            static const double lower[18] = {0, 213.1, 17.505, 11.275, 214.228, 7.458, 0.961, 1.612, 0.146,
+                                             107.99, 922.693, 926.832, 18.766, 1072.163, 8961.448, 0.063,
+                                             71084.33, 2802713};
+            static const double upper[18] = {0, 405.23, 1053.6667, 35.03, 665.585, 584.463, 265.916, 7.046,
+                                             0.222, 273.366, 1286.105, 1444.046, 537.141, 3247.039, 26844.086,
+                                             0.386, 140000, 12146108};
+            G16 v(x);
+            g[0] = 0.28 / 0.72 * v.y[5] - v.y[4];
+            g[1] = x[2] - 1.5 * x[1];
+            g[2] = 3496 * v.y[2] / v.c[12] - 21;
+            g[3] = 110.6 + v.y[1] - 62212 / v.c[17];
+            // lower[i] <= y[i] <= upper[i], i = 1, ..., 17
+            for (int i = 1; i <= 17; i++) {
+                g[2 + 2 * i] = lower[i] - v.y[i];
+                g[3 + 2 * i] = v.y[i] - upper[i];
+            }
+        }
+
+        double g17(double *x) {
+            double f1 = x[0] < 300 ? 30 * x[0] : 31 * x[0];
+            double f2 = x[1] < 100 ? 28 * x[1] : (x[1] < 200 ? 29 * x[1] : 30 * x[1]);
+            return f1 + f2;
+        }
+
+        void g17Constraints(double *x, double *g) {
+            double a = x[2] * x[3] / 131.078;
+            double b3 = 0.90798 * x[2] * x[2] / 131.078;
+            double b4 = 0.90798 * x[3] * x[3] / 131.078;
+            g[0] = equality(-x[0] + 300 - a * cos(1.48477 - x[5]) + b3 * cos(1.47588));
+            g[1] = equality(-x[1] - a * cos(1.48477 + x[5]) + b4 * cos(1.47588));
+            g[2] = equality(-x[4] - a * sin(1.48477 + x[5]) + b4 * sin(1.47588));
+            g[3] = equality(200 - a * sin(1.48477 - x[5]) + b3 * sin(1.47588));
+        }
+
+        double g18(double *x) {
+            return -0.5 * (x[0] * x[3] - x[1] * x[2] + x[2] * x[8] - x[4] * x[8] + x[4] * x[7] - x[5] * x[6]);
+        }
+
+        void g18Constraints(double *x, double *g) {
+            g[0] = x[2] * x[2] + x[3] * x[3] - 1;
+            g[1] = x[8] * x[8] - 1;
+            g[2] = x[4] * x[4] + x[5] * x[5] - 1;
+            g[3] = x[0] * x[0] + pow(x[1] - x[8], 2) - 1;
+            g[4] = pow(x[0] - x[4], 2) + pow(x[1] - x[5], 2) - 1;
+            g[5] = pow(x[0] - x[6], 2) + pow(x[1] - x[7], 2) - 1;
+            g[6] = pow(x[2] - x[4], 2) + pow(x[3] - x[5], 2) - 1;
+            g[7] = pow(x[2] - x[6], 2) + pow(x[3] - x[7], 2) - 1;
+            g[8] = x[6] * x[6] + pow(x[7] - x[8], 2) - 1;
+            g[9] = x[1] * x[2] - x[0] * x[3];
+            g[10] = -x[2] * x[8];
+            g[11] = x[4] * x[8];
+            g[12] = x[5] * x[6] - x[4] * x[7];
+        }
+
+        namespace g19Data {
+            const double a[10][5] = {
+                    {-16, 2,  0,  1,   0},
+                    {0,   -2, 0,  0.4, 2},
+                    {-3.5, 0, 2,  0,   0},
+                    {0,   -2, 0,  -4,  -1},
+                    {0,   -9, -2, 1,   -2.8},
+                    {2,   0,  -4, 0,   0},
+                    {-1,  -1, -1, -1,  -1},
+                    {-1,  -2, -3, -2,  -1},
+                    {1,   2,  3,  4,   5},
+                    {1,   1,  1,  1,   1}
+            };
+            const double b[10] = {-40, -2, -0.25, -4, -4, -1, -40, -60, 5, 1};
+            const double c[5][5] = {
+                    {30,  -20, -10, 32,  -10},
+                    {-20, 39,  -6,  -31, 32},
+                    {-10, -6,  10,  -6,  -10},
+                    {32,  -31, -6,  39,  -20},
+                    {-10, 32,  -10, -20, 30}
+            };
+            const double d[5] = {4, 8, 10, 6, 2};
+            const double e[5] = {-15, -27, -36, -18, -12};
+        }
+
+        double g19(double *x) {
+            using namespace g19Data;
+            const double *y = x + 10;
+            double f = 0;
+            for (int j = 0; j < 5; j++) {
+                for (int i = 0; i < 5; i++)
+                    f += c[i][j] * y[i] * y[j];
+                f += 2 * d[j] * y[j] * y[j] * y[j];
+            }
+            for (int i = 0; i < 10; i++)
+                f -= b[i] * x[i];
+            return f;
+        }
+
+        void g19Constraints(double *x, double *g) {
+            using namespace g19Data;
+            const double *y = x + 10;
+            for (int j = 0; j < 5; j++) {
+                double value = -3 * d[j] * y[j] * y[j] - e[j];
+                for (int i = 0; i < 5; i++)
+                    value -= 2 * c[i][j] * y[i];
+                for (int i = 0; i < 10; i++)
+                    value += a[i][j] * x[i];
+                g[j] = value;
+            }
+        }
+
+        namespace g20Data {
+            const double a[24] = {0.0693, 0.0577, 0.05, 0.2, 0.26, 0.55, 0.06, 0.1, 0.12, 0.18, 0.1, 0.09,
+                                  0.0693, 0.0577, 0.05, 0.2, 0.26, 0.55, 0.06, 0.1, 0.12, 0.18, 0.1, 0.09};
+            const double b[24] = {44.094, 58.12, 58.12, 137.4, 120.9, 170.9, 62.501, 84.94, 133.425, 82.507,
+                                  46.07, 60.097, 44.094, 58.12, 58.12, 137.4, 120.9, 170.9, 62.501, 84.94,
+                                  133.425, 82.507, 46.07, 60.097};
+            const double c[12] = {123.7, 31.7, 45.7, 14.7, 84.7, 27.7, 49.7, 7.1, 2.1, 17.7, 0.85, 0.64};
+            const double d[12] = {31.244, 36.12, 34.784, 92.7, 82.7, 91.6, 56.708, 82.7, 80.8, 64.517, 49.4,
+                                  49.1};
+            const double e[6] = {0.1, 0.3, 0.4, 0.3, 0.6, 0.3};
+            const double k = 0.7302 * 530 * (14.7 / 40);
+        }
+
+        double g20(double *x) {
+            double f = 0;
+            for (int i = 0; i < 24; i++)
+                f += g20Data::a[i] * x[i];
+            return f;
+        }
+
+        void g20Constraints(double *x, double *g) {
+            using namespace g20Data;
+            double sum = 0, first = 0, second = 0, firstOverD = 0;
+            for (int i = 0; i < 24; i++)
+                sum += x[i];
+            for (int i = 0; i < 12; i++) {
+                first += x[i] / b[i];
+                second += x[i + 12] / b[i + 12];
+                firstOverD += x[i] / d[i];
+            }
+            for (int i = 0; i < 3; i++)
+                g[i] = (x[i] + x[i + 12]) / (sum + e[i]);
+            for (int i = 3; i < 6; i++)
+                g[i] = (x[i + 3] + x[i + 15]) / (sum + e[i]);
+            for (int i = 0; i < 12; i++)
+                g[6 + i] = equality(x[i + 12] / (b[i + 12] * second) - c[i] * x[i] / (40 * b[i] * first));
+            g[18] = equality(sum - 1);
+            g[19] = equality(firstOverD + k * second - 1.671);
+        }
+
+        double g21(double *x) {
+            return x[0];
+        }
+
+        void g21Constraints(double *x, double *g) {
+            g[0] = -x[0] + 35 * pow(x[1], 0.6) + 35 * pow(x[2], 0.6);
+            g[1] = equality(-300 * x[2] + 7500 * x[4] - 7500 * x[5] - 25 * x[3] * x[4] + 25 * x[3] * x[5]
+                            + x[2] * x[3]);
+            g[2] = equality(100 * x[1] + 155.365 * x[3] + 2500 * x[6] - x[1] * x[3] - 25 * x[3] * x[6]
+                            - 15536.5);
+            g[3] = equality(-x[4] + log(-x[3] + 900));
+            g[4] = equality(-x[5] + log(x[3] + 300));
+            g[5] = equality(-x[6] + log(-2 * x[3] + 700));
+        }
+
+        double g22(double *x) {
+            return x[0];
+        }
+
+        void g22Constraints(double *x, double *g) {
+            // x1 to x22 of the report
+            auto X = [x](int i) { return x[i - 1]; };
+            g[0] = -X(1) + pow(X(2), 0.6) + pow(X(3), 0.6) + pow(X(4), 0.6);
+            double h[19] = {
+                    X(5) - 100000 * X(8) + 1e7,
+                    X(6) + 100000 * X(8) - 100000 * X(9),
+                    X(7) + 100000 * X(9) - 5e7,
+                    X(5) + 100000 * X(10) - 3.3e7,
+                    X(6) + 100000 * X(11) - 4.4e7,
+                    X(7) + 100000 * X(12) - 6.6e7,
+                    X(5) - 120 * X(2) * X(13),
+                    X(6) - 80 * X(3) * X(14),
+                    X(7) - 40 * X(4) * X(15),
+                    X(8) - X(11) + X(16),
+                    X(9) - X(12) + X(17),
+                    -X(18) + log(X(10) - 100),
+                    -X(19) + log(-X(8) + 300),
+                    -X(20) + log(X(16)),
+                    -X(21) + log(-X(9) + 400),
+                    -X(22) + log(X(17)),
+                    -X(8) - X(10) + X(13) * X(18) - X(13) * X(19) + 400,
+                    X(8) - X(9) - X(11) + X(14) * X(20) - X(14) * X(21) + 400,
+                    X(9) - X(12) - 4.60517 * X(15) + X(15) * X(22) + 100
+            };
+            for (int i = 0; i < 19; i++)
+                g[1 + i] = equality(h[i]);
+        }
+
+        double g23(double *x) {
+            return -9 * x[4] - 15 * x[7] + 6 * x[0] + 16 * x[1] + 10 * (x[5] + x[6]);
+        }
+
+        void g23Constraints(double *x, double *g) {
+            g[0] = x[8] * x[2] + 0.02 * x[5] - 0.025 * x[4];
+            g[1] = x[8] * x[3] + 0.02 * x[6] - 0.015 * x[7];
+            g[2] = equality(x[0] + x[1] - x[2] - x[3]);
+            g[3] = equality(0.03 * x[0] + 0.01 * x[1] - x[8] * (x[2] + x[3]));
+            g[4] = equality(x[2] + x[5] - x[4]);
+            g[5] = equality(x[3] + x[6] - x[7]);
+        }
+
+        double g24(double *x) {
+            return -x[0] - x[1];
+        }
+
+        void g24Constraints(double *x, double *g) {
+            g[0] = -2 * pow(x[0], 4) + 8 * pow(x[0], 3) - 8 * x[0] * x[0] + x[1] - 2;
+            g[1] = -4 * pow(x[0], 4) + 32 * pow(x[0], 3) - 88 * x[0] * x[0] + 96 * x[0] + x[1] - 36;
+        }
+
+        TestProblem makeProblem(const std::string &name, const DoubleVector &lb, const DoubleVector &ub,
+                                CostFunction cost, BatchCostFunction batchCost,
+                                ConstraintFunction constraints, int numConstraints,
+                                double bestKnownFitness, const DoubleVector &bestKnownSolution) {
+            TestProblem problem;
+            problem.name = name;
+            problem.numParameters = (int) lb.size();
+            problem.lb = lb;
+            problem.ub = ub;
+            for (size_t i = 0; i < lb.size(); i++)
+                problem.startingValues.push_back(lb[i] + 0.75 * (ub[i] - lb[i]));
+            problem.cost = cost;
+            problem.batchCost = batchCost;
+            problem.constraints = constraints;
+            problem.numConstraints = numConstraints;
+            problem.bestKnownFitness = bestKnownFitness;
+            problem.bestKnownSolution = bestKnownSolution;
+            return problem;
+        }
+
+        template<class Terms>
+        TestProblem makeScalableProblem(const std::string &name, int numParameters, double bound,
+                                        double optimum) {
+            return makeProblem(name, DoubleVector(numParameters, -bound), DoubleVector(numParameters, bound),
+                               scalableCostFor<Terms>(numParameters), scalableBatchCost<Terms>, nullptr, 0,
+                               0.0, DoubleVector(numParameters, optimum));
+        }
+
+        /**
+         * @brief the scalable problem @param name with @param numParameters,
+         * which has no cost function when that size is not instantiated
+         */
+        TestProblem makeScalableProblem(const std::string &name, int numParameters) {
+            if (name == "rosenbrock")
+                return makeScalableProblem<RosenbrockTerms>(name, numParameters, 30, 1);
+            if (name == "rastrigin")
+                return makeScalableProblem<RastriginTerms>(name, numParameters, 5.12, 0);
+            if (name == "ackley")
+                return makeScalableProblem<AckleyTerms>(name, numParameters, 32.768, 0);
+            return makeScalableProblem<GriewankTerms>(name, numParameters, 600, 0);
+        }
+
+        bool isScalable(const std::string &name) {
+            return name == "rosenbrock" || name == "rastrigin" || name == "ackley" || name == "griewank";
+        }
+
+        std::vector<TestProblem> makeTestProblems() {
+            std::vector<TestProblem> problems;
+            for (const char *name: {"rosenbrock", "rastrigin", "ackley", "griewank"})
+                problems.push_back(makeScalableProblem(name, 10));
+
+            problems.push_back(makeProblem(
+                    "beale", {-4.5, -4.5}, {4.5, 4.5}, beale, rowBatchCost<beale>, nullptr, 0,
+                    0.0, {3, 0.5}));
+
+            DoubleVector g01ub(13, 1.0);
+            g01ub[9] = g01ub[10] = g01ub[11] = 100;
+            problems.push_back(makeProblem(
+                    "g01", DoubleVector(13, 0.0), g01ub, g01, rowBatchCost<g01>, g01Constraints, 9,
+                    -15.0, {1, 1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 1}));
+            problems.push_back(makeProblem(
+                    "g02", DoubleVector(20, 0.0), DoubleVector(20, 10.0), g02, rowBatchCost<g02>,
+                    g02Constraints, 2, -0.80361910412559, {}));
+            problems.push_back(makeProblem(
+                    "g03", DoubleVector(10, 0.0), DoubleVector(10, 1.0), g03, rowBatchCost<g03>,
+                    g03Constraints, 1, -1.00050010001000, {}));
+            problems.push_back(makeProblem(
+                    "g04", {78, 33, 27, 27, 27}, {102, 45, 45, 45, 45}, g04, rowBatchCost<g04>,
+                    g04Constraints, 6, -30665.5386717834,
+                    {78, 33, 29.9952560256815985, 45, 36.7758129057882073}));
+            problems.push_back(makeProblem(
+                    "g05", {0, 0, -0.55, -0.55}, {1200, 1200, 0.55, 0.55}, g05, rowBatchCost<g05>,
+                    g05Constraints, 5, 5126.4967140071,
+                    {679.945148297028709, 1026.06697600004691, 0.118876369094410433, -0.396233485215178266}));
+            problems.push_back(makeProblem(
+                    "g06", {13, 0}, {100, 100}, g06, rowBatchCost<g06>, g06Constraints, 2,
+                    -6961.81387558015, {14.09500000000000064, 0.8429607892154795668}));
+            problems.push_back(makeProblem(
+                    "g07", DoubleVector(10, -10.0), DoubleVector(10, 10.0), g07, rowBatchCost<g07>,
+                    g07Constraints, 8, 24.3062090681,
+                    {2.17199634142692, 2.3636830416034, 8.77392573913157, 5.09598443745173,
+                     0.990654756560493, 1.43057392853463, 1.32164415364306, 9.82872576524495,
+                     8.2800915887356, 8.3759266477347}));
+            problems.push_back(makeProblem(
+                    "g08", {0, 0}, {10, 10}, g08, rowBatchCost<g08>, g08Constraints, 2,
+                    -0.0958250414180359, {1.22797135260752599, 4.24537336612274885}));
+            problems.push_back(makeProblem(
+                    "g09", DoubleVector(7, -10.0), DoubleVector(7, 10.0), g09, rowBatchCost<g09>,
+                    g09Constraints, 4, 680.630057374402,
+                    {2.33049935147405174, 1.95137236847114592, -0.477541399510615805, 4.36572624923625874,
+                     -0.624486959100388983, 1.03813099410962173, 1.5942266780671519}));
+            problems.push_back(makeProblem(
+                    "g10", {100, 1000, 1000, 10, 10, 10, 10, 10},
+                    {10000, 10000, 10000, 1000, 1000, 1000, 1000, 1000}, g10, rowBatchCost<g10>,
+                    g10Constraints, 6, 7049.24802052867,
+                    {579.306685017979589, 1359.97067807935605, 5109.97065743133317, 182.01769963061534,
+                     295.601173702746792, 217.982300369384632, 286.41652592786852, 395.601173702746735}));
+            problems.push_back(makeProblem(
+                    "g11", {-1, -1}, {1, 1}, g11, rowBatchCost<g11>, g11Constraints, 1,
+                    0.7499, {-0.707036070037170616, 0.500000004333606807}));
+            problems.push_back(makeProblem(
+                    "g12", {0, 0, 0}, {10, 10, 10}, g12, rowBatchCost<g12>, g12Constraints, 1,
+                    -1.0, {5, 5, 5}));
+            problems.push_back(makeProblem(
+                    "g13", {-2.3, -2.3, -3.2, -3.2, -3.2}, {2.3, 2.3, 3.2, 3.2, 3.2}, g13, rowBatchCost<g13>,
+                    g13Constraints, 3, 0.053941514041898,
+                    {-1.71714224003, 1.59572124049468, 1.8272502406271, -0.763659881912867,
+                     -0.76365986736498}));
+            problems.push_back(makeProblem(
+                    "g14", DoubleVector(10, 0.0), DoubleVector(10, 10.0), g14, rowBatchCost<g14>,
+                    g14Constraints, 3, -47.7648884594915,
+                    {0.0406684113216282, 0.147721240492452, 0.783205732104114, 0.00141433931889084,
+                     0.485293636780388, 0.000693183051556082, 0.0274052040687766, 0.0179509660214818,
+                     0.0373268186859717, 0.0968844604336845}));
+            problems.push_back(makeProblem(
+                    "g15", {0, 0, 0}, {10, 10, 10}, g15, rowBatchCost<g15>, g15Constraints, 2,
+                    961.715022289961,
+                    {3.51212812611795133, 0.216987510429556135, 3.55217854929179921}));
+            problems.push_back(makeProblem(
+                    "g16", {704.4148, 68.6, 0, 193, 25}, {906.3855, 288.88, 134.75, 287.0966, 84.1988},
+                    g16, rowBatchCost<g16>, g16Constraints, 38, -1.90515525853479,
+                    {705.174537070090537, 68.5999999999999943, 102.899999999999991, 282.324931593660324,
+                     37.5841164258054832}));
+            problems.push_back(makeProblem(
+                    "g17", {0, 0, 340, 340, -1000, 0}, {400, 1000, 420, 420, 1000, 0.5236}, g17,
+                    rowBatchCost<g17>, g17Constraints, 4, 8853.53967480648,
+                    {201.784467214523659, 99.9999999999999005, 383.071034852773266, 420,
+                     -10.9076584514292652, 0.0731482312084287128}));
+            DoubleVector g18lb(9, -10.0), g18ub(9, 10.0);
+            g18lb[8] = 0;
+            g18ub[8] = 20;
+            problems.push_back(makeProblem(
+                    "g18", g18lb, g18ub, g18, rowBatchCost<g18>, g18Constraints, 13, -0.866025403784439,
+                    {-0.657776192427943163, -0.153418773482438542, 0.323413871675240938,
+                     -0.946257611651304398, -0.657776194376798906, -0.753213434632691414,
+                     0.323413874123576972, -0.346462947962331735, 0.59979466285217542}));
+            problems.push_back(makeProblem(
+                    "g19", DoubleVector(15, 0.0), DoubleVector(15, 10.0), g19, rowBatchCost<g19>,
+                    g19Constraints, 5, 32.6555929502463,
+                    {1.66991341326291344e-17, 3.95378229282456509e-16, 3.94599045143233784,
+                     1.06036597479721211e-16, 3.2831773458454161, 9.99999999999999822,
+                     1.12829414671605333e-17, 1.2026194599794709e-17, 2.50706276000769697e-15,
+                     2.24624122987970677e-15, 0.370764847417013987, 0.278456024942955571,
+                     0.523838487672241171, 0.388620152510322781, 0.298156764974678579}));
+            problems.push_back(makeProblem(
+                    "g20", DoubleVector(24, 0.0), DoubleVector(24, 10.0), g20, rowBatchCost<g20>,
+                    g20Constraints, 20, 0.2049794002, {}));
+            problems.push_back(makeProblem(
+                    "g21", {0, 0, 0, 100, 6.3, 5.9, 4.5}, {1000, 40, 40, 300, 6.7, 6.4, 6.25}, g21,
+                    rowBatchCost<g21>, g21Constraints, 6, 193.724510070035,
+                    {193.724510070034967, 5.56944131553368433e-27, 17.3191887294084914, 100.047897801386839,
+                     6.68445185362377892, 5.99168428444264833, 6.21451648886070451}));
+            problems.push_back(makeProblem(
+                    "g22",
+                    {0, 0, 0, 0, 0, 0, 0, 100, 100, 100.01, 100, 100, 0, 0, 0, 0.01, 0.01,
+                     -4.7, -4.7, -4.7, -4.7, -4.7},
+                    {20000, 1e6, 1e6, 1e6, 4e7, 4e7, 4e7, 299.99, 399.99, 300, 400, 600, 500, 500, 500,
+                     300, 400, 6.25, 6.25, 6.25, 6.25, 6.25},
+                    g22, rowBatchCost<g22>, g22Constraints, 20, 236.430975504001, {}));
+            problems.push_back(makeProblem(
+                    "g23", {0, 0, 0, 0, 0, 0, 0, 0, 0.01}, {300, 300, 100, 200, 100, 300, 100, 200, 0.03}, g23,
+                    rowBatchCost<g23>, g23Constraints, 6, -400.055099999999584,
+                    {0.00510000000000259465, 99.9947000000000514, 9.01920162996045897e-18, 99.9999000000000535,
+                     0.000100000000027086086, 2.75700683389584542e-14, 99.9999999999999574, 200,
+                     0.0100000100000100008}));
+            problems.push_back(makeProblem(
+                    "g24", {0, 0}, {3, 4}, g24, rowBatchCost<g24>, g24Constraints, 2, -5.50801327159536,
+                    {2.32952019747762, 3.17849307411774}));
+            return problems;
+        }
+    }
+
+    SRES TestProblem::makeSRES(int populationSize, int numGenerations, int childrate, bool batch) const {
+        SRES sres = batch
+                    ? SRES(batchCost, populationSize, numGenerations, startingValues, lb, ub, childrate)
+                    : SRES(cost, populationSize, numGenerations, startingValues, lb, ub, childrate);
+        if (constraints)
+            sres.setConstraintFunction(constraints, numConstraints);
+        return sres;
+    }
+
+    const std::vector<TestProblem> &getTestProblems() {
+        static const std::vector<TestProblem> problems = makeTestProblems();
+        return problems;
+    }
+
+    TestProblem getTestProblem(const std::string &name, int numParameters) {
+        if (isScalable(name) && numParameters != 0) {
+            TestProblem problem = makeScalableProblem(name, numParameters);
+            if (!problem.cost) {
+                INVALID_ARGUMENT_ERROR << "The " << name << " problem can have 2, 5, 10, 20 or 30 parameters, not "
+                                       << numParameters << std::endl;
+            }
+            return problem;
+        }
+        const std::vector<TestProblem> &problems = getTestProblems();
+        auto it = std::find_if(problems.begin(), problems.end(),
+                               [&name](const TestProblem &problem) { return problem.name == name; });
+        if (it == problems.end()) {
+            INVALID_ARGUMENT_ERROR << "There is no test problem called \"" << name << "\"" << std::endl;
+        }
+        if (numParameters != 0 && numParameters != it->numParameters) {
+            INVALID_ARGUMENT_ERROR << "The " << name << " problem has " << it->numParameters
+                                   << " parameters, not " << numParameters << std::endl;
+        }
+        return *it;
+    }
+
+}
@@ -0,0 +1,83 @@
+#ifndef SRES_TESTPROBLEMS_H
+#define SRES_TESTPROBLEMS_H
+
+#include <string>
+#include <vector>
+#include "SRES.h"
+
+namespace opt {
+
+    /**
+     * @brief a standard benchmark problem with its bounds and known optimum.
+     * @details every problem has a per individual cost function and a
+     * BatchCostFunction computing the same values for a block of
+     * individuals. Constrained problems come with a ConstraintFunction for
+     * SRES::setConstraintFunction. Their equality constraints h(x) = 0 are
+     * given as the inequality |h(x)| - 1e-4 <= 0, the tolerance used by the
+     * CEC2006 suite, and maximization problems are negated.
+     */
+    struct TestProblem {
+        std::string name;
+
+        int numParameters;
+
+        DoubleVector lb;
+
+        DoubleVector ub;
+
+        /**
+         * @brief lb + 0.75 (ub - lb). Not the middle of the bounds,
+         * which is the optimum of the symmetric problems.
+         */
+        DoubleVector startingValues;
+
+        CostFunction cost;
+
+        BatchCostFunction batchCost;
+
+        /**
+         * @brief nullptr for an unconstrained problem
+         */
+        ConstraintFunction constraints;
+
+        int numConstraints;
+
+        /**
+         * @brief the best fitness known for the problem. For g20 no feasible
+         * solution is known and this is the fitness of the best, slightly
+         * infeasible, one.
+         */
+        double bestKnownFitness;
+
+        /**
+         * @brief where bestKnownFitness is reached. Empty when not listed.
+         */
+        DoubleVector bestKnownSolution;
+
+        /**
+         * @brief an SRES for this problem, evaluating with batchCost when
+         * @param batch is true and cost otherwise, and with the constraints set
+         */
+        [[nodiscard]] SRES makeSRES(int populationSize, int numGenerations, int childrate = 7,
+                                    bool batch = false) const;
+    };
+
+    /**
+     * @brief the problems of the library: rosenbrock, rastrigin, ackley and
+     * griewank with 10 parameters, beale, and the CEC2006 constrained
+     * problems g01 to g24
+     */
+    const std::vector<TestProblem> &getTestProblems();
+
+    /**
+     * @brief the problem called @param name.
+     * @details rosenbrock, rastrigin, ackley and griewank can be had with
+     * 2, 5, 10, 20 or 30 @param numParameters. Otherwise numParameters
+     * must be 0, meaning the default, or the size of the problem.
+     * @throws std::invalid_argument for an unknown problem or size
+     */
+    TestProblem getTestProblem(const std::string &name, int numParameters = 0);
+
+}
+
+#endif //SRES_TESTPROBLEMS_H
@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+
+namespace opt {
+
+    ThreadPool::ThreadPool(unsigned int numThreads) {
+        if (numThreads < 1)
+            numThreads = 1;
+        workers_.reserve(numThreads - 1);
+        for (unsigned int i = 1; i < numThreads; i++)
+            workers_.emplace_back(&ThreadPool::work, this);
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker: workers_)
+            worker.join();
+    }
+
+    unsigned int ThreadPool::size() const {
+        return workers_.size() + 1;
+    }
+
+    void ThreadPool::drain() {
+        size_t index;
+        while ((index = next_.fetch_add(1, std::memory_order_relaxed)) < end_) {
+            try {
+                invoker_(fn_, index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+    }
+
+    void ThreadPool::work() {
+        unsigned long long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || jobId_ != seen; });
+                if (stop_)
+                    return;
+                seen = jobId_;
+            }
+
+            drain();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--busyWorkers_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::run(size_t begin, size_t end, Invoker invoker, void *fn) {
+        if (begin >= end)
+            return;
+
+        std::lock_guard<std::mutex> jobLock(jobMutex_);
+
+        // nothing to share, so don't pay for waking the workers
+        if (workers_.empty() || end - begin == 1) {
+            for (size_t i = begin; i < end; i++)
+                invoker(fn, i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            invoker_ = invoker;
+            fn_ = fn;
+            end_ = end;
+            next_.store(begin, std::memory_order_relaxed);
+            error_ = nullptr;
+            busyWorkers_ = workers_.size();
+            jobId_++;
+        }
+        wake_.notify_all();
+
+        drain();
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [&] { return busyWorkers_ == 0; });
+            error = error_;
+            error_ = nullptr;
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+}
@@ -0,0 +1,117 @@
+#ifndef SRES_THREADPOOL_H
+#define SRES_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace opt {
+
+    /**
+     * @brief A fixed size pool of worker threads used to
+     * evaluate the fitness of a block of individuals concurrently.
+     * @details work is handed out one index at a time from a
+     * shared atomic counter so that objectives with very
+     * different run times still balance across the workers.
+     * The calling thread participates in the work, so a pool
+     * of size n starts n - 1 background threads. Dispatching
+     * a job does not allocate.
+     */
+    class ThreadPool {
+
+    public:
+
+        /**
+         * @brief construct a pool that runs work on @param numThreads
+         * threads (including the calling thread). Values less than
+         * 1 are treated as 1.
+         */
+        explicit ThreadPool(unsigned int numThreads);
+
+        /**
+         * @brief stops and joins all worker threads
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief the number of threads work is distributed over,
+         * including the calling thread.
+         */
+        [[nodiscard]] unsigned int size() const;
+
+        /**
+         * @brief call @param fn once for every index in [begin, end)
+         * and block until all calls have returned.
+         * @details The order in which indices are processed is not
+         * specified, so @param fn must only write to locations owned
+         * by its index. If one or more calls throw, the first exception
+         * is rethrown here after all other calls have completed.
+         */
+        template<class Function>
+        void parallelFor(size_t begin, size_t end, Function &&fn) {
+            run(begin, end, &ThreadPool::invoke<std::remove_reference_t<Function>>,
+                const_cast<void *>(static_cast<const void *>(&fn)));
+        }
+
+    private:
+
+        using Invoker = void (*)(void *, size_t);
+
+        template<class Function>
+        static void invoke(void *fn, size_t index) {
+            (*static_cast<Function *>(fn))(index);
+        }
+
+        void run(size_t begin, size_t end, Invoker invoker, void *fn);
+
+        void work();
+
+        void drain();
+
+        std::vector<std::thread> workers_;
+
+        /**
+         * @brief serializes jobs when a pool is shared
+         * between optimizers
+         */
+        std::mutex jobMutex_;
+
+        std::mutex mutex_;
+
+        std::condition_variable wake_;
+
+        std::condition_variable done_;
+
+        /**
+         * @brief incremented for every job so sleeping workers
+         * can tell a new job from a spurious wake up
+         */
+        unsigned long long jobId_ = 0;
+
+        unsigned int busyWorkers_ = 0;
+
+        bool stop_ = false;
+
+        Invoker invoker_ = nullptr;
+
+        void *fn_ = nullptr;
+
+        std::atomic<size_t> next_{0};
+
+        size_t end_ = 0;
+
+        std::exception_ptr error_;
+    };
+
+}
+
+#endif //SRES_THREADPOOL_H
@@ -0,0 +1,375 @@
+/**
+ * Measures how many evaluations SRES needs to solve the problems of
+ * TestProblems.h, in the manner of COCO, so that a change which makes
+ * generations faster but the search worse shows up.
+ *
+ * Each run records the first evaluation, and the time, at which a feasible
+ * point came within each target precision 1e-1, 1e-2, ..., 1e-8 of the
+ * best known fitness. A run stops once it reaches the last target or has
+ * used budgetPerParameter x numParameters evaluations. For every engine,
+ * problem and target the report gives the expected running time
+ *
+ *     ERT = (evaluations of all runs up to the target, or to the end of
+ *            the run when the target was not reached) / successful runs
+ *
+ * in evaluations and seconds, and the empirical run length distribution:
+ * the sorted evaluations to target of the successful runs out of numRuns.
+ *
+ * Two engines are compared with the same population size, child rate and
+ * pf: opt::SRES, whose runs are done in parallel, one per thread, and the
+ * legacy ESStep engine of sresFromMoonfit. The legacy engine draws from
+ * the global rand() so its runs are done one after the other; it is only
+ * compiled in when SRES_ERT_LEGACY is defined. Evaluations are calls of
+ * the cost function. With pf > 0 both engines evaluate every child, so
+ * their counts are comparable.
+ *
+ * The JSON report holds the summary and the CSV one row per run and target.
+ *
+ * usage: ERTRunner [numRuns] [budgetPerParameter] [reportFile.json] [runsFile.csv] [problem,problem,...]
+ *
+ * where a problem is a name from TestProblems.h, optionally followed by
+ * :numParameters, and a report file of - is written to stdout.
+ */
+
+#include "SRES.h"
+#include "TestProblems.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef SRES_ERT_LEGACY
+#include "ESES.h"
+#endif
+
+using namespace opt;
+
+namespace {
+
+    const int NumTargets = 8;
+
+    const double Targets[NumTargets] = {1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8};
+
+    const int PopulationSize = 30;
+
+    const int ChildRate = 7;
+
+    // probability of ranking by fitness regardless of feasibility
+    const double Pf = 0.45;
+
+    /**
+     * @brief notes when a run first reaches each target
+     */
+    struct Recorder {
+        const TestProblem *problem;
+        unsigned long long budget;
+        unsigned long long numEvaluations = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int nextTarget = 0;
+        unsigned long long hitEvaluations[NumTargets]{};
+        double hitSeconds[NumTargets]{};
+
+        Recorder(const TestProblem *problem, unsigned long long budget)
+                : problem(problem), budget(budget) {}
+
+        void record(double fitness, bool feasible) {
+            numEvaluations++;
+            if (!feasible)
+                return;
+            double precision = fitness - problem->bestKnownFitness;
+            while (nextTarget < NumTargets && precision <= Targets[nextTarget]) {
+                hitEvaluations[nextTarget] = numEvaluations;
+                hitSeconds[nextTarget] = seconds();
+                nextTarget++;
+            }
+        }
+
+        [[nodiscard]] bool done() const {
+            return nextTarget == NumTargets || numEvaluations >= budget;
+        }
+
+        [[nodiscard]] double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    /**
+     * @brief the recorder of the run on this thread. The cost functions
+     * are plain function pointers, so this is how they find it.
+     */
+    thread_local Recorder *recorder = nullptr;
+
+    bool isFeasible(const TestProblem &problem, double *x) {
+        if (!problem.constraints)
+            return true;
+        std::vector<double> g(problem.numConstraints);
+        problem.constraints(x, g.data());
+        return std::all_of(g.begin(), g.end(), [](double value) { return value <= 0; });
+    }
+
+    double recordedCost(double *x) {
+        double fitness = recorder->problem->cost(x);
+        recorder->record(fitness, isFeasible(*recorder->problem, x));
+        return fitness;
+    }
+
+    int stopWhenDone(const GenerationInfo *) {
+        return recorder->done() ? 1 : 0;
+    }
+
+    struct RunResult {
+        std::string engine;
+        unsigned long long seed;
+        unsigned long long numEvaluations;
+        double seconds;
+        int numTargetsHit;
+        unsigned long long hitEvaluations[NumTargets];
+        double hitSeconds[NumTargets];
+    };
+
+    RunResult finish(const std::string &engine, unsigned long long seed, const Recorder &r) {
+        RunResult result{engine, seed, r.numEvaluations, r.seconds(), r.nextTarget, {}, {}};
+        std::copy(r.hitEvaluations, r.hitEvaluations + NumTargets, result.hitEvaluations);
+        std::copy(r.hitSeconds, r.hitSeconds + NumTargets, result.hitSeconds);
+        return result;
+    }
+
+    RunResult runSRES(const TestProblem &problem, unsigned long long seed, unsigned long long budget) {
+        Recorder r(&problem, budget);
+        recorder = &r;
+        // the run is ended by stopWhenDone, the number
+        // of generations is only an upper bound
+        SRES sres(recordedCost, PopulationSize, (int) budget, problem.startingValues, problem.lb, problem.ub,
+                  ChildRate);
+        if (problem.constraints)
+            sres.setConstraintFunction(problem.constraints, problem.numConstraints);
+        sres.setSeed(seed);
+        sres.setPf(Pf);
+        sres.setStopAfterStalledGenerations(0);
+        sres.setGenerationCallback(stopWhenDone);
+        sres.fit();
+        recorder = nullptr;
+        return finish("SRES", seed, r);
+    }
+
+#ifdef SRES_ERT_LEGACY
+    void recordedLegacyCost(double *x, double *f, double *g) {
+        const TestProblem &problem = *recorder->problem;
+        *f = problem.cost(x);
+        bool feasible = true;
+        if (problem.constraints) {
+            problem.constraints(x, g);
+            for (int i = 0; i < problem.numConstraints; i++)
+                feasible = feasible && g[i] <= 0;
+        }
+        recorder->record(*f, feasible);
+    }
+
+    RunResult runLegacy(const TestProblem &problem, unsigned long long seed, unsigned long long budget) {
+        Recorder r(&problem, budget);
+        recorder = &r;
+        std::vector<double> lb = problem.lb, ub = problem.ub;
+        int numGenerations = (int) std::min<unsigned long long>(budget, std::numeric_limits<int>::max());
+        ESParameter **param = makeESParameter();
+        ESPopulation **population = makeESPopulation();
+        ESStatistics **stats = makeESStatistics();
+        ESfcnTrsfm *trsfm = makeTransformFun(problem.numParameters);
+        // a seed of 0 would mean pid * time
+        ESInitial((unsigned int) seed + 1, param, trsfm, recordedLegacyCost, esDefESSlash, problem.numConstraints,
+                  problem.numParameters, ub.data(), lb.data(), PopulationSize, ChildRate * PopulationSize,
+                  numGenerations, esDefGamma, esDefAlpha, esDefVarphi, esDefRetry, population, stats);
+        while (!r.done() && (*stats)->curgen < (*param)->gen)
+            ESStep(population, param, stats, Pf);
+        ESDeInitial(param, population, stats);
+        freeTransformFun(trsfm);
+        recorder = nullptr;
+        return finish("ESStep", seed, r);
+    }
+#endif
+
+    struct Summary {
+        std::string engine;
+        const TestProblem *problem;
+        std::vector<RunResult> runs;
+    };
+
+    std::string number(double value) {
+        if (!std::isfinite(value))
+            return "null";
+        std::ostringstream os;
+        os.precision(9);
+        os << value;
+        return os.str();
+    }
+
+    /**
+     * @brief expected running time to target @param t, in evaluations
+     * or with @param inSeconds in seconds. Infinite when no run got there.
+     */
+    double ert(const std::vector<RunResult> &runs, int t, bool inSeconds) {
+        double total = 0;
+        int successes = 0;
+        for (const RunResult &run: runs) {
+            bool hit = run.numTargetsHit > t;
+            successes += hit;
+            if (inSeconds)
+                total += hit ? run.hitSeconds[t] : run.seconds;
+            else
+                total += (double) (hit ? run.hitEvaluations[t] : run.numEvaluations);
+        }
+        return successes ? total / successes : std::numeric_limits<double>::infinity();
+    }
+
+    std::string toJson(const std::vector<Summary> &summaries, int numRuns, unsigned long long budgetPerParameter) {
+        std::ostringstream os;
+        os << "{\n";
+        os << "  \"numRuns\": " << numRuns << ",\n";
+        os << "  \"budgetPerParameter\": " << budgetPerParameter << ",\n";
+        os << "  \"populationSize\": " << PopulationSize << ",\n";
+        os << "  \"childRate\": " << ChildRate << ",\n";
+        os << "  \"targets\": [";
+        for (int t = 0; t < NumTargets; t++)
+            os << (t ? ", " : "") << Targets[t];
+        os << "],\n";
+        os << "  \"results\": [\n";
+        for (size_t s = 0; s < summaries.size(); s++) {
+            const Summary &summary = summaries[s];
+            auto list = [&](auto &&value) {
+                std::ostringstream items;
+                for (int t = 0; t < NumTargets; t++)
+                    items << (t ? ", " : "") << value(t);
+                return "[" + items.str() + "]";
+            };
+            os << "    {\"engine\": \"" << summary.engine << "\", "
+               << "\"problem\": \"" << summary.problem->name << "\", "
+               << "\"numParameters\": " << summary.problem->numParameters << ",\n";
+            os << "     \"successRate\": " << list([&](int t) {
+                int successes = 0;
+                for (const RunResult &run: summary.runs)
+                    successes += run.numTargetsHit > t;
+                return number((double) successes / (double) summary.runs.size());
+            }) << ",\n";
+            os << "     \"ert\": " << list([&](int t) { return number(ert(summary.runs, t, false)); }) << ",\n";
+            os << "     \"ertSeconds\": " << list([&](int t) { return number(ert(summary.runs, t, true)); })
+               << ",\n";
+            os << "     \"runLengths\": " << list([&](int t) {
+                std::vector<unsigned long long> lengths;
+                for (const RunResult &run: summary.runs)
+                    if (run.numTargetsHit > t)
+                        lengths.push_back(run.hitEvaluations[t]);
+                std::sort(lengths.begin(), lengths.end());
+                std::ostringstream items;
+                for (size_t i = 0; i < lengths.size(); i++)
+                    items << (i ? ", " : "") << lengths[i];
+                return "[" + items.str() + "]";
+            }) << "}" << (s + 1 < summaries.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+        return os.str();
+    }
+
+    std::string toCsv(const std::vector<Summary> &summaries) {
+        std::ostringstream os;
+        os << "engine,problem,numParameters,seed,target,reached,evaluations,seconds\n";
+        for (const Summary &summary: summaries) {
+            for (const RunResult &run: summary.runs) {
+                for (int t = 0; t < NumTargets; t++) {
+                    bool hit = run.numTargetsHit > t;
+                    os << summary.engine << "," << summary.problem->name << ","
+                       << summary.problem->numParameters << "," << run.seed << "," << Targets[t] << ","
+                       << hit << "," << (hit ? run.hitEvaluations[t] : run.numEvaluations) << ","
+                       << number(hit ? run.hitSeconds[t] : run.seconds) << "\n";
+                }
+            }
+        }
+        return os.str();
+    }
+
+    bool write(const std::string &path, const std::string &contents) {
+        if (path.empty() || path == "-") {
+            std::cout << contents;
+            return true;
+        }
+        std::ofstream out(path);
+        out << contents;
+        if (!out)
+            std::cerr << "could not write " << path << std::endl;
+        return (bool) out;
+    }
+
+    /**
+     * @brief the problems with inequality constraints only or none,
+     * whose best known fitness is that of a feasible point
+     */
+    std::vector<TestProblem> defaultProblems() {
+        std::vector<TestProblem> problems;
+        for (const char *name: {"rosenbrock", "rastrigin", "ackley", "griewank"})
+            for (int n: {2, 5, 10})
+                problems.push_back(getTestProblem(name, n));
+        for (const char *name: {"beale", "g01", "g04", "g06", "g07", "g08", "g09", "g10", "g12", "g24"})
+            problems.push_back(getTestProblem(name));
+        return problems;
+    }
+}
+
+int main(int argc, char **argv) {
+    int numRuns = argc > 1 ? std::atoi(argv[1]) : 15;
+    unsigned long long budgetPerParameter = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+    std::string reportFile = argc > 3 ? argv[3] : "";
+    std::string runsFile = argc > 4 ? argv[4] : "";
+    if (numRuns < 1 || budgetPerParameter < 1) {
+        std::cerr << "usage: ERTRunner [numRuns] [budgetPerParameter] [reportFile.json] [runsFile.csv] "
+                     "[problem,problem,...]" << std::endl;
+        return 1;
+    }
+
+    std::vector<TestProblem> problems;
+    if (argc > 5) {
+        std::istringstream names(argv[5]);
+        std::string name;
+        // name or name:numParameters
+        while (std::getline(names, name, ',')) {
+            size_t colon = name.find(':');
+            int numParameters = colon == std::string::npos ? 0 : std::atoi(name.c_str() + colon + 1);
+            problems.push_back(getTestProblem(name.substr(0, colon), numParameters));
+        }
+    } else {
+        problems = defaultProblems();
+    }
+
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<Summary> summaries;
+    for (const TestProblem &problem: problems) {
+        unsigned long long budget = budgetPerParameter * problem.numParameters;
+
+        Summary sres{"SRES", &problem, std::vector<RunResult>(numRuns)};
+        pool.parallelFor(0, numRuns, [&](size_t i) {
+            sres.runs[i] = runSRES(problem, i, budget);
+        });
+        std::cerr << problem.name << " (" << problem.numParameters << "): SRES ERT to 1e-8 "
+                  << ert(sres.runs, NumTargets - 1, false);
+        summaries.push_back(sres);
+
+#ifdef SRES_ERT_LEGACY
+        Summary legacy{"ESStep", &problem, {}};
+        for (int i = 0; i < numRuns; i++)
+            legacy.runs.push_back(runLegacy(problem, i, budget));
+        std::cerr << ", ESStep " << ert(legacy.runs, NumTargets - 1, false);
+        summaries.push_back(legacy);
+#endif
+        std::cerr << std::endl;
+    }
+
+    bool written = write(reportFile, toJson(summaries, numRuns, budgetPerParameter));
+    if (!runsFile.empty())
+        written = write(runsFile, toCsv(summaries)) && written;
+    return written ? 0 : 1;
+}
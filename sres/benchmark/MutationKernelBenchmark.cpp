@@ -0,0 +1,85 @@
+/**
+ * Times the first mutation attempt of one child (variance update,
+ * Gaussian step and bounds check) with every implementation of the
+ * mutation kernel this processor supports, at 10, 100 and 1000
+ * parameters, against the scalar loop mutate() used before, which
+ * called std::exp and OptItem::checkConstraint per parameter.
+ *
+ * usage: MutationKernelBenchmark [numCalls]
+ */
+
+#include "MutationKernel.h"
+#include "OptItems.h"
+#include "RandomNumberGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace opt;
+
+template<class F>
+double timeIt(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+    size_t numCalls = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+
+    for (size_t n: {10, 100, 1000}) {
+        RandomNumberGenerator rng(4);
+        std::vector<double> x(n), variance(n), maxVariance(n, 2.0), lb(n, -5.0), ub(n, 5.0);
+        std::vector<double> varianceNormals(n), stepNormals(n);
+        std::vector<std::uint8_t> outOfBounds(n);
+        rng.fillNormal(varianceNormals.data(), n);
+        rng.fillNormal(stepNormals.data(), n);
+        OptItems optItems(std::vector<double>(n, 0.0), lb, ub);
+
+        // every call starts from the same state, otherwise repeated updates
+        // push variances into denormals and the timings measure those
+        auto reset = [&] {
+            std::fill(x.begin(), x.end(), 0.0);
+            std::fill(variance.begin(), variance.end(), 1.0);
+        };
+        double sink = 0;
+
+        double reference = timeIt([&] {
+            for (size_t call = 0; call < numCalls; call++) {
+                reset();
+                for (size_t j = 0; j < n; j++) {
+                    variance[j] = std::min(variance[j] * std::exp(0.1 + 0.2 * varianceNormals[j]), maxVariance[j]);
+                    double mut = x[j] + variance[j] * stepNormals[j];
+                    outOfBounds[j] = optItems[j].checkConstraint(mut) != 0;
+                    if (!outOfBounds[j])
+                        x[j] = mut;
+                }
+                sink += x[n - 1];
+            }
+        });
+        std::cout << "n = " << n << std::endl;
+        std::cout << "  reference loop: " << reference / numCalls * 1e9 << " ns per child" << std::endl;
+
+        const char *names[] = {"scalar", "avx2", "avx512"};
+        for (SimdLevel level: {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detectSimdLevel())
+                continue;
+            double seconds = timeIt([&] {
+                for (size_t call = 0; call < numCalls; call++) {
+                    reset();
+                    mutationKernel(level, n, x.data(), variance.data(), maxVariance.data(), lb.data(), ub.data(),
+                                   0.1, 0.2, varianceNormals.data(), stepNormals.data(), outOfBounds.data());
+                    sink += x[n - 1];
+                }
+            });
+            std::cout << "  " << names[(int) level] << " kernel: " << seconds / numCalls * 1e9
+                      << " ns per child (" << reference / seconds << "x)" << std::endl;
+        }
+        std::cout << "  (checksum " << sink << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * Compares three ways of drawing normally distributed numbers, using the
+ * block size mutate() asks for (1 + 2 * numberOfParameters) per child:
+ * the old per call Box-Muller that threw the second variate away, per call
+ * RandomNumberGenerator::normal, which keeps it for the next call, and
+ * filling the block with RandomNumberGenerator::fillNormal.
+ *
+ * usage: RandomNumberGeneratorBenchmark [numberOfParameters] [numChildren]
+ */
+
+#include "RandomNumberGenerator.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace opt;
+
+/**
+ * what normal() did before it kept the second variate
+ */
+double discardingNormal(RandomNumberGenerator &rng) {
+    const double twoPi = 6.283185307179586;
+    double u1 = 1.0 - rng.uniformReal(0.0, 1.0);
+    double u2 = rng.uniformReal(0.0, 1.0);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(twoPi * u2);
+}
+
+template<class F>
+double timeIt(F &&f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+    size_t numberOfParameters = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100;
+    size_t numChildren = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    size_t blockSize = 1 + 2 * numberOfParameters;
+    double draws = double(blockSize) * double(numChildren);
+
+    RandomNumberGenerator rng(4);
+    std::vector<double> block(blockSize);
+    // keeps the compiler from throwing the draws away
+    double sink = 0;
+
+    double discarding = timeIt([&] {
+        for (size_t i = 0; i < numChildren; i++) {
+            RandomNumberGenerator child = rng.substream(0, i);
+            for (size_t j = 0; j < blockSize; j++)
+                block[j] = discardingNormal(child);
+            sink += block[blockSize - 1];
+        }
+    });
+
+    double perCall = timeIt([&] {
+        for (size_t i = 0; i < numChildren; i++) {
+            RandomNumberGenerator child = rng.substream(0, i);
+            for (size_t j = 0; j < blockSize; j++)
+                block[j] = child.normal(0, 1);
+            sink += block[blockSize - 1];
+        }
+    });
+
+    double bulk = timeIt([&] {
+        for (size_t i = 0; i < numChildren; i++) {
+            RandomNumberGenerator child = rng.substream(0, i);
+            child.fillNormal(block.data(), blockSize);
+            sink += block[blockSize - 1];
+        }
+    });
+
+    std::cout << "block size " << blockSize << ", " << numChildren << " blocks" << std::endl;
+    std::cout << "discarding:   " << discarding / draws * 1e9 << " ns per draw" << std::endl;
+    std::cout << "normal():     " << perCall / draws * 1e9 << " ns per draw" << std::endl;
+    std::cout << "fillNormal(): " << bulk / draws * 1e9 << " ns per draw" << std::endl;
+    std::cout << "speedup over discarding: " << discarding / bulk << "x" << std::endl;
+    std::cout << "speedup over normal():   " << perCall / bulk << "x" << std::endl;
+    std::cout << "(checksum " << sink << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * Google Benchmark suite for the per-generation overhead of the optimizer,
+ * leaving out the objective. The optimizer benchmarks drive SRES through
+ * ask() and tell() and time only those calls; the fitness of the children
+ * is computed between them, outside the timed region. They sweep the
+ * population size, child rate and number of parameters:
+ *
+ *  - Generation: ask() and tell() together, the time of one generation
+ *  - Replicate:  ask(), copying the parents, recombining and mutating
+ *  - Mutate:     the mutation ask() does for every child of a generation,
+ *                from the initial population, so that a change in
+ *                Replicate can be told apart from one in the mutation
+ *  - Select:     tell(), stochastic ranking and the best individual
+ *  - Creation:   the first ask() of a run, the random initial population
+ *
+ * and the building blocks underneath are timed on their own:
+ *
+ *  - MutationKernel: the first mutation attempt of one child
+ *  - FillNormal / UniformReal: RandomNumberGenerator draws
+ *  - CheckConstraints / Violation: OptItems bound checks of one individual
+ *
+ * usage: SRES-benchmarks --benchmark_out=sres.json --benchmark_out_format=json
+ *
+ * The JSON of two builds can be compared with tools/compare.py from
+ * Google Benchmark.
+ */
+
+#include "benchmark/benchmark.h"
+#include "MutationKernel.h"
+#include "OptItems.h"
+#include "RandomNumberGenerator.h"
+#include "SRES.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace opt;
+
+namespace {
+
+    /**
+     * @brief generations per run. The hall of fame keeps a row per
+     * generation, so runs are kept finite and restarted between iterations
+     */
+    constexpr int RunLength = 1000;
+
+    double sphere(double *x) {
+        return x[0] * x[0];
+    }
+
+    /**
+     * @brief an optimizer set up for @param state's population size,
+     * child rate and number of parameters which only stops after
+     * RunLength generations
+     */
+    SRES makeOptimizer(const benchmark::State &state) {
+        auto populationSize = (int) state.range(0);
+        auto childRate = (int) state.range(1);
+        auto numParameters = (size_t) state.range(2);
+        SRES sres(sphere, populationSize, RunLength, std::vector<double>(numParameters, 1.0),
+                  std::vector<double>(numParameters, -10.0), std::vector<double>(numParameters, 10.0), childRate);
+        sres.setStopAfterStalledGenerations(0);
+        sres.setSeed(4);
+        return sres;
+    }
+
+    /**
+     * @brief the objective, evaluated outside the timed region
+     */
+    void evaluate(const CandidateBatch &batch, std::vector<double> &fitness) {
+        fitness.resize(batch.numCandidates);
+        for (size_t i = 0; i < batch.numCandidates; i++) {
+            double sum = 0;
+            for (size_t j = 0; j < batch.numParameters; j++)
+                sum += batch[i][j] * batch[i][j];
+            fitness[i] = sum;
+        }
+    }
+
+    /**
+     * @brief restart the run of @param sres if it has finished,
+     * so that the next ask() makes children
+     */
+    void startRunIfFinished(SRES &sres, std::vector<double> &fitness) {
+        if (!sres.isFinished())
+            return;
+        sres.restart();
+        evaluate(sres.ask(), fitness);
+        sres.tell(fitness);
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief population size x child rate x number of parameters
+     */
+    void optimizerArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"populationSize", "childRate", "numParameters"})
+                ->ArgsProduct({{10, 50, 200}, {3, 7}, {2, 10, 100}})
+                ->UseManualTime();
+    }
+
+    void setCounters(benchmark::State &state) {
+        // children made per iteration, so the JSON also carries ns per child
+        state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+    }
+}
+
+static void Generation(benchmark::State &state) {
+    SRES sres = makeOptimizer(state);
+    std::vector<double> fitness;
+    evaluate(sres.ask(), fitness);
+    sres.tell(fitness);
+    for (auto _: state) {
+        startRunIfFinished(sres, fitness);
+        auto start = std::chrono::steady_clock::now();
+        CandidateBatch batch = sres.ask();
+        double seconds = secondsSince(start);
+        evaluate(batch, fitness);
+        start = std::chrono::steady_clock::now();
+        sres.tell(fitness);
+        state.SetIterationTime(seconds + secondsSince(start));
+    }
+    setCounters(state);
+}
+
+BENCHMARK(Generation)->Apply(optimizerArguments);
+
+static void Replicate(benchmark::State &state) {
+    SRES sres = makeOptimizer(state);
+    std::vector<double> fitness;
+    evaluate(sres.ask(), fitness);
+    sres.tell(fitness);
+    for (auto _: state) {
+        startRunIfFinished(sres, fitness);
+        auto start = std::chrono::steady_clock::now();
+        CandidateBatch batch = sres.ask();
+        state.SetIterationTime(secondsSince(start));
+        evaluate(batch, fitness);
+        sres.tell(fitness);
+    }
+    setCounters(state);
+}
+
+BENCHMARK(Replicate)->Apply(optimizerArguments);
+
+static void Mutate(benchmark::State &state) {
+    // the children of one generation of makeOptimizer(state), mutated
+    // like SRES::mutateIndividual() does without prefetching
+    auto numChildren = (size_t) (state.range(0) * (state.range(1) - 1));
+    auto n = (size_t) state.range(2);
+    std::vector<double> lb(n, -10.0), ub(n, 10.0), maxVariance(n, 20.0 / std::sqrt((double) n));
+    double tau = 1 / std::sqrt(2 * std::sqrt((double) n));
+    double tauPrime = 1 / std::sqrt(2 * (double) n);
+    std::vector<double> x(numChildren * n), variance(numChildren * n), normals(2 * n + 1);
+    std::vector<std::uint8_t> outOfBounds(n);
+    RandomNumberGenerator rng(4);
+    std::uint32_t generation = 0;
+    for (auto _: state) {
+        // every generation starts from the initial population, see MutationKernel
+        std::fill(x.begin(), x.end(), 1.0);
+        for (size_t i = 0; i < numChildren; i++)
+            std::copy(maxVariance.begin(), maxVariance.end(), variance.begin() + i * n);
+        generation++;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numChildren; i++) {
+            double *child = x.data() + i * n;
+            double *childVariance = variance.data() + i * n;
+            RandomNumberGenerator childRng = rng.substream(generation, (std::uint32_t) i);
+            childRng.fillNormal(normals.data(), normals.size());
+            if (mutationKernel(n, child, childVariance, maxVariance.data(), lb.data(), ub.data(),
+                               tauPrime * normals[0], tau, normals.data() + 1, normals.data() + 1 + n,
+                               outOfBounds.data()) == 0)
+                continue;
+            for (size_t j = 0; j < n; j++) {
+                if (!outOfBounds[j])
+                    continue;
+                double store = child[j];
+                for (int l = 1; l < 10; l++) {
+                    double mut = store + childVariance[j] * childRng.normal(0, 1);
+                    if (!(lb[j] > mut || mut > ub[j])) {
+                        child[j] = mut;
+                        break;
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(x.data());
+        benchmark::ClobberMemory();
+        state.SetIterationTime(secondsSince(start));
+    }
+    setCounters(state);
+}
+
+BENCHMARK(Mutate)->Apply(optimizerArguments);
+
+static void Select(benchmark::State &state) {
+    SRES sres = makeOptimizer(state);
+    std::vector<double> fitness;
+    evaluate(sres.ask(), fitness);
+    sres.tell(fitness);
+    for (auto _: state) {
+        startRunIfFinished(sres, fitness);
+        evaluate(sres.ask(), fitness);
+        auto start = std::chrono::steady_clock::now();
+        sres.tell(fitness);
+        state.SetIterationTime(secondsSince(start));
+    }
+    setCounters(state);
+}
+
+BENCHMARK(Select)->Apply(optimizerArguments);
+
+static void Creation(benchmark::State &state) {
+    SRES sres = makeOptimizer(state);
+    std::vector<double> fitness;
+    for (auto _: state) {
+        sres.restart();
+        auto start = std::chrono::steady_clock::now();
+        CandidateBatch batch = sres.ask();
+        state.SetIterationTime(secondsSince(start));
+        evaluate(batch, fitness);
+        sres.tell(fitness);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Creation)->Apply(optimizerArguments);
+
+static void MutationKernel(benchmark::State &state) {
+    auto n = (size_t) state.range(0);
+    RandomNumberGenerator rng(4);
+    std::vector<double> x(n), variance(n), maxVariance(n, 2.0), lb(n, -5.0), ub(n, 5.0);
+    std::vector<double> varianceNormals(n), stepNormals(n);
+    std::vector<std::uint8_t> outOfBounds(n);
+    rng.fillNormal(varianceNormals.data(), n);
+    rng.fillNormal(stepNormals.data(), n);
+    for (auto _: state) {
+        // every call starts from the same state, otherwise repeated updates
+        // push variances into denormals and the timings measure those. The
+        // reset is timed too, pausing the timer would cost more than the call
+        std::fill(x.begin(), x.end(), 0.0);
+        std::fill(variance.begin(), variance.end(), 1.0);
+        benchmark::DoNotOptimize(
+                mutationKernel(n, x.data(), variance.data(), maxVariance.data(), lb.data(), ub.data(),
+                               0.1, 0.2, varianceNormals.data(), stepNormals.data(), outOfBounds.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(MutationKernel)->ArgName("numParameters")->Arg(2)->Arg(10)->Arg(100)->Arg(1000);
+
+static void FillNormal(benchmark::State &state) {
+    // the block mutate() draws per child
+    auto blockSize = (size_t) (1 + 2 * state.range(0));
+    RandomNumberGenerator rng(4);
+    std::vector<double> block(blockSize);
+    for (auto _: state) {
+        rng.fillNormal(block.data(), blockSize);
+        benchmark::DoNotOptimize(block.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * (std::int64_t) blockSize);
+}
+
+BENCHMARK(FillNormal)->ArgName("numParameters")->Arg(2)->Arg(10)->Arg(100)->Arg(1000);
+
+static void UniformReal(benchmark::State &state) {
+    RandomNumberGenerator rng(4);
+    for (auto _: state)
+        benchmark::DoNotOptimize(rng.uniformReal(0.0, 1.0));
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(UniformReal);
+
+static void CheckConstraints(benchmark::State &state) {
+    auto n = (size_t) state.range(0);
+    RandomNumberGenerator rng(4);
+    std::vector<double> x(n);
+    std::vector<std::int8_t> out(n);
+    rng.fillNormal(x.data(), n);
+    OptItems optItems(std::vector<double>(n, 0.0), std::vector<double>(n, -1.0), std::vector<double>(n, 1.0));
+    for (auto _: state) {
+        optItems.checkConstraints(x.data(), out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(CheckConstraints)->ArgName("numParameters")->Arg(2)->Arg(10)->Arg(100)->Arg(1000);
+
+static void Violation(benchmark::State &state) {
+    auto n = (size_t) state.range(0);
+    RandomNumberGenerator rng(4);
+    std::vector<double> x(n);
+    rng.fillNormal(x.data(), n);
+    OptItems optItems(std::vector<double>(n, 0.0), std::vector<double>(n, -1.0), std::vector<double>(n, 1.0));
+    for (auto _: state)
+        benchmark::DoNotOptimize(optItems.violation(x.data()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(Violation)->ArgName("numParameters")->Arg(2)->Arg(10)->Arg(100)->Arg(1000);
+
+BENCHMARK_MAIN();
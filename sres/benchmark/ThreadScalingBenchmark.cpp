@@ -0,0 +1,250 @@
+/**
+ * Runs SRES::fit() end to end on objectives of known cost with 1 to
+ * maxThreads evaluation threads and reports where parallel evaluation
+ * stops scaling. The objectives are
+ *
+ *  - beale, ackley: the cheap fixed cost functions of sres/test and
+ *    sresFromMoonfit/test, which show the overhead of the optimizer
+ *  - busyWait: spins for costMicroseconds per call
+ *  - logNormal: spins for a log normal time with a median of
+ *    costMicroseconds and a sigma of 1, drawn from the parameters so
+ *    that a run is repeatable
+ *  - memoryBound: 4096 dependent loads per call from a 256 MB table
+ *
+ * Strong scaling keeps the population fixed, so the parallel efficiency
+ * with p threads is T(1) / (p T(p)). Weak scaling grows the population
+ * with the number of threads so that each thread has the same number of
+ * children to evaluate, and the efficiency is T(1) / T(p). Every run
+ * makes a fixed number of generations. The report is JSON, written to
+ * reportFile or to stdout.
+ *
+ * usage: ThreadScalingBenchmark [maxThreads] [costMicroseconds] [numGenerations] [reportFile]
+ */
+
+#include "SRES.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace opt;
+
+namespace {
+
+    const double Pi = 3.14159265358979323846;
+
+    double costMicroseconds = 100;
+
+    // the table read by memoryBound, larger than any last level cache
+    std::vector<std::uint64_t> table;
+
+    std::uint64_t mix(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /**
+     * @brief hash of the two parameters of @param x
+     */
+    std::uint64_t hashParameters(const double *x) {
+        std::uint64_t bits[2];
+        std::memcpy(bits, x, sizeof(bits));
+        return mix(bits[0] ^ mix(bits[1]));
+    }
+
+    void spin(double microseconds) {
+        auto end = std::chrono::steady_clock::now() + std::chrono::duration<double, std::micro>(microseconds);
+        while (std::chrono::steady_clock::now() < end);
+    }
+
+    /**
+     * minimum = f(3, 0.5) = 0
+     */
+    double beale(double *x) {
+        return pow(1.5 - x[0] + x[0] * x[1], 2) +
+               pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2) +
+               pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+    }
+
+    /**
+     * minimum = f(0, 0) = 0
+     */
+    double ackley(double *x) {
+        return -20 * exp(-0.2 * sqrt(0.5 * (x[0] * x[0] + x[1] * x[1])))
+               - exp(0.5 * (cos(2 * Pi * x[0]) + cos(2 * Pi * x[1]))) + exp(1.0) + 20;
+    }
+
+    double busyWait(double *x) {
+        spin(costMicroseconds);
+        return beale(x);
+    }
+
+    double logNormal(double *x) {
+        // Box-Muller from two uniforms taken from the hash
+        std::uint64_t h = hashParameters(x);
+        double u1 = ((h >> 11) + 1.0) / 9007199254740993.0;
+        double u2 = (mix(h) >> 11) / 9007199254740992.0;
+        double normal = sqrt(-2.0 * log(u1)) * cos(2 * Pi * u2);
+        spin(costMicroseconds * exp(normal));
+        return beale(x);
+    }
+
+    double memoryBound(double *x) {
+        // each index depends on the value loaded before,
+        // so the loads cannot overlap
+        std::uint64_t index = hashParameters(x);
+        for (int i = 0; i < 4096; i++)
+            index = table[(index ^ i) % table.size()];
+        return beale(x) + (double) (index & 1) * 1e-300;
+    }
+
+    struct Objective {
+        const char *name;
+        CostFunction cost;
+    };
+
+    struct Measurement {
+        std::string objective;
+        std::string scaling;
+        int numThreads;
+        int populationSize;
+        int numGenerations;
+        unsigned long long numEvaluations;
+        double seconds;
+        double evaluationsPerSecond;
+        double generationSeconds;
+        double efficiency;
+    };
+
+    Measurement run(const Objective &objective, const std::string &scaling, int numThreads,
+                    int populationSize, int numGenerations) {
+        SRES sres(objective.cost, populationSize, numGenerations, {8.324, 7.335}, {-10, -10}, {10, 10}, 7);
+        sres.setSeed(4);
+        sres.setStopAfterStalledGenerations(0);
+        sres.setNumThreads(numThreads);
+
+        auto start = std::chrono::steady_clock::now();
+        sres.fit();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        Measurement m;
+        m.objective = objective.name;
+        m.scaling = scaling;
+        m.numThreads = numThreads;
+        m.populationSize = populationSize;
+        m.numGenerations = sres.getCurrentGeneration();
+        m.numEvaluations = sres.getNumEvaluations();
+        m.seconds = seconds;
+        m.evaluationsPerSecond = (double) m.numEvaluations / seconds;
+        // the initial population is evaluated too and is not a generation
+        m.generationSeconds = seconds / (m.numGenerations + 1);
+        m.efficiency = 1.0;
+        return m;
+    }
+
+    std::string toJson(const std::vector<Measurement> &measurements, int maxThreads, int numGenerations) {
+        std::ostringstream os;
+        os.precision(9);
+        os << "{\n";
+        os << "  \"hardwareConcurrency\": " << std::thread::hardware_concurrency() << ",\n";
+        os << "  \"maxThreads\": " << maxThreads << ",\n";
+        os << "  \"costMicroseconds\": " << costMicroseconds << ",\n";
+        os << "  \"numGenerations\": " << numGenerations << ",\n";
+        os << "  \"runs\": [\n";
+        for (size_t i = 0; i < measurements.size(); i++) {
+            const Measurement &m = measurements[i];
+            os << "    {\"objective\": \"" << m.objective << "\", "
+               << "\"scaling\": \"" << m.scaling << "\", "
+               << "\"numThreads\": " << m.numThreads << ", "
+               << "\"populationSize\": " << m.populationSize << ", "
+               << "\"numGenerations\": " << m.numGenerations << ", "
+               << "\"numEvaluations\": " << m.numEvaluations << ", "
+               << "\"seconds\": " << m.seconds << ", "
+               << "\"evaluationsPerSecond\": " << m.evaluationsPerSecond << ", "
+               << "\"generationSeconds\": " << m.generationSeconds << ", "
+               << "\"efficiency\": " << m.efficiency << "}"
+               << (i + 1 < measurements.size() ? ",\n" : "\n");
+        }
+        os << "  ]\n}\n";
+        return os.str();
+    }
+}
+
+int main(int argc, char **argv) {
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    int maxThreads = argc > 1 ? std::atoi(argv[1]) : (hardwareThreads > 0 ? hardwareThreads : 1);
+    costMicroseconds = argc > 2 ? std::atof(argv[2]) : 100;
+    int numGenerations = argc > 3 ? std::atoi(argv[3]) : 20;
+    std::string reportFile = argc > 4 ? argv[4] : "";
+    if (maxThreads < 1 || numGenerations < 1) {
+        std::cerr << "usage: ThreadScalingBenchmark [maxThreads] [costMicroseconds] [numGenerations] [reportFile]"
+                  << std::endl;
+        return 1;
+    }
+
+    table.resize((256 << 20) / sizeof(std::uint64_t));
+    for (size_t i = 0; i < table.size(); i++)
+        table[i] = mix(i);
+
+    // 1, 2, 4, ... and maxThreads
+    std::vector<int> threadCounts;
+    for (int p = 1; p < maxThreads; p *= 2)
+        threadCounts.push_back(p);
+    threadCounts.push_back(maxThreads);
+
+    const int populationSize = 50;
+    std::vector<Objective> objectives{
+            {"beale",       beale},
+            {"ackley",      ackley},
+            {"busyWait",    busyWait},
+            {"logNormal",   logNormal},
+            {"memoryBound", memoryBound}
+    };
+
+    std::vector<Measurement> measurements;
+    for (const Objective &objective: objectives) {
+        double strongBaseline = 0, weakBaseline = 0;
+        for (int p: threadCounts) {
+            Measurement m = run(objective, "strong", p, populationSize, numGenerations);
+            if (p == 1)
+                strongBaseline = m.seconds;
+            m.efficiency = strongBaseline / (p * m.seconds);
+            std::cerr << objective.name << " strong, " << p << " threads: "
+                      << m.evaluationsPerSecond << " evaluations/s, efficiency " << m.efficiency << std::endl;
+            measurements.push_back(m);
+        }
+        for (int p: threadCounts) {
+            Measurement m = run(objective, "weak", p, populationSize * p, numGenerations);
+            if (p == 1)
+                weakBaseline = m.seconds;
+            m.efficiency = weakBaseline / m.seconds;
+            std::cerr << objective.name << " weak, " << p << " threads: "
+                      << m.evaluationsPerSecond << " evaluations/s, efficiency " << m.efficiency << std::endl;
+            measurements.push_back(m);
+        }
+    }
+
+    std::string report = toJson(measurements, maxThreads, numGenerations);
+    if (reportFile.empty()) {
+        std::cout << report;
+    } else {
+        std::ofstream out(reportFile);
+        out << report;
+        if (!out) {
+            std::cerr << "could not write " << reportFile << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -6,6 +6,41 @@ from typing import List, Dict, Union
 import numpy as np
 
 
+class GenerationInfo(ct.Structure):
+    """summary of a generation passed to the callbacks of SRES.setGenerationCallback"""
+    _fields_ = [
+        ("generation", ct.c_int32),
+        ("numEvaluations", ct.c_ulonglong),
+        ("bestFitness", ct.c_double),
+        ("medianFitness", ct.c_double),
+        ("feasibleFraction", ct.c_double),
+        ("meanSigma", ct.c_double),
+        ("elapsedSeconds", ct.c_double),
+    ]
+
+
+class Profile(ct.Structure):
+    """where the time of a run went, see SRES.getProfile"""
+    _fields_ = [
+        ("enabled", ct.c_int32),
+        ("replicateSeconds", ct.c_double),
+        ("mutateSeconds", ct.c_double),
+        ("mutateRngSeconds", ct.c_double),
+        ("mutateKernelSeconds", ct.c_double),
+        ("mutateBoundRetrySeconds", ct.c_double),
+        ("evaluateSeconds", ct.c_double),
+        ("selectSeconds", ct.c_double),
+        ("findBestIndividualSeconds", ct.c_double),
+        ("numCostCalls", ct.c_ulonglong),
+        ("costCallMeanSeconds", ct.c_double),
+        ("costCallMinSeconds", ct.c_double),
+        ("costCallP50Seconds", ct.c_double),
+        ("costCallP90Seconds", ct.c_double),
+        ("costCallP99Seconds", ct.c_double),
+        ("costCallMaxSeconds", ct.c_double),
+    ]
+
+
 class _CSRESLoader:
 
     def __init__(self):
@@ -55,8 +90,9 @@ class SRES:
 
     def __init__(self, cost_function, popsize: int, numGenerations: int,
                  startingValues: _NUM_LIST_TYPE, lb: _NUM_LIST_TYPE, ub: _NUM_LIST_TYPE,
-                 childrate: int = 7):
+                 childrate: int = 7, batch: bool = False):
         self._cost_function = cost_function
+        self._batch = batch
         self._popsize = popsize
         self._numGenerations = numGenerations
         self._childrate = childrate
@@ -68,7 +104,7 @@ class SRES:
         self.startingValues = ct.pointer(BoundaryArray(*startingValues))
 
         # load the function for creating a SRES obj (doesn't actually call it)
-        self._newSRES = self._loadNewSRES()
+        self._newSRES = self._loadNewSRESBatch() if batch else self._loadNewSRES()
 
         # call the C constructor
         self._obj = self._newSRES(
@@ -81,6 +117,45 @@ class SRES:
     def callback(numEstimatedParameters: int):
         return ct.CFUNCTYPE(ct.c_double, ct.POINTER(ct.c_double * numEstimatedParameters))
 
+    @staticmethod
+    def batchCallback():
+        """Decorator for cost functions that evaluate a whole generation per call.
+
+        The decorated function receives (population, numIndividuals, numParameters, fitness)
+        where population is a pointer to a row major numIndividuals x numParameters
+        matrix and fitness a pointer to numIndividuals doubles to fill in. Use
+        SRES.asArrays to view them as numpy arrays without copying. Pass batch=True
+        to the SRES constructor when using a batch cost function.
+        """
+        return ct.CFUNCTYPE(None, ct.POINTER(ct.c_double), ct.c_int32, ct.c_int32, ct.POINTER(ct.c_double))
+
+    @staticmethod
+    def constraintCallback(numEstimatedParameters: int, numConstraints: int):
+        """Decorator for constraint functions, see setConstraintFunction.
+
+        The decorated function receives (parameters, constraintValues) and
+        fills in one value per constraint, satisfied when <= 0.
+        """
+        return ct.CFUNCTYPE(None, ct.POINTER(ct.c_double * numEstimatedParameters),
+                            ct.POINTER(ct.c_double * numConstraints))
+
+    @staticmethod
+    def generationCallback():
+        """Decorator for observers, see setGenerationCallback.
+
+        The decorated function receives a pointer to a GenerationInfo, valid
+        during the call only, and returns non zero to stop the run.
+        """
+        return ct.CFUNCTYPE(ct.c_int32, ct.POINTER(GenerationInfo))
+
+    @staticmethod
+    def asArrays(population, numIndividuals: int, numParameters: int, fitness):
+        """view the arguments of a batch callback as numpy arrays (no copy)"""
+        return (
+            np.ctypeslib.as_array(population, shape=(numIndividuals, numParameters)),
+            np.ctypeslib.as_array(fitness, shape=(numIndividuals,))
+        )
+
     def getLastError(self) -> str:
         """When an error occurs you can get the message using this method"""
         return self._getLastError()
@@ -119,10 +194,197 @@ class SRES:
         )
         return dct
 
+    def ask(self) -> np.array:
+        """returns the next candidates to evaluate as a (numCandidates, numEstimatedParameters) array.
+
+        The array is empty when the optimization has finished. Every call
+        to ask must be followed by a call to tell.
+        """
+        numCandidates = ct.c_int32(0)
+        candidates = self._ask(self._obj, ct.byref(numCandidates))
+        if numCandidates.value == 0:
+            return np.empty((0, self._numEstimatedParameters.value))
+        return np.ctypeslib.as_array(
+            candidates, shape=(numCandidates.value, self._numEstimatedParameters.value)
+        ).copy()
+
+    def tell(self, fitness, constraintValues=None) -> bool:
+        """report the fitness of the candidates from the last call to ask.
+
+        When setNumConstraints was called constraintValues is a
+        (numCandidates, numConstraints) array of inequality constraint
+        values, each satisfied when <= 0.
+        returns True if there is another generation to ask for.
+        """
+        fitness = np.ascontiguousarray(fitness, dtype=np.float64)
+        if constraintValues is None:
+            result = self._tell(
+                self._obj, fitness.ctypes.data_as(ct.POINTER(ct.c_double)), ct.c_int32(len(fitness))
+            )
+        else:
+            constraintValues = np.ascontiguousarray(constraintValues, dtype=np.float64)
+            result = self._tellWithConstraints(
+                self._obj, fitness.ctypes.data_as(ct.POINTER(ct.c_double)),
+                constraintValues.ctypes.data_as(ct.POINTER(ct.c_double)), ct.c_int32(len(fitness))
+            )
+        if result < 0:
+            raise ValueError(self.getLastError())
+        return result == 1
+
     def setSeed(self, seed: int):
         """set the random seed to get predictible parameter estimations"""
         self._setSeed(self._obj, ct.c_ulonglong(seed))
 
+    def setConstraintFunction(self, constraint_function, numConstraints: int):
+        """evaluate the constraints of every candidate before its cost.
+
+        constraint_function is decorated with SRES.constraintCallback. With
+        a pf of 0 the cost function is skipped for children that violate a
+        constraint, since stochastic ranking never needs their fitness.
+        """
+        self._constraint_function = constraint_function
+        if self._setConstraintFunction(
+                self._obj, ct.cast(constraint_function, ct.c_void_p), ct.c_int32(numConstraints)) < 0:
+            raise ValueError(self.getLastError())
+
+    def getNumSkippedEvaluations(self) -> int:
+        """number of calls to the cost function saved by the constraint function"""
+        return self._getNumSkippedEvaluations(self._obj)
+
+    def setNumConstraints(self, numConstraints: int):
+        """number of inequality constraint values passed to tell for every candidate"""
+        if self._setNumConstraints(self._obj, ct.c_int32(numConstraints)) < 0:
+            raise ValueError(self.getLastError())
+
+    def setFitnessCache(self, capacity: int, quantum: float = 0.0):
+        """reuse the fitness of up to capacity previously evaluated parameter vectors.
+
+        With quantum > 0 parameters are rounded to the nearest multiple of
+        quantum before being compared. A capacity of 0 removes the cache.
+        """
+        if self._setFitnessCache(self._obj, ct.c_int32(capacity), ct.c_double(quantum)) < 0:
+            raise ValueError(self.getLastError())
+
+    def getFitnessCacheStats(self) -> Dict[str, int]:
+        """number of cost function calls the fitness cache saved (hits) and did not (misses)"""
+        hits = ct.c_ulonglong(0)
+        misses = ct.c_ulonglong(0)
+        self._getFitnessCacheStats(self._obj, ct.byref(hits), ct.byref(misses))
+        return dict(hits=hits.value, misses=misses.value)
+
+    def setEvaluationStore(self, path: str):
+        """keep every evaluation in the on disk store at path and reuse those already in it.
+
+        Lets a rerun of the same problem skip the parameter vectors that
+        earlier runs evaluated. An empty path closes the store.
+        """
+        if self._setEvaluationStore(self._obj, path.encode("utf-8")) < 0:
+            raise ValueError(self.getLastError())
+
+    def getEvaluationStoreStats(self) -> Dict[str, int]:
+        """lookups the evaluation store answered (hits) and did not (misses), and its number of records"""
+        hits = ct.c_ulonglong(0)
+        misses = ct.c_ulonglong(0)
+        numRecords = ct.c_ulonglong(0)
+        self._getEvaluationStoreStats(self._obj, ct.byref(hits), ct.byref(misses), ct.byref(numRecords))
+        return dict(hits=hits.value, misses=misses.value, numRecords=numRecords.value)
+
+    def saveCheckpoint(self, path: str):
+        """write the state of the run to path so that loadCheckpoint can carry on from it"""
+        if self._saveCheckpoint(self._obj, path.encode("utf-8")) < 0:
+            raise ValueError(self.getLastError())
+
+    def loadCheckpoint(self, path: str):
+        """restore a run saved by saveCheckpoint. Continue it with resume.
+
+        This optimizer must be set up for the same problem as the one which was saved.
+        """
+        if self._loadCheckpoint(self._obj, path.encode("utf-8")) < 0:
+            raise ValueError(self.getLastError())
+
+    def resume(self) -> Dict[str, Union[float, np.array]]:
+        """carry on with the current run until it finishes, unlike fit which starts a new one"""
+        if self._resume(self._obj) < 0:
+            raise RuntimeError(self.getLastError())
+        return dict(
+            bestFitness=self.getBestValue(),
+            hallOfFame=self.getHallOfFame(),
+            bestSolution=self.getSolution()
+        )
+
+    def setCheckpointSchedule(self, path: str, everyGenerations: int, everySeconds: float = 0.0):
+        """save a checkpoint to path every everyGenerations generations and every
+        everySeconds seconds, 0 to disable either, and when the run finishes.
+
+        The checkpoints are written in the background. An empty path turns checkpointing off.
+        """
+        if self._setCheckpointSchedule(self._obj, path.encode("utf-8"), ct.c_int32(everyGenerations),
+                                       ct.c_double(everySeconds)) < 0:
+            raise ValueError(self.getLastError())
+
+    def setGenerationCallback(self, generation_callback, everyGenerations: int = 1, minSeconds: float = 0.0):
+        """call generation_callback, decorated with SRES.generationCallback, after the generations of a run.
+
+        It is called at most once every everyGenerations generations and
+        minSeconds seconds, and after the last generation. The run stops
+        when it returns non zero. Pass None to remove it.
+        """
+        self._generation_callback = generation_callback
+        callback = ct.cast(generation_callback, ct.c_void_p) if generation_callback else None
+        if self._setGenerationCallback(self._obj, callback, ct.c_int32(everyGenerations),
+                                       ct.c_double(minSeconds)) < 0:
+            raise ValueError(self.getLastError())
+
+    def getNumEvaluations(self) -> int:
+        """calls to the cost function since the run started"""
+        return self._getNumEvaluations(self._obj)
+
+    def getProfile(self) -> Dict[str, Union[int, float]]:
+        """time spent in each phase of the run and the latency of the cost function.
+
+        Only collected when the library is built with SRES_ENABLE_PROFILING,
+        otherwise "enabled" is 0 and so is everything else.
+        """
+        profile = Profile()
+        self._getProfile(self._obj, ct.byref(profile))
+        return {name: getattr(profile, name) for name, _ in Profile._fields_}
+
+    def cancel(self):
+        """stop a running fit or resume after the evaluations already running.
+
+        Call it from another thread. The run keeps its last complete
+        generation and saves a checkpoint if they are scheduled.
+        """
+        self._cancel(self._obj)
+
+    def resetCancellation(self):
+        """clear a cancellation so that the optimizer can run again"""
+        self._resetCancellation(self._obj)
+
+    def isCancelled(self) -> bool:
+        return self._isCancelled(self._obj)
+
+    def setCancelOnSignal(self, cancelOnSignal: bool):
+        """cancel the optimizer on SIGINT and SIGTERM instead of raising KeyboardInterrupt.
+
+        A second signal stops the process. Pass False to put the previous handlers back.
+        """
+        self._setCancelOnSignal(self._obj, ct.c_int32(1 if cancelOnSignal else 0))
+
+    def setNumThreads(self, numThreads: int):
+        """evaluate the children of each generation on numThreads threads.
+
+        Note that python callbacks hold the GIL, so this only pays
+        off when the cost function releases it (e.g. while simulating)
+        """
+        self._setNumThreads(self._obj, ct.c_int32(numThreads))
+
+    def setPrefetchRandomNumbers(self, prefetchRandomNumbers: bool):
+        """draw the random numbers of the next generation on a background
+        thread while the current one is evaluated. The results do not change.
+        """
+        self._setPrefetchRandomNumbers(self._obj, ct.c_int32(1 if prefetchRandomNumbers else 0))
+
     def _loadNewSRES(self):
         """loads the constructor for SRES algorithm"""
         return self._sres.load_func(
@@ -140,6 +402,23 @@ class SRES:
             return_type=ct.c_int64
         )
 
+    def _loadNewSRESBatch(self):
+        """loads the constructor for SRES algorithm with a batch cost function"""
+        return self._sres.load_func(
+            funcname="SRES_newSRESBatch",
+            argtypes=[
+                SRES.batchCallback(),
+                ct.c_int32,
+                ct.c_int32,
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.c_int32,
+                ct.c_int32
+            ],
+            return_type=ct.c_int64
+        )
+
     _getSizeOfHallOfFame = _sres.load_func(
         funcname="SRES_getSizeOfHallOfFame",
         argtypes=[ct.c_int64],
@@ -171,6 +450,144 @@ class SRES:
         return_type=None
     )
 
+    _setNumThreads = _sres.load_func(
+        funcname="SRES_setNumThreads",
+        argtypes=[ct.c_int64, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _setPrefetchRandomNumbers = _sres.load_func(
+        funcname="SRES_setPrefetchRandomNumbers",
+        argtypes=[ct.c_int64, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _ask = _sres.load_func(
+        funcname="SRES_ask",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_int32)],
+        return_type=ct.POINTER(ct.c_double)
+    )
+
+    _tell = _sres.load_func(
+        funcname="SRES_tell",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_double), ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _setNumConstraints = _sres.load_func(
+        funcname="SRES_setNumConstraints",
+        argtypes=[ct.c_int64, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _setFitnessCache = _sres.load_func(
+        funcname="SRES_setFitnessCache",
+        argtypes=[ct.c_int64, ct.c_int32, ct.c_double],
+        return_type=ct.c_int32
+    )
+
+    _getFitnessCacheStats = _sres.load_func(
+        funcname="SRES_getFitnessCacheStats",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_ulonglong), ct.POINTER(ct.c_ulonglong)],
+        return_type=ct.c_int32
+    )
+
+    _setEvaluationStore = _sres.load_func(
+        funcname="SRES_setEvaluationStore",
+        argtypes=[ct.c_int64, ct.c_char_p],
+        return_type=ct.c_int32
+    )
+
+    _getEvaluationStoreStats = _sres.load_func(
+        funcname="SRES_getEvaluationStoreStats",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_ulonglong), ct.POINTER(ct.c_ulonglong), ct.POINTER(ct.c_ulonglong)],
+        return_type=ct.c_int32
+    )
+
+    _saveCheckpoint = _sres.load_func(
+        funcname="SRES_saveCheckpoint",
+        argtypes=[ct.c_int64, ct.c_char_p],
+        return_type=ct.c_int32
+    )
+
+    _loadCheckpoint = _sres.load_func(
+        funcname="SRES_loadCheckpoint",
+        argtypes=[ct.c_int64, ct.c_char_p],
+        return_type=ct.c_int32
+    )
+
+    _resume = _sres.load_func(
+        funcname="SRES_resume",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
+
+    _setCheckpointSchedule = _sres.load_func(
+        funcname="SRES_setCheckpointSchedule",
+        argtypes=[ct.c_int64, ct.c_char_p, ct.c_int32, ct.c_double],
+        return_type=ct.c_int32
+    )
+
+    _cancel = _sres.load_func(
+        funcname="SRES_cancel",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
+
+    _resetCancellation = _sres.load_func(
+        funcname="SRES_resetCancellation",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
+
+    _isCancelled = _sres.load_func(
+        funcname="SRES_isCancelled",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_bool
+    )
+
+    _setCancelOnSignal = _sres.load_func(
+        funcname="SRES_setCancelOnSignal",
+        argtypes=[ct.c_int64, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _setGenerationCallback = _sres.load_func(
+        funcname="SRES_setGenerationCallback",
+        argtypes=[ct.c_int64, ct.c_void_p, ct.c_int32, ct.c_double],
+        return_type=ct.c_int32
+    )
+
+    _getNumEvaluations = _sres.load_func(
+        funcname="SRES_getNumEvaluations",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_ulonglong
+    )
+
+    _getProfile = _sres.load_func(
+        funcname="SRES_getProfile",
+        argtypes=[ct.c_int64, ct.POINTER(Profile)],
+        return_type=ct.c_int32
+    )
+
+    _setConstraintFunction = _sres.load_func(
+        funcname="SRES_setConstraintFunction",
+        argtypes=[ct.c_int64, ct.c_void_p, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _getNumSkippedEvaluations = _sres.load_func(
+        funcname="SRES_getNumSkippedEvaluations",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
+
+    _tellWithConstraints = _sres.load_func(
+        funcname="SRES_tellWithConstraints",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_double), ct.POINTER(ct.c_double), ct.c_int32],
+        return_type=ct.c_int32
+    )
+
     _deleteSRES = _sres.load_func(
         funcname="SRES_deleteSRES",
         argtypes=[ct.c_int64],
@@ -191,3 +608,143 @@ class SRES:
 
     # def __del__(self):
     #     self._deleteSRES(self._obj)
+
+
+class Portfolio:
+    """run several independently seeded SRES fits of the same problem concurrently.
+
+    The runs are stepped concurrently on a shared pool of threads. Every
+    rungInterval generations the runs still going are raced against the
+    one with the best fitness and those whose parents are statistically
+    dominated by its parents (a one sided Mann-Whitney U test at the given
+    significance) are cancelled, keeping at least 1 / reductionFactor of
+    them. The generations the cancelled runs had left are shared between
+    the survivors.
+
+    Note that python callbacks hold the GIL, so threads only pay off
+    when the cost function releases it (e.g. while simulating)
+    """
+    _sres = _CSRESLoader()
+
+    def __init__(self, cost_function, numRuns: int, popsize: int, numGenerations: int,
+                 startingValues: _NUM_LIST_TYPE, lb: _NUM_LIST_TYPE, ub: _NUM_LIST_TYPE,
+                 childrate: int = 7):
+        self._cost_function = cost_function
+        self._numRuns = numRuns
+        self._numEstimatedParameters = ct.c_int32(len(ub))
+        BoundaryArray = (ct.c_double * self._numEstimatedParameters.value)
+        self.ub = ct.pointer(BoundaryArray(*ub))
+        self.lb = ct.pointer(BoundaryArray(*lb))
+        self.startingValues = ct.pointer(BoundaryArray(*startingValues))
+
+        _newPortfolio = self._sres.load_func(
+            funcname="SRES_newPortfolio",
+            argtypes=[
+                SRES.callback(self._numEstimatedParameters.value),
+                ct.c_int32,
+                ct.c_int32,
+                ct.c_int32,
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.POINTER(ct.c_double * self._numEstimatedParameters.value),
+                ct.c_int32,
+                ct.c_int32
+            ],
+            return_type=ct.c_int64
+        )
+        self._obj = _newPortfolio(
+            self._cost_function, numRuns, popsize, numGenerations, self.startingValues,
+            self.lb, self.ub, self._numEstimatedParameters, childrate
+        )
+        if self._obj == 1:
+            raise ValueError(SRES._getLastError())
+
+    def setSeed(self, seed: int):
+        """run i is seeded with a seed derived from seed and i"""
+        self._setSeed(self._obj, ct.c_ulonglong(seed))
+
+    def setNumThreads(self, numThreads: int):
+        """number of threads the runs are stepped on"""
+        self._setNumThreads(self._obj, ct.c_int32(numThreads))
+
+    def setCancellation(self, rungInterval: int, reductionFactor: float = 2.0, minRuns: int = 1,
+                        significance: float = 0.05):
+        """configure early cancellation of losing runs. A rungInterval of 0 disables it"""
+        if self._setCancellation(self._obj, rungInterval, reductionFactor, minRuns, significance) < 0:
+            raise ValueError(SRES._getLastError())
+
+    def fit(self) -> List[Dict[str, Union[float, int, bool, np.array]]]:
+        """run the portfolio and return the results of every run, best first"""
+        if self._fit(self._obj) < 0:
+            raise RuntimeError(SRES._getLastError())
+        n, p = self._numRuns, self._numEstimatedParameters.value
+        seeds = (ct.c_ulonglong * n)()
+        bestFitness = (ct.c_double * n)()
+        solutions = (ct.c_double * (n * p))()
+        numGenerations = (ct.c_int32 * n)()
+        cancelled = (ct.c_int32 * n)()
+        self._getResults(self._obj, seeds, bestFitness, solutions, numGenerations, cancelled)
+
+        results = []
+        for i in range(n):
+            size = ct.c_int32(0)
+            hof = self._getHallOfFame(self._obj, i, ct.byref(size))
+            results.append(dict(
+                seed=seeds[i],
+                bestFitness=bestFitness[i],
+                bestSolution=np.array(solutions[i * p:(i + 1) * p]),
+                hallOfFame=np.array(hof[:size.value]),
+                numGenerations=numGenerations[i],
+                cancelled=bool(cancelled[i])
+            ))
+            self._freeHallOfFame(hof)
+        return sorted(results, key=lambda result: result["bestFitness"])
+
+    _setSeed = _sres.load_func(
+        funcname="SRES_setPortfolioSeed",
+        argtypes=[ct.c_int64, ct.c_ulonglong],
+        return_type=ct.c_int32
+    )
+
+    _setNumThreads = _sres.load_func(
+        funcname="SRES_setPortfolioNumThreads",
+        argtypes=[ct.c_int64, ct.c_int32],
+        return_type=ct.c_int32
+    )
+
+    _setCancellation = _sres.load_func(
+        funcname="SRES_setPortfolioCancellation",
+        argtypes=[ct.c_int64, ct.c_int32, ct.c_double, ct.c_int32, ct.c_double],
+        return_type=ct.c_int32
+    )
+
+    _fit = _sres.load_func(
+        funcname="SRES_fitPortfolio",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
+
+    _getResults = _sres.load_func(
+        funcname="SRES_getPortfolioResults",
+        argtypes=[ct.c_int64, ct.POINTER(ct.c_ulonglong), ct.POINTER(ct.c_double), ct.POINTER(ct.c_double),
+                  ct.POINTER(ct.c_int32), ct.POINTER(ct.c_int32)],
+        return_type=ct.c_int32
+    )
+
+    _getHallOfFame = _sres.load_func(
+        funcname="SRES_getPortfolioHallOfFame",
+        argtypes=[ct.c_int64, ct.c_int32, ct.POINTER(ct.c_int32)],
+        return_type=ct.POINTER(ct.c_double)
+    )
+
+    _freeHallOfFame = _sres.load_func(
+        funcname="SRES_freeHallOfFame",
+        argtypes=[ct.POINTER(ct.c_double)],
+        return_type=ct.c_int32
+    )
+
+    _deletePortfolio = _sres.load_func(
+        funcname="SRES_deletePortfolio",
+        argtypes=[ct.c_int64],
+        return_type=ct.c_int32
+    )
@@ -0,0 +1,111 @@
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include "gtest/gtest.h"
+#include "SRES.h"
+
+/**
+ * Replace the global allocator with one that counts
+ * every allocation made by this process.
+ */
+static std::atomic<long long> numAllocations{0};
+
+void *operator new(std::size_t size) {
+    numAllocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    numAllocations++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc requires the size to be a multiple of the alignment
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete[](void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+
+/**
+ * minimum = f(3, 0.5) = 0
+ */
+double BealeFunction(double x, double y) {
+    double first = pow(1.5 - x + x * y, 2);
+    double second = pow(2.25 - x + x * pow(y, 2), 2);
+    double third = pow(2.625 - x + x * pow(y, 3), 2);
+    return first + second + third;
+};
+
+
+double cost(double *input_params) {
+    return BealeFunction(input_params[0], input_params[1]);
+}
+
+
+using namespace opt;
+
+class AllocationTests : public ::testing::Test {
+
+public:
+    AllocationTests() = default;
+
+    /**
+     * @brief number of heap allocations made by a seeded
+     * fit of @param numGenerations generations
+     */
+    static long long allocationsPerFit(int numGenerations, int numThreads) {
+        SRES sres(cost, 20, numGenerations, {8.324, 7.335}, {0.1, 0.1}, {10, 10}, 7);
+        sres.setSeed(4);
+        sres.setNumThreads(numThreads);
+        // run every generation
+        sres.setStopAfterStalledGenerations(0);
+        long long before = numAllocations;
+        sres.fit();
+        return numAllocations - before;
+    }
+
+};
+
+
+/**
+ * Everything is allocated by initialize(), so running more generations
+ * must not make any more allocations.
+ */
+TEST_F(AllocationTests, TestGenerationLoopDoesNotAllocate) {
+    long long shortRun = allocationsPerFit(5, 1);
+    long long longRun = allocationsPerFit(100, 1);
+    ASSERT_GT(shortRun, 0);
+    ASSERT_EQ(shortRun, longRun);
+}
+
+TEST_F(AllocationTests, TestParallelGenerationLoopDoesNotAllocate) {
+    long long shortRun = allocationsPerFit(5, 4);
+    long long longRun = allocationsPerFit(100, 4);
+    ASSERT_EQ(shortRun, longRun);
+}
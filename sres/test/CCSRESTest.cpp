@@ -18,6 +18,12 @@ double cost(double *input_params) {
 }
 
 
+void batchCost(double *population, int numIndividuals, int numParameters, double *fitness) {
+    for (int i = 0; i < numIndividuals; i++)
+        fitness[i] = cost(population + i * numParameters);
+}
+
+
 using namespace opt;
 
 class CCSRESTests : public ::testing::Test {
@@ -101,18 +107,75 @@ TEST_F(CCSRESTests, TestGetSolutionValues) {
     SRES_deleteSRES(sres);
 }
 
+TEST_F(CCSRESTests, TestGetSolutionValuesBatch) {
+    SRES *sres = SRES_newSRESBatch(batchCost, 20, 50, s, l, u, 2, 7);
 
+    SRES_setSeed(sres, 4);
+    SRES_fit(sres);
 
+    double* sol = SRES_getSolution(sres);
 
+    double x = 3.0;
+    double y = 0.5;
+    ASSERT_NEAR(x, sol[0], 0.01);
+    ASSERT_NEAR(y, sol[1], 0.01);
+    SRES_freeSolution(sol);
+    SRES_deleteSRES(sres);
+}
 
+TEST_F(CCSRESTests, TestAskTell) {
+    SRES *sres = SRES_newSRES(cost, 20, 50, s, l, u, 2, 7);
+    SRES_setSeed(sres, 4);
 
+    int numCandidates = 0;
+    int more = 1;
+    while (more == 1) {
+        double *candidates = SRES_ask(sres, &numCandidates);
+        std::vector<double> fitness(numCandidates);
+        for (int i = 0; i < numCandidates; i++)
+            fitness[i] = cost(candidates + i * 2);
+        more = SRES_tell(sres, fitness.data(), numCandidates);
+    }
+    ASSERT_EQ(0, more);
 
+    double* sol = SRES_getSolution(sres);
+    ASSERT_NEAR(3.0, sol[0], 0.01);
+    ASSERT_NEAR(0.5, sol[1], 0.01);
+    SRES_freeSolution(sol);
+    SRES_deleteSRES(sres);
+}
 
 
-
-
-
-
-
-
-
+TEST_F(CCSRESTests, TestPortfolioResults) {
+    Portfolio *portfolio = SRES_newPortfolio(cost, 8, 20, 50, s, l, u, 2, 7);
+    SRES_setPortfolioSeed(portfolio, 4);
+    SRES_setPortfolioNumThreads(portfolio, 4);
+    ASSERT_EQ(0, SRES_setPortfolioCancellation(portfolio, 5, 2.0, 2));
+    ASSERT_EQ(0, SRES_fitPortfolio(portfolio));
+
+    unsigned long long seeds[8];
+    double bestFitness[8];
+    double solutions[16];
+    int numGenerations[8];
+    int cancelled[8];
+    ASSERT_EQ(8, SRES_getPortfolioResults(portfolio, seeds, bestFitness, solutions, numGenerations, cancelled));
+
+    int best = 0;
+    int numCancelled = 0;
+    for (int i = 0; i < 8; i++) {
+        if (bestFitness[i] < bestFitness[best])
+            best = i;
+        numCancelled += cancelled[i];
+    }
+    ASSERT_EQ(6, numCancelled);
+    ASSERT_FALSE(cancelled[best]);
+    ASSERT_NEAR(3.0, solutions[best * 2], 0.01);
+    ASSERT_NEAR(0.5, solutions[best * 2 + 1], 0.01);
+
+    int size = 0;
+    double *hof = SRES_getPortfolioHallOfFame(portfolio, best, &size);
+    ASSERT_GT(size, 0);
+    ASSERT_EQ(bestFitness[best], hof[size - 1]);
+    SRES_freeHallOfFame(hof);
+    SRES_deletePortfolio(portfolio);
+}
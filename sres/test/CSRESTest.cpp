@@ -1,5 +1,10 @@
 #include "gtest/gtest.h"
 #include "SRES.h"
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <thread>
 
 /**
  * note: we need a base class of SRES to mock the algorithm in testing.
@@ -22,6 +27,12 @@ double cost(double *input_params) {
 }
 
 
+void batchCost(double *population, int numIndividuals, int numParameters, double *fitness) {
+    for (int i = 0; i < numIndividuals; i++)
+        fitness[i] = cost(population + i * numParameters);
+}
+
+
 using namespace opt;
 
 class CSRESTests : public ::testing::Test {
@@ -86,19 +97,395 @@ TEST_F(CSRESTests, TestGetHallOfFame) {
     ASSERT_TRUE(alwaysDecreasing);
 }
 
+TEST_F(CSRESTests, TestParallelEvaluationGivesSameResultAsSerial) {
+    SRES serial(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    serial.setSeed(4);
+    serial.fit();
+
+    SRES parallel(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    parallel.setSeed(4);
+    parallel.setNumThreads(4);
+    parallel.fit();
+
+    ASSERT_EQ(serial.getBestFitnessValue(), parallel.getBestFitnessValue());
+    ASSERT_EQ(serial.getSolutionValues(), parallel.getSolutionValues());
+    ASSERT_EQ(serial.getHallOfFame(), parallel.getHallOfFame());
+}
+
+TEST_F(CSRESTests, TestBatchCostGivesSameResultAsSingleCost) {
+    SRES single(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    single.setSeed(4);
+    single.fit();
+
+    SRES batch(batchCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    batch.setSeed(4);
+    batch.fit();
+
+    ASSERT_EQ(single.getBestFitnessValue(), batch.getBestFitnessValue());
+    ASSERT_EQ(single.getSolutionValues(), batch.getSolutionValues());
+}
+
+TEST_F(CSRESTests, TestConcurrentOptimizersAreIndependent) {
+    SRES reference(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    reference.setSeed(4);
+    reference.fit();
+
+    SRES a(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    SRES b(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    a.setSeed(4);
+    b.setSeed(4);
+    std::thread ta([&] { a.fit(); });
+    std::thread tb([&] { b.fit(); });
+    ta.join();
+    tb.join();
+
+    ASSERT_EQ(reference.getSolutionValues(), a.getSolutionValues());
+    ASSERT_EQ(reference.getSolutionValues(), b.getSolutionValues());
+    ASSERT_EQ(reference.getHallOfFame(), a.getHallOfFame());
+}
+
+TEST_F(CSRESTests, TestParentsAreRankedByFitnessWhenFeasible) {
+    // all individuals of the Beale problem are within bounds, so
+    // stochastic ranking reduces to sorting the parents by fitness
+    SRES sres(cost, 10, 20, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.fit();
+    const auto &fitness = sres.getPopulationFitness();
+    ASSERT_TRUE(std::is_sorted(fitness.begin(), fitness.begin() + sres.getPopulationSize()));
+    ASSERT_EQ(fitness[0], sres.getBestFitnessValue());
+}
+
+TEST_F(CSRESTests, TestAskTellGivesSameResultAsFit) {
+    SRES fitted(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    fitted.setSeed(4);
+    fitted.fit();
+
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    bool more = true;
+    while (more) {
+        CandidateBatch candidates = sres.ask();
+        std::vector<double> fitness(candidates.numCandidates);
+        for (size_t i = 0; i < candidates.numCandidates; i++)
+            fitness[i] = cost(candidates[i]);
+        more = sres.tell(fitness);
+    }
+
+    ASSERT_TRUE(sres.isFinished());
+    ASSERT_EQ(0, sres.ask().numCandidates);
+    ASSERT_EQ(fitted.getBestFitnessValue(), sres.getBestFitnessValue());
+    ASSERT_EQ(fitted.getSolutionValues(), sres.getSolutionValues());
+    ASSERT_EQ(fitted.getHallOfFame(), sres.getHallOfFame());
+}
+
+TEST_F(CSRESTests, TestAskTwiceThrows) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.ask();
+    ASSERT_THROW(sres.ask(), std::logic_error);
+}
+
+TEST_F(CSRESTests, TestTellWrongSizeThrows) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.ask();
+    ASSERT_THROW(sres.tell(std::vector<double>(3)), std::invalid_argument);
+}
+
+
+TEST_F(CSRESTests, TestPhiIncludesConstraintValues) {
+    // Beale with the constraint x + y <= 3, which cuts off the optimum at (3, 0.5)
+    SRES sres(cost, 10, 50, {1.0, 1.0}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setNumConstraints(1);
+    bool more = true;
+    while (more) {
+        CandidateBatch candidates = sres.ask();
+        std::vector<double> fitness(candidates.numCandidates), constraint(candidates.numCandidates);
+        for (size_t i = 0; i < candidates.numCandidates; i++) {
+            fitness[i] = cost(candidates[i]);
+            constraint[i] = candidates[i][0] + candidates[i][1] - 3.0;
+        }
+        more = sres.tell(fitness.data(), constraint.data());
+
+        for (const Individual &individual: sres.getBestIndividuals(sres.getPopulationSize())) {
+            double violation = std::max(individual.parameters[0] + individual.parameters[1] - 3.0, 0.0);
+            ASSERT_DOUBLE_EQ(violation * violation, individual.phi);
+        }
+    }
+    const auto &solution = sres.getSolutionValues();
+    ASSERT_LE(solution[0] + solution[1], 3.0);
+}
+
+TEST_F(CSRESTests, TestTellWithoutConstraintValuesThrows) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setNumConstraints(1);
+    CandidateBatch candidates = sres.ask();
+    std::vector<double> fitness(candidates.numCandidates);
+    ASSERT_THROW(sres.tell(fitness.data()), std::invalid_argument);
+}
+
+void sumConstraint(double *parameters, double *constraintValues) {
+    constraintValues[0] = parameters[0] + parameters[1] - 3.0;
+}
+
+std::atomic<int> numCostCalls{0};
 
+double countedCost(double *input_params) {
+    numCostCalls++;
+    return cost(input_params);
+}
 
+TEST_F(CSRESTests, TestConstraintFunctionGivesSameResultAsAskTell) {
+    // putting off the cost function of infeasible children with a pf
+    // of 0, and evaluating them all otherwise, gives the same ranking
+    for (double pf: {0.0, 0.475}) {
+        SRES fitted(countedCost, 10, 50, {1.0, 1.0}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        fitted.setSeed(4);
+        fitted.setPf(pf);
+        fitted.setConstraintFunction(sumConstraint, 1);
+        numCostCalls = 0;
+        fitted.fit();
+
+        SRES sres(cost, 10, 50, {1.0, 1.0}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        sres.setSeed(4);
+        sres.setPf(pf);
+        sres.setNumConstraints(1);
+        int numCandidates = 0;
+        bool more = true;
+        while (more) {
+            CandidateBatch candidates = sres.ask();
+            numCandidates += (int) candidates.numCandidates;
+            std::vector<double> fitness(candidates.numCandidates), constraint(candidates.numCandidates);
+            for (size_t i = 0; i < candidates.numCandidates; i++) {
+                fitness[i] = cost(candidates[i]);
+                sumConstraint(candidates[i], &constraint[i]);
+            }
+            more = sres.tell(fitness.data(), constraint.data());
+        }
 
+        ASSERT_EQ(sres.getBestFitnessValue(), fitted.getBestFitnessValue());
+        ASSERT_EQ(sres.getSolutionValues(), fitted.getSolutionValues());
+        ASSERT_EQ(sres.getHallOfFame(), fitted.getHallOfFame());
+        if (pf == 0.0) {
+            ASSERT_GT(fitted.getNumSkippedEvaluations(), 0);
+        } else {
+            ASSERT_EQ(0, fitted.getNumSkippedEvaluations());
+        }
+        ASSERT_EQ(numCandidates, numCostCalls + (int) fitted.getNumSkippedEvaluations());
+    }
+}
 
+TEST_F(CSRESTests, TestStochasticRankingIsRunarssonYao) {
+    // with random comparisons the parents must be those of the full
+    // ranking of Runarsson and Yao, up to lambda sweeps over the whole
+    // population, since a random comparison can move an individual
+    // out of the top after any number of sweeps
+    const int populationSize = 5;
+    const double pf = 0.475;
+    SRES sres(cost, populationSize, 30, {1.0, 1.0}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setPf(pf);
+    sres.setNumConstraints(1);
+
+    struct Key {
+        double fitness;
+        double phi;
+    };
+    std::map<double, double> phiOfFitness;
+    std::vector<Key> parents;
+    bool more = true;
+    while (more) {
+        CandidateBatch candidates = sres.ask();
+        std::vector<double> fitness(candidates.numCandidates), constraint(candidates.numCandidates);
+        std::vector<Key> keys = parents;
+        for (size_t i = 0; i < candidates.numCandidates; i++) {
+            fitness[i] = cost(candidates[i]);
+            sumConstraint(candidates[i], &constraint[i]);
+            double violation = std::max(constraint[i], 0.0);
+            phiOfFitness[fitness[i]] = violation * violation;
+            keys.push_back({fitness[i], violation * violation});
+        }
+        more = sres.tell(fitness.data(), constraint.data());
+
+        const auto &rankedFitness = sres.getPopulationFitness();
+        if (!parents.empty()) {
+            RandomNumberGenerator rng = RandomNumberGenerator(4).substream(
+                    sres.getCurrentGeneration(), RandomNumberGenerator::SelectStream);
+            for (size_t sweep = 0; sweep < keys.size(); sweep++) {
+                bool wasSwapped = false;
+                for (size_t j = 0; j + 1 < keys.size(); j++) {
+                    bool byFitness = (keys[j].phi == 0 && keys[j + 1].phi == 0) || rng.uniformReal(0, 1) < pf;
+                    if (byFitness ? keys[j].fitness > keys[j + 1].fitness : keys[j].phi > keys[j + 1].phi) {
+                        std::swap(keys[j], keys[j + 1]);
+                        wasSwapped = true;
+                    }
+                }
+                if (!wasSwapped)
+                    break;
+            }
+            for (int i = 0; i < populationSize; i++)
+                ASSERT_EQ(keys[i].fitness, rankedFitness[i]) << "generation " << sres.getCurrentGeneration();
+        }
 
+        parents.clear();
+        for (int i = 0; i < populationSize; i++)
+            parents.push_back({rankedFitness[i], phiOfFitness.at(rankedFitness[i])});
+    }
+}
 
+TEST_F(CSRESTests, TestFitnessCacheGivesSameResult) {
+    for (bool batch: {false, true}) {
+        SRES reference(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        reference.setSeed(4);
+        reference.fit();
+
+        SRES cached = batch ? SRES(batchCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7)
+                            : SRES(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        cached.setSeed(4);
+        cached.setFitnessCache(1000);
+        cached.fit();
+
+        ASSERT_EQ(reference.getBestFitnessValue(), cached.getBestFitnessValue());
+        ASSERT_EQ(reference.getSolutionValues(), cached.getSolutionValues());
+        ASSERT_EQ(reference.getHallOfFame(), cached.getHallOfFame());
+    }
+}
 
+TEST_F(CSRESTests, TestQuantizedFitnessCacheSkipsCostCalls) {
+    SRES sres(countedCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setFitnessCache(1000, 0.01);
+    numCostCalls = 0;
+    sres.fit();
 
+    // late generations cluster around the optimum, so
+    // children often round to an earlier individual
+    const FitnessCache *cache = sres.getFitnessCache();
+    ASSERT_NE(nullptr, cache);
+    ASSERT_GT(cache->getHits(), 0);
+    ASSERT_EQ(cache->getMisses(), (std::uint64_t) numCostCalls);
+    ASSERT_EQ(10 + 60 * (sres.getCurrentGeneration() - 1), cache->getHits() + cache->getMisses());
+}
 
+TEST_F(CSRESTests, TestEvaluationStoreIsReusedByLaterRuns) {
+    std::string path = ::testing::TempDir() + "sres_TestEvaluationStoreIsReusedByLaterRuns.evaluations";
+    std::remove(path.c_str());
+    std::remove((path + ".index").c_str());
+
+    SRES first(countedCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    first.setSeed(4);
+    first.setEvaluationStore(path);
+    numCostCalls = 0;
+    first.fit();
+    int firstCalls = numCostCalls;
+    first.getEvaluationStore()->flush();
+    ASSERT_EQ(firstCalls, first.getEvaluationStore()->size());
+    // every record holds how long its cost call took
+    for (size_t i = 0; i < first.getEvaluationStore()->size(); i++) {
+        double seconds = first.getEvaluationStore()->getRecord(i).seconds;
+        ASSERT_GE(seconds, 0.0);
+        ASSERT_LT(seconds, 1.0);
+    }
+    first.setEvaluationStore("");
+
+    // the same seed asks for the same candidates, which are all on disk
+    SRES second(countedCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    second.setSeed(4);
+    second.setEvaluationStore(path);
+    numCostCalls = 0;
+    second.fit();
+    ASSERT_EQ(0, numCostCalls);
+    ASSERT_EQ(first.getBestFitnessValue(), second.getBestFitnessValue());
+    ASSERT_EQ(first.getSolutionValues(), second.getSolutionValues());
+    second.setEvaluationStore("");
+
+    std::remove(path.c_str());
+    std::remove((path + ".index").c_str());
+}
 
+std::vector<GenerationInfo> reportedGenerations;
 
+int stopAtGeneration = 0;
 
+int recordGeneration(const GenerationInfo *info) {
+    reportedGenerations.push_back(*info);
+    return info->generation == stopAtGeneration;
+}
 
+TEST_F(CSRESTests, TestGenerationCallbackSeesEveryGeneration) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setGenerationCallback(recordGeneration);
+    reportedGenerations.clear();
+    stopAtGeneration = 0;
+    sres.fit();
 
+    ASSERT_EQ(sres.getCurrentGeneration(), reportedGenerations.size());
+    for (size_t g = 0; g < reportedGenerations.size(); g++) {
+        const GenerationInfo &info = reportedGenerations[g];
+        ASSERT_EQ(g + 1, info.generation);
+        ASSERT_EQ(10 + 60 * g, info.numEvaluations);
+        ASSERT_LE(info.bestFitness, info.medianFitness);
+        // only the bounds count towards phi and the parents are inside them
+        ASSERT_EQ(1.0, info.feasibleFraction);
+        ASSERT_GT(info.meanSigma, 0);
+        if (g > 0) {
+            ASSERT_LE(info.bestFitness, reportedGenerations[g - 1].bestFitness);
+            ASSERT_GE(info.elapsedSeconds, reportedGenerations[g - 1].elapsedSeconds);
+        }
+    }
+    ASSERT_EQ(sres.getBestFitnessValue(), reportedGenerations.back().bestFitness);
+}
+
+/**
+ * feasible in a small corner of the box only
+ */
+void cornerConstraint(double *parameters, double *constraintValues) {
+    constraintValues[0] = parameters[0] + parameters[1] - 0.25;
+}
 
+TEST_F(CSRESTests, TestMedianFitnessLeavesOutUnevaluatedParents) {
+    // almost all of the box is infeasible, so the parents are infeasible
+    // children whose cost function was never called for a while
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setPf(0);
+    sres.setConstraintFunction(cornerConstraint, 1);
+    sres.setGenerationCallback(recordGeneration);
+    reportedGenerations.clear();
+    stopAtGeneration = 0;
+    sres.fit();
+
+    ASSERT_GT(sres.getNumSkippedEvaluations(), 0);
+    // the initial population is always evaluated
+    ASSERT_TRUE(std::isfinite(reportedGenerations.front().medianFitness));
+    for (const GenerationInfo &info: reportedGenerations)
+        ASSERT_FALSE(std::isinf(info.medianFitness)) << info.generation;
+}
 
+TEST_F(CSRESTests, TestGenerationCallbackStopsTheRun) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setGenerationCallback(recordGeneration);
+    reportedGenerations.clear();
+    stopAtGeneration = 5;
+    sres.fit();
+    ASSERT_TRUE(sres.isFinished());
+    ASSERT_EQ(5, sres.getCurrentGeneration());
+    ASSERT_EQ(5, reportedGenerations.size());
+}
+
+TEST_F(CSRESTests, TestGenerationCallbackIsRateLimited) {
+    SRES sres(cost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.setGenerationCallback(recordGeneration, 10);
+    reportedGenerations.clear();
+    stopAtGeneration = 0;
+    sres.fit();
+
+    // every 10th generation and the last one
+    ASSERT_EQ(sres.getCurrentGeneration() / 10 + (sres.getCurrentGeneration() % 10 != 0),
+              reportedGenerations.size());
+    for (size_t g = 0; g + 1 < reportedGenerations.size(); g++)
+        ASSERT_EQ(10 * (g + 1), reportedGenerations[g].generation);
+    ASSERT_EQ(sres.getCurrentGeneration(), reportedGenerations.back().generation);
+}
@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include "Cancellation.h"
+#include "SRES.h"
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace opt;
+
+namespace {
+    std::atomic<int> numCalls{0};
+
+    /**
+     * @brief cancelled by the cost function once it has been called cancelAfter times
+     */
+    SRES *cancelTarget = nullptr;
+
+    int cancelAfter = 0;
+
+    bool cancelWithSignal = false;
+
+    typedef void (*SignalHandler)(int);
+
+    /**
+     * @brief the handler installed for SIGTERM, left in place
+     */
+    SignalHandler currentTerminateHandler() {
+        SignalHandler handler = std::signal(SIGTERM, SIG_DFL);
+        std::signal(SIGTERM, handler);
+        return handler;
+    }
+}
+
+/**
+ * minimum = f(3, 0.5) = 0
+ */
+double cancellingCost(double *x) {
+    if (++numCalls == cancelAfter) {
+        if (cancelWithSignal)
+            std::raise(SIGTERM);
+        else
+            cancelTarget->cancel();
+    }
+    return pow(1.5 - x[0] + x[0] * x[1], 2) +
+           pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2) +
+           pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+}
+
+class CancellationTests : public ::testing::Test {
+
+public:
+    CancellationTests() {
+        numCalls = 0;
+        cancelTarget = nullptr;
+        cancelAfter = 0;
+        cancelWithSignal = false;
+        path = ::testing::TempDir() + "sres_cancellation.checkpoint";
+        std::remove(path.c_str());
+    }
+
+    ~CancellationTests() override {
+        std::remove(path.c_str());
+    }
+
+    static SRES makeSRES() {
+        SRES sres(cancellingCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        sres.setSeed(4);
+        return sres;
+    }
+
+    std::string path;
+};
+
+TEST_F(CancellationTests, CancellationToken) {
+    CancellationToken token;
+    ASSERT_FALSE(token.isCancelled());
+    token.cancel();
+    ASSERT_TRUE(token.isCancelled());
+    token.reset();
+    ASSERT_FALSE(token.isCancelled());
+}
+
+TEST_F(CancellationTests, CancelledBeforeTheRunStarts) {
+    SRES sres = makeSRES();
+    sres.cancel();
+    sres.fit();
+    ASSERT_EQ(0, numCalls);
+    ASSERT_FALSE(sres.isFinished());
+}
+
+TEST_F(CancellationTests, CancelledRunResumesWhereItStopped) {
+    SRES uninterrupted = makeSRES();
+    uninterrupted.fit();
+
+    for (int numThreads: {1, 4}) {
+        SRES sres = makeSRES();
+        sres.setNumThreads(numThreads);
+        cancelTarget = &sres;
+        numCalls = 0;
+        // 10 for the initial population, 60 children per generation, so
+        // this is part way through the children of generation 3
+        cancelAfter = 100;
+        sres.fit();
+
+        ASSERT_TRUE(sres.isCancelled());
+        ASSERT_FALSE(sres.isFinished());
+        ASSERT_EQ(2, sres.getCurrentGeneration());
+        if (numThreads == 1) {
+            ASSERT_EQ(100, numCalls);
+        }
+
+        sres.resetCancellation();
+        sres.resume();
+        ASSERT_TRUE(sres.isFinished());
+        ASSERT_EQ(uninterrupted.getCurrentGeneration(), sres.getCurrentGeneration());
+        ASSERT_EQ(uninterrupted.getBestFitnessValue(), sres.getBestFitnessValue());
+        ASSERT_EQ(uninterrupted.getSolutionValues(), sres.getSolutionValues());
+    }
+}
+
+TEST_F(CancellationTests, CancelledRunSavesACheckpoint) {
+    SRES uninterrupted = makeSRES();
+    uninterrupted.fit();
+
+    SRES sres = makeSRES();
+    sres.setCheckpointSchedule(path, 1000);
+    cancelTarget = &sres;
+    numCalls = 0;
+    cancelAfter = 100;
+    sres.fit();
+
+    SRES resumed = makeSRES();
+    ASSERT_TRUE(sres.isCancelled());
+    resumed.loadCheckpoint(path);
+    ASSERT_EQ(2, resumed.getCurrentGeneration());
+    resumed.resume();
+    ASSERT_EQ(uninterrupted.getBestFitnessValue(), resumed.getBestFitnessValue());
+    ASSERT_EQ(uninterrupted.getSolutionValues(), resumed.getSolutionValues());
+}
+
+TEST_F(CancellationTests, SignalCancelsTheRun) {
+    SRES sres = makeSRES();
+    sres.setCancelOnSignal(true);
+    cancelAfter = 100;
+    cancelWithSignal = true;
+    sres.fit();
+    sres.setCancelOnSignal(false);
+
+    ASSERT_TRUE(sres.isCancelled());
+    ASSERT_EQ(2, sres.getCurrentGeneration());
+    ASSERT_EQ(100, numCalls);
+}
+
+TEST_F(CancellationTests, OnlyTheOptimizerReceivingSignalsRestoresTheHandlers) {
+    SignalHandler before = currentTerminateHandler();
+    SRES first = makeSRES();
+    SRES second = makeSRES();
+    first.setCancelOnSignal(true);
+    SignalHandler installed = currentTerminateHandler();
+    ASSERT_NE(before, installed);
+
+    // second takes the signals over, so first has nothing to restore
+    second.setCancelOnSignal(true);
+    first.setCancelOnSignal(false);
+    ASSERT_EQ(installed, currentTerminateHandler());
+    std::raise(SIGTERM);
+    ASSERT_TRUE(second.isCancelled());
+    ASSERT_FALSE(first.isCancelled());
+
+    second.setCancelOnSignal(false);
+    ASSERT_EQ(before, currentTerminateHandler());
+}
+
+TEST_F(CancellationTests, DestroyedOptimizerRestoresTheHandlers) {
+    SignalHandler before = currentTerminateHandler();
+    {
+        SRES sres = makeSRES();
+        sres.setCancelOnSignal(true);
+        ASSERT_NE(before, currentTerminateHandler());
+    }
+    ASSERT_EQ(before, currentTerminateHandler());
+}
+
+TEST_F(CancellationTests, OptimizersDoNotShareTokens) {
+    static_assert(!std::is_copy_constructible<SRES>::value, "a copy would share the cancellation token");
+    SRES original = makeSRES();
+    std::shared_ptr<CancellationToken> token = original.getCancellationToken();
+    SRES moved = std::move(original);
+    ASSERT_EQ(token, moved.getCancellationToken());
+
+    SRES other = makeSRES();
+    other.cancel();
+    ASSERT_FALSE(moved.isCancelled());
+}
@@ -0,0 +1,171 @@
+#include "gtest/gtest.h"
+#include "Checkpoint.h"
+#include "Error.h"
+#include "SRES.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace opt;
+
+/**
+ * minimum = f(3, 0.5) = 0
+ */
+double checkpointCost(double *x) {
+    return pow(1.5 - x[0] + x[0] * x[1], 2) +
+           pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2) +
+           pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+}
+
+class CheckpointTests : public ::testing::Test {
+
+public:
+    CheckpointTests() {
+        const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = ::testing::TempDir() + "sres_" + info->name() + ".checkpoint";
+        removeFiles();
+    }
+
+    ~CheckpointTests() override {
+        removeFiles();
+    }
+
+    void removeFiles() const {
+        std::remove(path.c_str());
+        std::remove((path + ".tmp").c_str());
+    }
+
+    static SRES makeSRES() {
+        SRES sres(checkpointCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+        sres.setSeed(4);
+        return sres;
+    }
+
+    std::string readFile() const {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    }
+
+    void writeFile(const std::string &contents) const {
+        std::ofstream out(path, std::ios::binary);
+        out << contents;
+    }
+
+    std::string path;
+};
+
+TEST_F(CheckpointTests, BinaryReaderReadsWhatWasWritten) {
+    BinaryWriter writer;
+    writer.write<std::int32_t>(-3);
+    writer.write(2.5);
+    writer.writeVector(std::vector<double>{1.0, 2.0, 3.0});
+    std::vector<std::uint8_t> flags = {1, 0};
+    writer.writeArray(flags.data(), flags.size());
+
+    std::string data = writer.release();
+    BinaryReader reader(data);
+    ASSERT_EQ(-3, reader.read<std::int32_t>());
+    ASSERT_EQ(2.5, reader.read<double>());
+    ASSERT_EQ(std::vector<double>({1.0, 2.0, 3.0}), reader.readVector<double>());
+    std::vector<std::uint8_t> readFlags(2);
+    reader.readArray(readFlags.data(), readFlags.size());
+    ASSERT_EQ(flags, readFlags);
+    ASSERT_TRUE(reader.atEnd());
+    ASSERT_THROW(reader.read<double>(), std::invalid_argument);
+}
+
+TEST_F(CheckpointTests, BinaryReaderChecksArraySizes) {
+    BinaryWriter writer;
+    writer.writeVector(std::vector<double>{1.0, 2.0, 3.0});
+    std::string data = writer.release();
+    std::vector<double> values(2);
+    BinaryReader reader(data);
+    ASSERT_THROW(reader.readArray(values.data(), values.size()), std::invalid_argument);
+}
+
+TEST_F(CheckpointTests, FileRoundTrip) {
+    writeCheckpointFile(path, "a payload");
+    ASSERT_EQ("a payload", readCheckpointFile(path));
+    std::ifstream tmp(path + ".tmp");
+    ASSERT_FALSE(tmp.good());
+}
+
+TEST_F(CheckpointTests, CorruptFileThrows) {
+    writeCheckpointFile(path, "a payload");
+    std::string contents = readFile();
+    contents[contents.size() / 2] ^= 1;
+    writeFile(contents);
+    ASSERT_THROW(readCheckpointFile(path), std::invalid_argument);
+}
+
+TEST_F(CheckpointTests, TruncatedFileThrows) {
+    writeCheckpointFile(path, "a payload");
+    std::string contents = readFile();
+    writeFile(contents.substr(0, contents.size() - 3));
+    ASSERT_THROW(readCheckpointFile(path), std::invalid_argument);
+}
+
+TEST_F(CheckpointTests, MissingFileThrows) {
+    ASSERT_THROW(readCheckpointFile(path), FileNotFoundError);
+}
+
+TEST_F(CheckpointTests, ResumedRunMatchesUninterruptedRun) {
+    SRES uninterrupted = makeSRES();
+    uninterrupted.fit();
+
+    SRES interrupted = makeSRES();
+    interrupted.step(5);
+    interrupted.saveCheckpoint(path);
+
+    SRES resumed = makeSRES();
+    resumed.loadCheckpoint(path);
+    ASSERT_EQ(interrupted.getCurrentGeneration(), resumed.getCurrentGeneration());
+    ASSERT_EQ(interrupted.getNumEvaluations(), resumed.getNumEvaluations());
+    resumed.resume();
+
+    ASSERT_EQ(uninterrupted.getCurrentGeneration(), resumed.getCurrentGeneration());
+    ASSERT_EQ(uninterrupted.getNumEvaluations(), resumed.getNumEvaluations());
+    ASSERT_EQ(uninterrupted.getBestFitnessValue(), resumed.getBestFitnessValue());
+    ASSERT_EQ(uninterrupted.getSolutionValues(), resumed.getSolutionValues());
+    ASSERT_EQ(uninterrupted.getHallOfFame(), resumed.getHallOfFame());
+}
+
+TEST_F(CheckpointTests, ScheduledCheckpoints) {
+    SRES scheduled = makeSRES();
+    scheduled.setCheckpointSchedule(path, 3);
+    scheduled.step(7);
+    scheduled.flushCheckpoints();
+
+    // the initial population is generation 1, so step(7) ends after
+    // generation 8 and the last checkpoint was taken after generation 6
+    SRES resumed = makeSRES();
+    resumed.loadCheckpoint(path);
+    ASSERT_EQ(6, resumed.getCurrentGeneration());
+
+    // and once more when the run finishes
+    scheduled.resume();
+    scheduled.flushCheckpoints();
+    SRES finished = makeSRES();
+    finished.loadCheckpoint(path);
+    ASSERT_TRUE(finished.isFinished());
+    ASSERT_EQ(scheduled.getCurrentGeneration(), finished.getCurrentGeneration());
+    ASSERT_EQ(scheduled.getBestFitnessValue(), finished.getBestFitnessValue());
+}
+
+TEST_F(CheckpointTests, CheckpointOfAnotherProblemThrows) {
+    SRES sres = makeSRES();
+    sres.step(1);
+    sres.saveCheckpoint(path);
+
+    SRES other(checkpointCost, 12, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    ASSERT_THROW(other.loadCheckpoint(path), std::invalid_argument);
+}
+
+TEST_F(CheckpointTests, SaveDuringAGenerationThrows) {
+    SRES sres = makeSRES();
+    sres.ask();
+    ASSERT_THROW(sres.saveCheckpoint(path), std::logic_error);
+}
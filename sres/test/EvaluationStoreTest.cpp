@@ -0,0 +1,120 @@
+#include "gtest/gtest.h"
+#include "EvaluationStore.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace opt;
+
+class EvaluationStoreTests : public ::testing::Test {
+
+public:
+    EvaluationStoreTests() {
+        const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = ::testing::TempDir() + "sres_" + info->name() + ".evaluations";
+        removeFiles();
+    }
+
+    ~EvaluationStoreTests() override {
+        removeFiles();
+    }
+
+    void removeFiles() const {
+        std::remove(path.c_str());
+        std::remove((path + ".index").c_str());
+    }
+
+    std::string path;
+};
+
+TEST_F(EvaluationStoreTests, AppendThenLookup) {
+    EvaluationStore store(path, 2);
+    std::vector<double> x = {1.0, 2.0};
+    double fitness = 0;
+    ASSERT_FALSE(store.lookup(x.data(), fitness));
+
+    store.append(x.data(), 3.5, 0.25, 0.125);
+    store.flush();
+    ASSERT_EQ(1, store.size());
+    ASSERT_TRUE(store.lookup(x.data(), fitness));
+    ASSERT_EQ(3.5, fitness);
+    ASSERT_EQ(1, store.getHits());
+    ASSERT_EQ(1, store.getMisses());
+
+    EvaluationRecord record = store.getRecord(0);
+    ASSERT_EQ(x, record.parameters);
+    ASSERT_EQ(3.5, record.fitness);
+    ASSERT_EQ(0.25, record.phi);
+    ASSERT_EQ(0.125, record.seconds);
+}
+
+TEST_F(EvaluationStoreTests, DuplicatesAreWrittenOnce) {
+    EvaluationStore store(path, 2);
+    std::vector<double> x = {1.0, 2.0};
+    store.append(x.data(), 3.5, 0, 0);
+    store.append(x.data(), 3.5, 0, 0);
+    store.flush();
+    ASSERT_EQ(1, store.size());
+}
+
+TEST_F(EvaluationStoreTests, ReopenedStoreKeepsRecords) {
+    // enough records to grow both the log and the index
+    const int n = 5000;
+    {
+        EvaluationStore store(path, 3);
+        for (int i = 0; i < n; i++) {
+            std::vector<double> x = {(double) i, i * 0.5, -i * 0.25};
+            store.append(x.data(), i * 2.0, 0, 0);
+        }
+    }
+
+    EvaluationStore store(path, 3);
+    ASSERT_EQ(n, store.size());
+    for (int i = 0; i < n; i++) {
+        std::vector<double> x = {(double) i, i * 0.5, -i * 0.25};
+        double fitness;
+        ASSERT_TRUE(store.lookup(x.data(), fitness)) << i;
+        ASSERT_EQ(i * 2.0, fitness);
+    }
+}
+
+TEST_F(EvaluationStoreTests, MissingIndexIsRebuilt) {
+    std::vector<double> x = {1.0, 2.0};
+    {
+        EvaluationStore store(path, 2);
+        store.append(x.data(), 3.5, 0, 0);
+    }
+    std::remove((path + ".index").c_str());
+
+    EvaluationStore store(path, 2);
+    double fitness;
+    ASSERT_TRUE(store.lookup(x.data(), fitness));
+    ASSERT_EQ(3.5, fitness);
+}
+
+TEST_F(EvaluationStoreTests, StridedParameters) {
+    EvaluationStore store(path, 3);
+    std::vector<double> columnMajor = {1, 4, 2, 5, 3, 6};
+    std::vector<double> row = {4, 5, 6};
+    store.append(columnMajor.data() + 1, 7.0, 0, 0, 2);
+    store.flush();
+    double fitness;
+    ASSERT_TRUE(store.lookup(row.data(), fitness));
+    ASSERT_EQ(7.0, fitness);
+}
+
+TEST_F(EvaluationStoreTests, WrongNumberOfParametersThrows) {
+    {
+        EvaluationStore store(path, 2);
+    }
+    ASSERT_THROW(EvaluationStore(path, 3), std::invalid_argument);
+}
+
+TEST_F(EvaluationStoreTests, NotAStoreThrows) {
+    {
+        std::ofstream file(path);
+        file << "not an evaluation store, but long enough to have a header of 64 bytes in it";
+    }
+    ASSERT_THROW(EvaluationStore(path, 2), std::invalid_argument);
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include "FitnessCache.h"
+#include "RandomNumberGenerator.h"
+#include <list>
+#include <map>
+#include <vector>
+
+using namespace opt;
+
+class FitnessCacheTests : public ::testing::Test {
+
+public:
+    FitnessCacheTests() = default;
+
+};
+
+TEST_F(FitnessCacheTests, HitsAndMisses) {
+    FitnessCache cache(4, 2);
+    double fitness = 0;
+    std::vector<double> x = {1.0, 2.0};
+    ASSERT_FALSE(cache.lookup(x.data(), fitness));
+    cache.insert(x.data(), 3.5);
+    ASSERT_TRUE(cache.lookup(x.data(), fitness));
+    ASSERT_EQ(3.5, fitness);
+
+    std::vector<double> y = {1.0, 2.0000000001};
+    ASSERT_FALSE(cache.lookup(y.data(), fitness));
+    ASSERT_EQ(1, cache.getHits());
+    ASSERT_EQ(2, cache.getMisses());
+    ASSERT_EQ(1, cache.size());
+}
+
+TEST_F(FitnessCacheTests, NegativeZeroIsZero) {
+    FitnessCache cache(4, 1);
+    double zero = 0.0, negativeZero = -0.0, fitness;
+    cache.insert(&zero, 1.0);
+    ASSERT_TRUE(cache.lookup(&negativeZero, fitness));
+}
+
+TEST_F(FitnessCacheTests, QuantizedKeys) {
+    FitnessCache cache(4, 2, 0.01);
+    double fitness = 0;
+    std::vector<double> x = {1.0, 2.0};
+    std::vector<double> near = {1.001, 1.999};
+    std::vector<double> far = {1.02, 2.0};
+    cache.insert(x.data(), 3.5);
+    ASSERT_TRUE(cache.lookup(near.data(), fitness));
+    ASSERT_EQ(3.5, fitness);
+    ASSERT_FALSE(cache.lookup(far.data(), fitness));
+}
+
+TEST_F(FitnessCacheTests, StridedParameters) {
+    // the second column of a column major 2 x 3 matrix
+    FitnessCache cache(4, 3);
+    std::vector<double> columnMajor = {1, 4, 2, 5, 3, 6};
+    std::vector<double> row = {4, 5, 6};
+    double fitness;
+    cache.insert(columnMajor.data() + 1, 7.0, 2);
+    ASSERT_TRUE(cache.lookup(row.data(), fitness));
+    ASSERT_EQ(7.0, fitness);
+}
+
+TEST_F(FitnessCacheTests, EvictsLeastRecentlyUsed) {
+    FitnessCache cache(2, 1);
+    double a = 1, b = 2, c = 3, fitness;
+    cache.insert(&a, 1);
+    cache.insert(&b, 2);
+    // a is now more recently used than b
+    ASSERT_TRUE(cache.lookup(&a, fitness));
+    cache.insert(&c, 3);
+    ASSERT_EQ(2, cache.size());
+    ASSERT_TRUE(cache.lookup(&a, fitness));
+    ASSERT_FALSE(cache.lookup(&b, fitness));
+    ASSERT_TRUE(cache.lookup(&c, fitness));
+}
+
+TEST_F(FitnessCacheTests, MatchesReferenceModel) {
+    // random traffic over a small key space so the table sees plenty
+    // of collisions, evictions and backward shifts
+    const size_t capacity = 37;
+    FitnessCache cache(capacity, 2, 0.5);
+    std::list<std::pair<int, int>> recency;
+    std::map<std::pair<int, int>, double> values;
+
+    RandomNumberGenerator rng(4);
+    for (int step = 0; step < 20000; step++) {
+        std::pair<int, int> key = {(int) rng.uniformInt(0, 12), (int) rng.uniformInt(0, 12)};
+        std::vector<double> x = {key.first * 0.5, key.second * 0.5};
+
+        double fitness;
+        bool hit = cache.lookup(x.data(), fitness);
+        auto found = values.find(key);
+        ASSERT_EQ(found != values.end(), hit) << step;
+        if (hit) {
+            ASSERT_EQ(found->second, fitness);
+            recency.remove(key);
+            recency.push_front(key);
+            continue;
+        }
+
+        cache.insert(x.data(), (double) step);
+        if (values.size() == capacity) {
+            values.erase(recency.back());
+            recency.pop_back();
+        }
+        values[key] = (double) step;
+        recency.push_front(key);
+        ASSERT_EQ(values.size(), cache.size());
+    }
+}
+
+TEST_F(FitnessCacheTests, ClearForgetsEverything) {
+    FitnessCache cache(4, 1);
+    double a = 1, fitness;
+    cache.insert(&a, 1);
+    cache.lookup(&a, fitness);
+    cache.clear();
+    ASSERT_EQ(0, cache.size());
+    ASSERT_EQ(0, cache.getHits());
+    ASSERT_FALSE(cache.lookup(&a, fitness));
+}
+
+TEST_F(FitnessCacheTests, ZeroCapacityThrows) {
+    ASSERT_THROW(FitnessCache(0, 2), std::invalid_argument);
+}
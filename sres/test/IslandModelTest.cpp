@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include "IslandModel.h"
+#include <cmath>
+
+using namespace opt;
+
+/**
+ * minimum = f(3, 0.5) = 0
+ */
+double islandBeale(double *x) {
+    double first = pow(1.5 - x[0] + x[0] * x[1], 2);
+    double second = pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2);
+    double third = pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+    return first + second + third;
+}
+
+class IslandModelTests : public ::testing::Test {
+
+public:
+    IslandModelTests() = default;
+
+    static IslandModel makeModel(int numIslands) {
+        IslandModel model(islandBeale, numIslands, 20, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0});
+        model.setSeed(4);
+        model.setMigrationInterval(5);
+        model.setMigrationSize(2);
+        return model;
+    }
+};
+
+TEST_F(IslandModelTests, FindsMinimum) {
+    IslandModel model = makeModel(4);
+    model.fit();
+    ASSERT_NEAR(0.0, model.getBestFitnessValue(), 1e-3);
+    ASSERT_NEAR(3.0, model.getSolutionValues()[0], 0.1);
+    ASSERT_NEAR(0.5, model.getSolutionValues()[1], 0.1);
+    ASSERT_GT(model.getNumMigrations(), 0);
+}
+
+TEST_F(IslandModelTests, ReportsHallOfFamePerIsland) {
+    IslandModel model = makeModel(3);
+    model.fit();
+    DoubleMatrix hallsOfFame = model.getHallsOfFame();
+    ASSERT_EQ(3, hallsOfFame.size());
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(hallsOfFame[i], model.getHallOfFame(i));
+        ASSERT_FALSE(hallsOfFame[i].empty());
+    }
+    ASSERT_EQ(model.getBestFitnessValue(), model.getIsland(model.getBestIsland()).getBestFitnessValue());
+}
+
+TEST_F(IslandModelTests, ResultDoesNotDependOnNumberOfThreads) {
+    for (auto topology: {IslandModel::Ring, IslandModel::Random}) {
+        IslandModel serial = makeModel(4);
+        serial.setTopology(topology);
+        serial.setNumThreads(1);
+        serial.fit();
+
+        IslandModel parallel = makeModel(4);
+        parallel.setTopology(topology);
+        parallel.setNumThreads(4);
+        parallel.fit();
+
+        ASSERT_EQ(serial.getHallsOfFame(), parallel.getHallsOfFame());
+        ASSERT_EQ(serial.getSolutionValues(), parallel.getSolutionValues());
+    }
+}
+
+TEST_F(IslandModelTests, IslandsHaveDifferentSeeds) {
+    IslandModel model = makeModel(2);
+    ASSERT_NE(model.getIsland(0).getSeed(), model.getIsland(1).getSeed());
+}
+
+TEST_F(IslandModelTests, MigrantsReplaceWorstParents) {
+    SRES sres(islandBeale, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0});
+    sres.setSeed(4);
+    std::vector<double> fitness(70);
+    for (int g = 0; g < 3; g++) {
+        CandidateBatch candidates = sres.ask();
+        for (size_t c = 0; c < candidates.numCandidates; c++)
+            fitness[c] = islandBeale(candidates[c]);
+        sres.tell(fitness.data());
+    }
+    Individual migrant{{3.0, 0.5}, {0.1, 0.1}, 0.0, 0.0};
+    sres.immigrate({migrant});
+    std::vector<Individual> best = sres.getBestIndividuals(1);
+    ASSERT_EQ(migrant.parameters, best[0].parameters);
+    ASSERT_EQ(migrant.variances, best[0].variances);
+    ASSERT_EQ(0.0, best[0].fitness);
+}
+
+TEST_F(IslandModelTests, ImmigrateBeforeTellThrows) {
+    SRES sres(islandBeale, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0});
+    sres.ask();
+    Individual migrant{{3.0, 0.5}, {0.1, 0.1}, 0.0, 0.0};
+    ASSERT_THROW(sres.immigrate({migrant}), std::logic_error);
+}
+
+TEST_F(IslandModelTests, MigrationSizeLargerThanPopulationThrows) {
+    IslandModel model = makeModel(2);
+    ASSERT_THROW(model.setMigrationSize(21), std::invalid_argument);
+}
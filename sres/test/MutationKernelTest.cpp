@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "MutationKernel.h"
+#include "RandomNumberGenerator.h"
+#include <cmath>
+#include <vector>
+
+using namespace opt;
+
+class MutationKernelTests : public ::testing::Test {
+
+public:
+    MutationKernelTests() = default;
+
+    /**
+     * @brief random inputs for a kernel call with n parameters. Bounds
+     * are tight enough that a good share of steps fall outside them.
+     */
+    struct Inputs {
+        explicit Inputs(size_t n) : x(n), variance(n), maxVariance(n), lb(n), ub(n),
+                                    varianceNormals(n), stepNormals(n), outOfBounds(n) {
+            RandomNumberGenerator rng(4);
+            for (size_t j = 0; j < n; j++) {
+                lb[j] = rng.uniformReal(-10, 0);
+                ub[j] = rng.uniformReal(0, 10);
+                x[j] = rng.uniformReal(lb[j], ub[j]);
+                variance[j] = rng.uniformReal(0.1, 5);
+                maxVariance[j] = rng.uniformReal(1, 5);
+            }
+            rng.fillNormal(varianceNormals.data(), n);
+            rng.fillNormal(stepNormals.data(), n);
+        }
+
+        size_t run(SimdLevel level) {
+            return mutationKernel(level, x.size(), x.data(), variance.data(), maxVariance.data(), lb.data(),
+                                  ub.data(), 0.3, 0.5, varianceNormals.data(), stepNormals.data(),
+                                  outOfBounds.data());
+        }
+
+        std::vector<double> x, variance, maxVariance, lb, ub, varianceNormals, stepNormals;
+        std::vector<std::uint8_t> outOfBounds;
+    };
+};
+
+TEST_F(MutationKernelTests, ExpIsAccurate) {
+    for (double x = -700; x < 700; x += 0.37) {
+        double expected = std::exp(x);
+        ASSERT_NEAR(1.0, kernelExp(x) / expected, 1e-14) << x;
+    }
+    ASSERT_EQ(1.0, kernelExp(0.0));
+}
+
+TEST_F(MutationKernelTests, ScalarKernelMatchesDefinition) {
+    Inputs inputs(37);
+    Inputs expected = inputs;
+    size_t count = inputs.run(SimdLevel::Scalar);
+
+    size_t expectedCount = 0;
+    for (size_t j = 0; j < 37; j++) {
+        double variance = std::min(expected.variance[j] * kernelExp(0.3 + 0.5 * expected.varianceNormals[j]),
+                                   expected.maxVariance[j]);
+        double trial = expected.x[j] + variance * expected.stepNormals[j];
+        bool out = trial < expected.lb[j] || trial > expected.ub[j];
+        expectedCount += out;
+        ASSERT_EQ(variance, inputs.variance[j]);
+        ASSERT_EQ(out, inputs.outOfBounds[j]);
+        ASSERT_EQ(out ? expected.x[j] : trial, inputs.x[j]);
+    }
+    ASSERT_EQ(expectedCount, count);
+    ASSERT_GT(count, 0);
+}
+
+TEST_F(MutationKernelTests, VectorKernelsMatchScalarKernel) {
+    // lengths that exercise both the vector body and the scalar tail
+    for (size_t n: {1, 3, 4, 7, 8, 10, 17, 100, 1001}) {
+        Inputs scalar(n);
+        size_t scalarCount = scalar.run(SimdLevel::Scalar);
+        for (SimdLevel level: {SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detectSimdLevel())
+                continue;
+            Inputs vector(n);
+            ASSERT_EQ(scalarCount, vector.run(level));
+            ASSERT_EQ(scalar.x, vector.x);
+            ASSERT_EQ(scalar.variance, vector.variance);
+            ASSERT_EQ(scalar.outOfBounds, vector.outOfBounds);
+        }
+    }
+}
+
+TEST_F(MutationKernelTests, PhiKernelMatchesDefinition) {
+    // two individuals of 3 parameters in [0, 1] and one constraint
+    std::vector<double> population = {0.5, -0.5, 3.0,
+                                      0.2, 0.4, 0.6};
+    std::vector<double> lb = {0, 0, 0};
+    std::vector<double> ub = {1, 1, 1};
+    std::vector<double> constraints = {-1.0, 2.0};
+    std::vector<double> phi(2);
+    phiKernel(SimdLevel::Scalar, 2, 3, population.data(), lb.data(), ub.data(),
+              constraints.data(), 1, phi.data());
+    ASSERT_DOUBLE_EQ(0.25 + 4.0, phi[0]);
+    ASSERT_DOUBLE_EQ(4.0, phi[1]);
+
+    phiKernel(SimdLevel::Scalar, 2, 3, population.data(), lb.data(), ub.data(), nullptr, 0, phi.data());
+    ASSERT_DOUBLE_EQ(4.25, phi[0]);
+    ASSERT_EQ(0.0, phi[1]);
+}
+
+TEST_F(MutationKernelTests, PhiVectorKernelsMatchScalarKernel) {
+    RandomNumberGenerator rng(4);
+    for (size_t n: {1, 3, 4, 7, 8, 10, 17, 100, 1001}) {
+        size_t numIndividuals = 13, numConstraints = 3;
+        std::vector<double> population(numIndividuals * n), lb(n), ub(n);
+        std::vector<double> constraints(numIndividuals * numConstraints);
+        for (size_t j = 0; j < n; j++) {
+            lb[j] = rng.uniformReal(-10, 0);
+            ub[j] = rng.uniformReal(0, 10);
+        }
+        rng.fillUniform(population.data(), population.size(), -15, 15);
+        rng.fillNormal(constraints.data(), constraints.size());
+
+        std::vector<double> scalar(numIndividuals);
+        phiKernel(SimdLevel::Scalar, numIndividuals, n, population.data(), lb.data(), ub.data(),
+                  constraints.data(), numConstraints, scalar.data());
+        for (SimdLevel level: {SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (level > detectSimdLevel())
+                continue;
+            std::vector<double> vector(numIndividuals);
+            phiKernel(level, numIndividuals, n, population.data(), lb.data(), ub.data(),
+                      constraints.data(), numConstraints, vector.data());
+            ASSERT_EQ(scalar, vector);
+        }
+    }
+}
@@ -21,17 +21,36 @@ TEST_F(OptItemsTests, TestConstructibleFromVectors) {
     );
 }
 
+TEST_F(OptItemsTests, TestContiguousArrays) {
+    OptItems items({0.4, 0.5, 0.6}, {0.1, 0.2, 0.3}, {10.0, 11.0, 12.0});
+    const OptItems &constItems = items;
+    ASSERT_EQ(std::vector<double>({0.1, 0.2, 0.3}), constItems.lb());
+    ASSERT_EQ(std::vector<double>({10.0, 11.0, 12.0}), constItems.ub());
+    ASSERT_EQ(std::vector<double>({0.4, 0.5, 0.6}), constItems.start());
+}
 
+TEST_F(OptItemsTests, TestContiguousArraysFollowChanges) {
+    OptItems items({0.4, 0.5}, {0.1, 0.2}, {10.0, 11.0});
+    ASSERT_EQ(0.2, items.lb()[1]);
+    items[1].setLb(-3.0);
+    items[0].setUb(5.0);
+    ASSERT_EQ(std::vector<double>({0.1, -3.0}), items.lb());
+    ASSERT_EQ(std::vector<double>({5.0, 11.0}), items.ub());
+}
 
+TEST_F(OptItemsTests, TestCheckConstraints) {
+    OptItems items({0.0, 0.0, 0.0, 0.0}, {-1.0, -1.0, -1.0, -1.0}, {1.0, 1.0, 1.0, 1.0});
+    double x[4] = {-2.0, -1.0, 1.0, 1.5};
+    std::int8_t out[4];
+    items.checkConstraints(x, out);
+    for (int i = 0; i < 4; i++)
+        ASSERT_EQ(items[i].checkConstraint(x[i]), out[i]);
+}
 
-
-
-
-
-
-
-
-
-
-
-
+TEST_F(OptItemsTests, TestViolation) {
+    OptItems items({0.0, 0.0, 0.0}, {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0});
+    double feasible[3] = {-1.0, 0.0, 1.0};
+    ASSERT_EQ(0.0, items.violation(feasible));
+    double infeasible[3] = {-3.0, 0.0, 1.5};
+    ASSERT_DOUBLE_EQ(4.0 + 0.25, items.violation(infeasible));
+}
@@ -0,0 +1,56 @@
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "PopulationMatrix.h"
+
+using namespace opt;
+
+class PopulationMatrixTests : public ::testing::Test {
+
+public:
+    DoubleMatrix nested = {{1, 2, 3},
+                           {4, 5, 6}};
+
+    PopulationMatrixTests() = default;
+
+};
+
+
+TEST_F(PopulationMatrixTests, TestRowMajorIsContiguous) {
+    PopulationMatrix m(nested);
+    ASSERT_EQ(2, m.rows());
+    ASSERT_EQ(3, m.cols());
+    std::vector<double> flat(m.data(), m.data() + 6);
+    ASSERT_EQ(std::vector<double>({1, 2, 3, 4, 5, 6}), flat);
+    ASSERT_TRUE(m[1].isContiguous());
+    ASSERT_EQ(m.data() + 3, m[1].data());
+}
+
+TEST_F(PopulationMatrixTests, TestColumnMajorRowView) {
+    PopulationMatrix m(nested, PopulationMatrix::ColumnMajor);
+    std::vector<double> flat(m.data(), m.data() + 6);
+    ASSERT_EQ(std::vector<double>({1, 4, 2, 5, 3, 6}), flat);
+    ASSERT_FALSE(m[1].isContiguous());
+    ASSERT_EQ(std::vector<double>({4, 5, 6}), m[1].toVector());
+    ASSERT_EQ(6, m(1, 2));
+}
+
+TEST_F(PopulationMatrixTests, TestRoundTripThroughDoubleMatrix) {
+    PopulationMatrix m(nested);
+    ASSERT_EQ(nested, m.toDoubleMatrix());
+}
+
+TEST_F(PopulationMatrixTests, TestRaggedInputThrows) {
+    DoubleMatrix ragged = {{1, 2}, {3}};
+    ASSERT_THROW(PopulationMatrix m(ragged), std::invalid_argument);
+}
+
+TEST_F(PopulationMatrixTests, TestBufferIsAligned) {
+    PopulationMatrix m(7, 5);
+    ASSERT_EQ(0, reinterpret_cast<std::uintptr_t>(m.data()) % 64);
+}
+
+TEST_F(PopulationMatrixTests, TestAssignRow) {
+    PopulationMatrix m(nested);
+    m[0].assign(m[1]);
+    ASSERT_EQ(std::vector<double>({4, 5, 6}), m[0].toVector());
+}
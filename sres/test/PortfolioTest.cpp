@@ -0,0 +1,129 @@
+#include "gtest/gtest.h"
+#include "Portfolio.h"
+#include <cmath>
+
+using namespace opt;
+
+/**
+ * minimum = f(3, 0.5) = 0
+ */
+double portfolioBeale(double *x) {
+    double first = pow(1.5 - x[0] + x[0] * x[1], 2);
+    double second = pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2);
+    double third = pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+    return first + second + third;
+}
+
+class PortfolioTests : public ::testing::Test {
+
+public:
+    PortfolioTests() = default;
+
+    static Portfolio makePortfolio(int numRuns) {
+        Portfolio portfolio(portfolioBeale, numRuns, 20, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0});
+        portfolio.setSeed(4);
+        portfolio.setStopAfterStalledGenerations(0);
+        return portfolio;
+    }
+};
+
+TEST_F(PortfolioTests, RunsAreSeededFromPortfolioSeed) {
+    Portfolio portfolio = makePortfolio(3);
+    portfolio.setRungInterval(0);
+    portfolio.fit();
+    const std::vector<PortfolioResult> &results = portfolio.getResults();
+    ASSERT_EQ(3, results.size());
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(RandomNumberGenerator::deriveSeed(4, i), results[i].seed);
+        ASSERT_FALSE(results[i].cancelled);
+        ASSERT_EQ(50, results[i].numGenerations);
+    }
+}
+
+TEST_F(PortfolioTests, RunMatchesStandaloneFit) {
+    Portfolio portfolio = makePortfolio(2);
+    portfolio.setRungInterval(0);
+    portfolio.setNumThreads(2);
+    portfolio.fit();
+
+    SRES sres(portfolioBeale, 20, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0});
+    sres.setSeed(RandomNumberGenerator::deriveSeed(4, 1));
+    sres.setStopAfterStalledGenerations(0);
+    sres.fit();
+    ASSERT_EQ(sres.getHallOfFame(), portfolio.getResults()[1].hallOfFame);
+    ASSERT_EQ(sres.getSolutionValues(), portfolio.getResults()[1].solutionValues);
+}
+
+TEST_F(PortfolioTests, RacingCancelsDominatedRuns) {
+    Portfolio portfolio = makePortfolio(8);
+    portfolio.setRungInterval(10);
+    portfolio.setReductionFactor(2.0);
+    portfolio.fit();
+
+    int numCancelled = 0;
+    int totalGenerations = 0;
+    for (const auto &result: portfolio.getResults()) {
+        numCancelled += result.cancelled;
+        totalGenerations += result.numGenerations;
+        if (result.cancelled) {
+            ASSERT_GT(result.bestFitness, portfolio.getBestFitnessValue());
+        }
+    }
+    ASSERT_EQ(7, numCancelled);
+    ASSERT_FALSE(portfolio.getResults()[portfolio.getBestRun()].cancelled);
+    // the generations of cancelled runs are given to the survivors
+    ASSERT_EQ(8 * 50, totalGenerations);
+    ASSERT_NEAR(0.0, portfolio.getBestFitnessValue(), 1e-4);
+    // budgets are restored for the next fit
+    ASSERT_EQ(50, portfolio.getRun(portfolio.getBestRun()).getNumGenerations());
+}
+
+TEST_F(PortfolioTests, RunsAreNotCancelledWithoutSignificantEvidence) {
+    // with 20 parents a side the smallest possible p-value is around 3e-8
+    Portfolio portfolio = makePortfolio(8);
+    portfolio.setRungInterval(10);
+    portfolio.setSignificance(1e-9);
+    portfolio.fit();
+    for (const auto &result: portfolio.getResults()) {
+        ASSERT_FALSE(result.cancelled);
+        ASSERT_EQ(50, result.numGenerations);
+    }
+}
+
+TEST_F(PortfolioTests, ResultDoesNotDependOnNumberOfThreads) {
+    Portfolio serial = makePortfolio(6);
+    serial.setNumThreads(1);
+    serial.fit();
+
+    Portfolio parallel = makePortfolio(6);
+    parallel.setNumThreads(4);
+    parallel.fit();
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ(serial.getResults()[i].hallOfFame, parallel.getResults()[i].hallOfFame);
+        ASSERT_EQ(serial.getResults()[i].cancelled, parallel.getResults()[i].cancelled);
+    }
+}
+
+TEST_F(PortfolioTests, MinRunsAreKept) {
+    Portfolio portfolio = makePortfolio(6);
+    portfolio.setRungInterval(5);
+    portfolio.setReductionFactor(4.0);
+    portfolio.setMinRuns(3);
+    portfolio.fit();
+    int numCancelled = 0;
+    for (const auto &result: portfolio.getResults())
+        numCancelled += result.cancelled;
+    ASSERT_EQ(3, numCancelled);
+}
+
+TEST_F(PortfolioTests, InvalidReductionFactorThrows) {
+    Portfolio portfolio = makePortfolio(2);
+    ASSERT_THROW(portfolio.setReductionFactor(1.0), std::invalid_argument);
+}
+
+TEST_F(PortfolioTests, InvalidSignificanceThrows) {
+    Portfolio portfolio = makePortfolio(2);
+    ASSERT_THROW(portfolio.setSignificance(0.0), std::invalid_argument);
+    ASSERT_THROW(portfolio.setSignificance(1.0), std::invalid_argument);
+}
@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "Profile.h"
+#include "SRES.h"
+#include <cmath>
+#include <vector>
+
+using namespace opt;
+
+double profiledCost(double *x) {
+    return pow(1.5 - x[0] + x[0] * x[1], 2) +
+           pow(2.25 - x[0] + x[0] * pow(x[1], 2), 2) +
+           pow(2.625 - x[0] + x[0] * pow(x[1], 3), 2);
+}
+
+class ProfileTests : public ::testing::Test {
+
+public:
+    ProfileTests() = default;
+};
+
+TEST_F(ProfileTests, BucketsHaveBoundedRelativeError) {
+    std::vector<std::uint64_t> values{0, 1, 15, 16, 17, 31, 32, 1000, 123456789, 1ull << 40, UINT64_MAX};
+    for (std::uint64_t value: values) {
+        size_t index = LatencyHistogram::bucketIndex(value);
+        ASSERT_LT(index, LatencyHistogram::NumBuckets);
+        std::uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+        ASSERT_GE(upper, value);
+        ASSERT_LE((double) (upper - value), value / 16.0) << value;
+        // the next bucket starts just above
+        if (index + 1 < LatencyHistogram::NumBuckets) {
+            ASSERT_EQ(index + 1, LatencyHistogram::bucketIndex(upper + 1));
+        }
+    }
+}
+
+TEST_F(ProfileTests, Percentiles) {
+    LatencyHistogram histogram;
+    ASSERT_EQ(0, histogram.getValueAtPercentile(50));
+    for (std::uint64_t i = 1; i <= 1000; i++)
+        histogram.record(i * 1000);
+
+    ASSERT_EQ(1000, histogram.getCount());
+    ASSERT_EQ(1000, histogram.getMin());
+    ASSERT_EQ(1000000, histogram.getMax());
+    ASSERT_DOUBLE_EQ(500500.0, histogram.getMean());
+    ASSERT_NEAR(500000, histogram.getValueAtPercentile(50), 500000 / 16.0);
+    ASSERT_NEAR(990000, histogram.getValueAtPercentile(99), 990000 / 16.0);
+    ASSERT_EQ(1000000, histogram.getValueAtPercentile(100));
+
+    histogram.reset();
+    ASSERT_EQ(0, histogram.getCount());
+    ASSERT_EQ(0, histogram.getMin());
+}
+
+TEST_F(ProfileTests, RecordSeveral) {
+    LatencyHistogram histogram;
+    histogram.record(100, 3);
+    histogram.record(200);
+    ASSERT_EQ(4, histogram.getCount());
+    ASSERT_DOUBLE_EQ(125.0, histogram.getMean());
+}
+
+TEST_F(ProfileTests, ProfileOfARun) {
+    SRES sres(profiledCost, 10, 50, {9.454, 3.556}, {0.1, 0.1}, {10.0, 10.0}, 7);
+    sres.setSeed(4);
+    sres.fit();
+    Profile profile = sres.getProfile();
+#ifdef SRES_PROFILING
+    ASSERT_EQ(1, profile.enabled);
+    ASSERT_EQ(sres.getNumEvaluations(), profile.numCostCalls);
+    ASSERT_GT(profile.replicateSeconds, 0);
+    ASSERT_GE(profile.replicateSeconds, profile.mutateSeconds);
+    ASSERT_GT(profile.mutateRngSeconds, 0);
+    ASSERT_GT(profile.mutateKernelSeconds, 0);
+    ASSERT_GT(profile.evaluateSeconds, 0);
+    ASSERT_GT(profile.selectSeconds, 0);
+    ASSERT_LE(profile.costCallMinSeconds, profile.costCallP50Seconds);
+    ASSERT_LE(profile.costCallP50Seconds, profile.costCallP99Seconds);
+    ASSERT_LE(profile.costCallP99Seconds, profile.costCallMaxSeconds);
+#else
+    ASSERT_EQ(0, profile.enabled);
+    ASSERT_EQ(0, profile.numCostCalls);
+    ASSERT_EQ(0, profile.evaluateSeconds);
+#endif
+}
@@ -0,0 +1,134 @@
+#include <thread>
+#include "gtest/gtest.h"
+#include "RandomNumberGenerator.h"
+
+using namespace opt;
+
+class RandomNumberGeneratorTests : public ::testing::Test {
+
+public:
+    RandomNumberGeneratorTests() = default;
+
+};
+
+
+/**
+ * Known answer test from the Random123 distribution (kat_vectors)
+ */
+TEST_F(RandomNumberGeneratorTests, TestPhiloxKnownAnswerZero) {
+    Philox4x32 philox(0, 0);
+    std::vector<std::uint32_t> expected({0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    std::vector<std::uint32_t> actual({philox(), philox(), philox(), philox()});
+    ASSERT_EQ(expected, actual);
+}
+
+TEST_F(RandomNumberGeneratorTests, TestSetPositionMatchesDiscard) {
+    Philox4x32 a(4, 7);
+    Philox4x32 b(4, 7);
+    for (int i = 0; i < 11; i++)
+        a();
+    b.discard(11);
+    ASSERT_EQ(a, b);
+    ASSERT_EQ(11, b.getPosition());
+    ASSERT_EQ(a(), b());
+}
+
+TEST_F(RandomNumberGeneratorTests, TestSameSeedSameNumbers) {
+    RandomNumberGenerator a(4);
+    RandomNumberGenerator b(4);
+    ASSERT_EQ(a.normal(0, 1, 100), b.normal(0, 1, 100));
+}
+
+TEST_F(RandomNumberGeneratorTests, TestSubstreamsAreReproducible) {
+    RandomNumberGenerator rng(4);
+    auto first = rng.substream(3, 12).uniformReal(0, 1, 50);
+    // drawing from the parent does not move its substreams
+    rng.uniformReal(0, 1, 50);
+    ASSERT_EQ(first, rng.substream(3, 12).uniformReal(0, 1, 50));
+}
+
+TEST_F(RandomNumberGeneratorTests, TestSubstreamsAreDistinct) {
+    RandomNumberGenerator rng(4);
+    auto a = rng.substream(3, 12).uniformReal(0, 1, 10);
+    ASSERT_NE(a, rng.substream(3, 13).uniformReal(0, 1, 10));
+    ASSERT_NE(a, rng.substream(4, 12).uniformReal(0, 1, 10));
+    ASSERT_NE(a, RandomNumberGenerator(5).substream(3, 12).uniformReal(0, 1, 10));
+}
+
+TEST_F(RandomNumberGeneratorTests, TestUniformIntIsInRange) {
+    RandomNumberGenerator rng(4);
+    std::vector<int> counts(5, 0);
+    for (int i = 0; i < 5000; i++) {
+        double r = rng.uniformInt(2, 6);
+        ASSERT_GE(r, 2);
+        ASSERT_LE(r, 6);
+        counts[int(r) - 2]++;
+    }
+    for (int c: counts)
+        ASSERT_GT(c, 800);
+}
+
+TEST_F(RandomNumberGeneratorTests, TestNormalMoments) {
+    RandomNumberGenerator rng(4);
+    auto r = rng.normal(2.0, 3.0, 100000);
+    double mean = 0, var = 0;
+    for (double x: r)
+        mean += x;
+    mean /= r.size();
+    for (double x: r)
+        var += (x - mean) * (x - mean);
+    var /= r.size() - 1;
+    ASSERT_NEAR(2.0, mean, 0.05);
+    ASSERT_NEAR(9.0, var, 0.15);
+}
+
+TEST_F(RandomNumberGeneratorTests, TestFillNormalMoments) {
+    RandomNumberGenerator rng(4);
+    std::vector<double> r(100001);
+    rng.fillNormal(r.data(), r.size(), 2.0, 3.0);
+    double mean = 0, var = 0;
+    for (double x: r)
+        mean += x;
+    mean /= r.size();
+    for (double x: r)
+        var += (x - mean) * (x - mean);
+    var /= r.size() - 1;
+    ASSERT_NEAR(2.0, mean, 0.05);
+    ASSERT_NEAR(9.0, var, 0.15);
+}
+
+TEST_F(RandomNumberGeneratorTests, TestFillNormalMatchesPerCallNormal) {
+    // both use the two variates of each Box-Muller pair in turn
+    RandomNumberGenerator bulk(4);
+    RandomNumberGenerator perCall(4);
+    std::vector<double> r(7);
+    bulk.fillNormal(r.data(), r.size());
+    for (double x: r)
+        ASSERT_DOUBLE_EQ(perCall.normal(0, 1), x);
+}
+
+TEST_F(RandomNumberGeneratorTests, TestFillUniformIsInRange) {
+    RandomNumberGenerator rng(4);
+    std::vector<double> r(10000);
+    rng.fillUniform(r.data(), r.size(), -2.0, 5.0);
+    for (double x: r) {
+        ASSERT_LE(-2.0, x);
+        ASSERT_GT(5.0, x);
+    }
+}
+
+TEST_F(RandomNumberGeneratorTests, TestSetStateContinuesTheSequence) {
+    RandomNumberGenerator rng(4);
+    rng.uniformReal(0, 1);
+    // leaves the second variate of a Box-Muller pair behind
+    rng.normal(0, 1);
+    RandomNumberGenerator::State state = rng.getState();
+
+    RandomNumberGenerator restored(11);
+    restored.setState(state);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(rng.normal(0, 1), restored.normal(0, 1));
+        ASSERT_EQ(rng.uniformReal(0, 1), restored.uniformReal(0, 1));
+    }
+    ASSERT_EQ(rng.getSeed(), restored.getSeed());
+}
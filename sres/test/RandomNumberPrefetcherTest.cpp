@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+#include "RandomNumberPrefetcher.h"
+#include "SRES.h"
+#include "TestProblems.h"
+#include <cstdio>
+#include <string>
+
+using namespace opt;
+
+class RandomNumberPrefetcherTests : public ::testing::Test {
+
+public:
+    RandomNumberPrefetcherTests() {
+        const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = ::testing::TempDir() + "sres_" + info->name() + ".checkpoint";
+    }
+
+    ~RandomNumberPrefetcherTests() override {
+        std::remove(path.c_str());
+        std::remove((path + ".tmp").c_str());
+    }
+
+    static GenerationShape makeShape() {
+        GenerationShape shape;
+        shape.populationSize = 5;
+        shape.childRate = 3;
+        shape.numParameters = 4;
+        shape.numSelectUniforms = 7;
+        return shape;
+    }
+
+    static void expectSameRun(SRES &expected, SRES &actual) {
+        ASSERT_EQ(expected.getCurrentGeneration(), actual.getCurrentGeneration());
+        ASSERT_EQ(expected.getBestFitnessValue(), actual.getBestFitnessValue());
+        ASSERT_EQ(expected.getSolutionValues(), actual.getSolutionValues());
+        ASSERT_EQ(expected.getHallOfFame(), actual.getHallOfFame());
+    }
+
+    std::string path;
+};
+
+TEST_F(RandomNumberPrefetcherTests, PrefetchedNumbersAreThoseOfTheStreams) {
+    RandomNumberGenerator rng(4);
+    GenerationShape shape = makeShape();
+    RandomNumberPrefetcher prefetcher;
+    prefetcher.prefetch(rng, 3, shape);
+    const GenerationRandomNumbers &numbers = prefetcher.acquire(rng, 3, shape);
+    ASSERT_EQ(3, numbers.generation);
+
+    RandomNumberGenerator replicateStream = rng.substream(3, RandomNumberGenerator::ReplicateStream);
+    size_t next = 0;
+    for (size_t i = 0; i < shape.populationSize; i++)
+        for (size_t j = 1; j < shape.childRate; j++)
+            ASSERT_EQ((size_t) replicateStream.uniformInt(0, (int) (i + shape.populationSize - 1)),
+                      numbers.parents[next++]);
+
+    // every draw after the block carries on from the stream
+    for (size_t child = shape.populationSize; child < shape.populationSize * shape.childRate; child++) {
+        RandomNumberGenerator childStream = rng.substream(3, child);
+        for (size_t j = 0; j < 2 * shape.numParameters + 1; j++)
+            ASSERT_EQ(childStream.normal(0, 1), numbers.normals[child][j]);
+        RandomNumberGenerator prefetchedStream = numbers.childStreams[child];
+        ASSERT_EQ(childStream.normal(0, 1), prefetchedStream.normal(0, 1));
+        ASSERT_EQ(childStream.normal(0, 1), prefetchedStream.normal(0, 1));
+    }
+
+    RandomNumberGenerator selectStream = rng.substream(3, RandomNumberGenerator::SelectStream);
+    for (double uniform: numbers.selectUniforms)
+        ASSERT_EQ(selectStream.uniformReal(0, 1), uniform);
+    RandomNumberGenerator prefetchedSelectStream = numbers.selectStream;
+    ASSERT_EQ(selectStream.uniformReal(0, 1), prefetchedSelectStream.uniformReal(0, 1));
+}
+
+TEST_F(RandomNumberPrefetcherTests, AcquireDrawsWhatWasNotPrefetched) {
+    RandomNumberGenerator rng(4);
+    RandomNumberGenerator otherSeed(5);
+    GenerationShape shape = makeShape();
+    RandomNumberPrefetcher prefetcher;
+    prefetcher.prefetch(rng, 2, shape);
+    ASSERT_EQ(nullptr, prefetcher.find(rng, 2, shape));
+
+    const GenerationRandomNumbers &other = prefetcher.acquire(otherSeed, 2, shape);
+    ASSERT_EQ(otherSeed.getSeed(), other.seed);
+    DoubleVector expected(2 * shape.numParameters + 1);
+    RandomNumberGenerator childStream = otherSeed.substream(2, shape.populationSize);
+    childStream.fillNormal(expected.data(), expected.size());
+    ASSERT_EQ(expected, other.normals[shape.populationSize].toVector());
+
+    // the prefetched generation is still there
+    ASSERT_EQ(2, prefetcher.acquire(rng, 2, shape).generation);
+    ASSERT_NE(nullptr, prefetcher.find(rng, 2, shape));
+    ASSERT_EQ(nullptr, prefetcher.find(otherSeed, 2, shape));
+}
+
+TEST_F(RandomNumberPrefetcherTests, PrefetchingDoesNotChangeTheResults) {
+    TestProblem problem = getTestProblem("rosenbrock", 5);
+    for (int numThreads: {1, 4}) {
+        SRES expected = problem.makeSRES(20, 60);
+        expected.setSeed(4);
+        expected.setStopAfterStalledGenerations(0);
+        expected.setNumThreads(numThreads);
+        expected.fit();
+
+        SRES prefetching = problem.makeSRES(20, 60);
+        prefetching.setSeed(4);
+        prefetching.setStopAfterStalledGenerations(0);
+        prefetching.setNumThreads(numThreads);
+        prefetching.setPrefetchRandomNumbers(true);
+        prefetching.fit();
+        expectSameRun(expected, prefetching);
+    }
+}
+
+TEST_F(RandomNumberPrefetcherTests, PrefetchingDoesNotChangeStochasticRanking) {
+    // with a population of 200 stochastic ranking needs more
+    // uniforms than are prefetched and draws the rest in place
+    TestProblem problem = getTestProblem("g06");
+    for (int populationSize: {20, 200}) {
+        SRES expected = problem.makeSRES(populationSize, 30);
+        expected.setSeed(4);
+        expected.setStopAfterStalledGenerations(0);
+        expected.fit();
+
+        SRES prefetching = problem.makeSRES(populationSize, 30);
+        prefetching.setSeed(4);
+        prefetching.setStopAfterStalledGenerations(0);
+        prefetching.setPrefetchRandomNumbers(true);
+        prefetching.fit();
+        expectSameRun(expected, prefetching);
+    }
+}
+
+TEST_F(RandomNumberPrefetcherTests, RestartsAndCheckpointsWithPrefetching) {
+    // a run with another seed first, whose prefetched
+    // numbers must not be used by the next one
+    TestProblem problem = getTestProblem("g24");
+    SRES expected = problem.makeSRES(20, 50);
+    expected.setSeed(4);
+    expected.setStopAfterStalledGenerations(0);
+    expected.step(10);
+    expected.setSeed(5);
+    expected.fit();
+
+    SRES interrupted = problem.makeSRES(20, 50);
+    interrupted.setSeed(4);
+    interrupted.setStopAfterStalledGenerations(0);
+    interrupted.setPrefetchRandomNumbers(true);
+    interrupted.step(10);
+    interrupted.setSeed(5);
+    interrupted.restart();
+    interrupted.step(10);
+    interrupted.saveCheckpoint(path);
+
+    SRES resumed = problem.makeSRES(20, 50);
+    resumed.setStopAfterStalledGenerations(0);
+    resumed.setPrefetchRandomNumbers(true);
+    resumed.loadCheckpoint(path);
+    resumed.resume();
+    expectSameRun(expected, resumed);
+}
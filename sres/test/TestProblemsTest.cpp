@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "RandomNumberGenerator.h"
+#include "TestProblems.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace opt;
+
+class TestProblemsTests : public ::testing::Test {
+
+public:
+    TestProblemsTests() = default;
+
+    /**
+     * @brief the largest constraint value of @param problem at @param x
+     */
+    static double maxConstraint(const TestProblem &problem, DoubleVector x) {
+        if (!problem.constraints)
+            return 0;
+        DoubleVector g(problem.numConstraints);
+        problem.constraints(x.data(), g.data());
+        return *std::max_element(g.begin(), g.end());
+    }
+};
+
+TEST_F(TestProblemsTests, TheLibraryHasEveryProblem) {
+    ASSERT_EQ(29, getTestProblems().size());
+    for (const char *name: {"rosenbrock", "rastrigin", "ackley", "griewank", "beale", "g01", "g13", "g24"})
+        ASSERT_EQ(name, getTestProblem(name).name);
+    ASSERT_EQ(13, getTestProblem("g01").numParameters);
+    ASSERT_EQ(38, getTestProblem("g16").numConstraints);
+    ASSERT_EQ(nullptr, getTestProblem("rastrigin").constraints);
+}
+
+TEST_F(TestProblemsTests, UnknownProblemsAndSizes) {
+    ASSERT_THROW(getTestProblem("g25"), std::invalid_argument);
+    ASSERT_THROW(getTestProblem("g01", 12), std::invalid_argument);
+    ASSERT_THROW(getTestProblem("rosenbrock", 7), std::invalid_argument);
+    ASSERT_EQ(30, getTestProblem("rosenbrock", 30).numParameters);
+    ASSERT_EQ(13, getTestProblem("g01", 13).numParameters);
+}
+
+TEST_F(TestProblemsTests, BestKnownSolutions) {
+    for (const TestProblem &problem: getTestProblems()) {
+        if (problem.bestKnownSolution.empty())
+            continue;
+        DoubleVector x = problem.bestKnownSolution;
+        ASSERT_EQ(problem.numParameters, x.size()) << problem.name;
+        double tolerance = 1e-6 * std::max(1.0, std::fabs(problem.bestKnownFitness));
+        ASSERT_NEAR(problem.bestKnownFitness, problem.cost(x.data()), tolerance) << problem.name;
+        // the solutions are given to about 15 digits, so the constraints
+        // they are on hold to about as many
+        ASSERT_LE(maxConstraint(problem, x), 1e-6) << problem.name;
+    }
+}
+
+TEST_F(TestProblemsTests, ScalableProblemsAtEverySize) {
+    for (const char *name: {"rosenbrock", "rastrigin", "ackley", "griewank"}) {
+        for (int n: {2, 5, 10, 20, 30}) {
+            TestProblem problem = getTestProblem(name, n);
+            ASSERT_NEAR(0.0, problem.cost(problem.bestKnownSolution.data()), 1e-12) << name << n;
+            ASSERT_GT(problem.cost(problem.startingValues.data()), 1.0) << name << n;
+        }
+    }
+}
+
+TEST_F(TestProblemsTests, BatchMatchesPerIndividual) {
+    RandomNumberGenerator rng(4);
+    // not a multiple of the batch lanes
+    const int numIndividuals = 11;
+    for (const TestProblem &problem: getTestProblems()) {
+        int n = problem.numParameters;
+        DoubleVector population(numIndividuals * n);
+        for (int i = 0; i < numIndividuals; i++)
+            for (int j = 0; j < n; j++)
+                population[i * n + j] = rng.uniformReal(problem.lb[j], problem.ub[j]);
+        DoubleVector fitness(numIndividuals);
+        problem.batchCost(population.data(), numIndividuals, n, fitness.data());
+        for (int i = 0; i < numIndividuals; i++) {
+            double expected = problem.cost(&population[i * n]);
+            if (std::isnan(expected))
+                ASSERT_TRUE(std::isnan(fitness[i])) << problem.name;
+            else
+                ASSERT_DOUBLE_EQ(expected, fitness[i]) << problem.name << " individual " << i;
+        }
+    }
+}
+
+TEST_F(TestProblemsTests, SRESSolvesG24) {
+    TestProblem problem = getTestProblem("g24");
+    SRES sres = problem.makeSRES(20, 500, 7);
+    sres.setSeed(4);
+    sres.setStopAfterStalledGenerations(0);
+    sres.fit();
+    ASSERT_NEAR(problem.bestKnownFitness, sres.getBestFitnessValue(), 1e-3);
+    ASSERT_LE(maxConstraint(problem, sres.getSolutionValues()), 1e-6);
+}
+
+TEST_F(TestProblemsTests, SRESSolvesRastriginWithTheBatchForm) {
+    TestProblem problem = getTestProblem("rastrigin", 2);
+    SRES sres = problem.makeSRES(20, 300, 7, true);
+    sres.setSeed(4);
+    sres.setStopAfterStalledGenerations(0);
+    sres.fit();
+    ASSERT_NEAR(0.0, sres.getBestFitnessValue(), 1e-6);
+}
@@ -0,0 +1,44 @@
+#include "gtest/gtest.h"
+#include "ThreadPool.h"
+#include <numeric>
+
+using namespace opt;
+
+class ThreadPoolTests : public ::testing::Test {
+
+public:
+    ThreadPoolTests() = default;
+
+};
+
+
+TEST_F(ThreadPoolTests, TestEveryIndexIsVisitedOnce) {
+    ThreadPool pool(4);
+    std::vector<int> visits(1000, 0);
+    pool.parallelFor(0, visits.size(), [&](size_t i) { visits[i]++; });
+    for (int v: visits)
+        ASSERT_EQ(1, v);
+}
+
+TEST_F(ThreadPoolTests, TestRangeIsRespected) {
+    ThreadPool pool(3);
+    std::vector<int> visits(10, 0);
+    pool.parallelFor(4, 8, [&](size_t i) { visits[i] = 1; });
+    std::vector<int> expected({0, 0, 0, 0, 1, 1, 1, 1, 0, 0});
+    ASSERT_EQ(expected, visits);
+}
+
+TEST_F(ThreadPoolTests, TestExceptionIsRethrownOnCaller) {
+    ThreadPool pool(4);
+    ASSERT_THROW(
+            pool.parallelFor(0, 100, [](size_t i) {
+                if (i == 42)
+                    throw std::runtime_error("failed");
+            }),
+            std::runtime_error
+    );
+    // pool is still usable afterwards
+    std::vector<int> visits(100, 0);
+    pool.parallelFor(0, visits.size(), [&](size_t i) { visits[i]++; });
+    ASSERT_EQ(100, std::accumulate(visits.begin(), visits.end(), 0));
+}
@@ -1,5 +1,7 @@
+import os
+import tempfile
 import unittest
-from sres import SRES
+from sres import SRES, Portfolio
 
 def beale(position):
     """
@@ -16,6 +18,19 @@ def cost_fun(parameters):
     return beale([parameters.contents[0], parameters.contents[1]])
 
 
+@SRES.batchCallback()
+def batch_cost_fun(population, numIndividuals, numParameters, fitness):
+    x, f = SRES.asArrays(population, numIndividuals, numParameters, fitness)
+    for i in range(numIndividuals):
+        f[i] = beale(x[i])
+
+
+@SRES.constraintCallback(2, 1)
+def constraint_fun(parameters, constraintValues):
+    # x - y <= 2 cuts off the optimum of beale
+    constraintValues.contents[0] = parameters.contents[0] - parameters.contents[1] - 2.0
+
+
 class SRESTests(unittest.TestCase):
 
     def setUp(self) -> None:
@@ -66,6 +81,93 @@ class SRESTests(unittest.TestCase):
         self.assertAlmostEqual(3, self.sres.getSolution()[0], places=2)
         self.assertAlmostEqual(0.5, self.sres.getSolution()[1], places=2)
 
+    def test_batch(self):
+        sres = SRES(
+            batch_cost_fun, popsize=4, numGenerations=25,
+            startingValues=[8.324, 7.335],
+            lb=[0.1, 0.1],
+            ub=[10, 10],
+            childrate=7,
+            batch=True
+        )
+        sres.setSeed(4)
+        results = sres.fit()
+        self.assertAlmostEqual(self.sres.fit()["bestFitness"], results["bestFitness"])
+
+    def test_constraint_function(self):
+        self.sres.setConstraintFunction(constraint_fun, 1)
+        results = self.sres.fit()
+        x, y = results["bestSolution"]
+        self.assertLessEqual(x - y, 2.0)
+
+    def test_fitness_cache(self):
+        self.sres.setFitnessCache(1000, quantum=0.01)
+        self.sres.fit()
+        stats = self.sres.getFitnessCacheStats()
+        self.assertGreater(stats["hits"] + stats["misses"], 0)
+
+    def test_evaluation_store(self):
+        path = os.path.join(tempfile.mkdtemp(), "beale.evaluations")
+        self.sres.setEvaluationStore(path)
+        self.sres.fit()
+        self.sres.setEvaluationStore("")
+        self.sres.setEvaluationStore(path)
+        self.sres.setSeed(4)
+        self.sres.fit()
+        self.assertGreater(self.sres.getEvaluationStoreStats()["hits"], 0)
+        self.sres.setEvaluationStore("")
+
+    def test_checkpoint(self):
+        path = os.path.join(tempfile.mkdtemp(), "beale.checkpoint")
+        self.sres.setCheckpointSchedule(path, 5)
+        results = self.sres.fit()
+        self.sres.setCheckpointSchedule("", 0)
+        self.sres.loadCheckpoint(path)
+        self.assertEqual(results["bestFitness"], self.sres.resume()["bestFitness"])
+
+    def test_generation_callback(self):
+        generations = []
+
+        @SRES.generationCallback()
+        def observer(info):
+            generations.append(info.contents.generation)
+            return info.contents.generation == 5
+
+        self.sres.setGenerationCallback(observer)
+        self.sres.fit()
+        self.assertEqual([1, 2, 3, 4, 5], generations)
+        self.assertGreater(self.sres.getNumEvaluations(), 0)
+
+    def test_profile(self):
+        self.sres.fit()
+        profile = self.sres.getProfile()
+        if profile["enabled"]:
+            self.assertGreater(profile["numCostCalls"], 0)
+        else:
+            self.assertEqual(0, profile["numCostCalls"])
+
+    def test_cancel(self):
+        self.sres.cancel()
+        self.sres.fit()
+        self.assertTrue(self.sres.isCancelled())
+        self.sres.resetCancellation()
+        self.assertFalse(self.sres.isCancelled())
+
+    def test_portfolio(self):
+        portfolio = Portfolio(
+            cost_fun, numRuns=4, popsize=4, numGenerations=25,
+            startingValues=[8.324, 7.335],
+            lb=[0.1, 0.1],
+            ub=[10, 10],
+            childrate=7
+        )
+        portfolio.setSeed(4)
+        portfolio.setCancellation(rungInterval=5, reductionFactor=2.0)
+        results = portfolio.fit()
+        self.assertEqual(4, len(results))
+        self.assertFalse(results[0]["cancelled"])
+        self.assertAlmostEqual(3, results[0]["bestSolution"][0], places=1)
+
 
 if __name__ == '__main__':
     unittest.main()